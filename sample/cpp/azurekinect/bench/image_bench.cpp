@@ -0,0 +1,106 @@
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include <benchmark/benchmark.h>
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+#include "k4a_util.hpp"
+
+/*
+ This is microbenchmark of conversion of k4a::image into cv::Mat for each format.
+
+ "get_mat" is generic converter (4-channels BGRA for color, deep copy),
+ and "get_bgr" is single-pass converter into recycled 3-channels BGR image that is input of inference.
+ It uses synthetic images (720P color, NFOV unbinned depth), so device is not required.
+
+ kinect_bench --benchmark_filter=get_ --benchmark_format=json --benchmark_out=kinect_bench.json
+*/
+
+namespace
+{
+    constexpr int32_t width = 1280;
+    constexpr int32_t height = 720;
+    constexpr int32_t depth_width = 640;
+    constexpr int32_t depth_height = 576;
+
+    // Synthetic Image
+    cv::Mat create_pattern( const int32_t rows, const int32_t cols, const int32_t type )
+    {
+        cv::Mat pattern( rows, cols, type );
+        cv::randu( pattern, cv::Scalar::all( 0 ), cv::Scalar::all( 255 ) );
+        return pattern;
+    }
+
+    // Copy Pattern into New k4a::image
+    k4a::image create_image( const k4a_image_format_t format, const int32_t width, const int32_t height, const int32_t stride, const cv::Mat& pattern )
+    {
+        k4a::image image = k4a::image::create( format, width, height, stride );
+        std::memcpy( image.get_buffer(), pattern.data, image.get_size() );
+        return image;
+    }
+
+    // Synthetic k4a::image of Format
+    k4a::image create_image( const k4a_image_format_t format )
+    {
+        switch( format ){
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG:
+            {
+                // Compressed Buffer is Owned by Image
+                std::vector<uint8_t> jpeg;
+                cv::imencode( ".jpg", create_pattern( height, width, CV_8UC3 ), jpeg );
+                std::vector<uint8_t>* buffer = new std::vector<uint8_t>( std::move( jpeg ) );
+                return k4a::image::create_from_buffer( format, width, height, 0, buffer->data(), buffer->size(), []( void*, void* context ){ delete static_cast<std::vector<uint8_t>*>( context ); }, buffer );
+            }
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_NV12:
+                return create_image( format, width, height, width, create_pattern( height + height / 2, width, CV_8UC1 ) );
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_YUY2:
+                return create_image( format, width, height, width * 2, create_pattern( height, width, CV_8UC2 ) );
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+                return create_image( format, width, height, width * 4, create_pattern( height, width, CV_8UC4 ) );
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16:
+                return create_image( format, depth_width, depth_height, depth_width * 2, create_pattern( depth_height, depth_width, CV_16UC1 ) );
+            default:
+                throw k4a::error( "Failed to create this format!" );
+        }
+    }
+
+    // Set Processed Pixels
+    void set_pixels( benchmark::State& state, const k4a::image& image )
+    {
+        state.SetItemsProcessed( state.iterations() * image.get_width_pixels() * image.get_height_pixels() );
+    }
+}
+
+// Generic Converter
+void get_mat( benchmark::State& state, const k4a_image_format_t format )
+{
+    k4a::image image = create_image( format );
+    for( auto _ : state ){
+        const cv::Mat mat = k4a::get_mat( image );
+        benchmark::DoNotOptimize( mat.data );
+    }
+    set_pixels( state, image );
+}
+BENCHMARK_CAPTURE( get_mat, mjpg, K4A_IMAGE_FORMAT_COLOR_MJPG )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( get_mat, nv12, K4A_IMAGE_FORMAT_COLOR_NV12 )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( get_mat, yuy2, K4A_IMAGE_FORMAT_COLOR_YUY2 )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( get_mat, bgra32, K4A_IMAGE_FORMAT_COLOR_BGRA32 )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( get_mat, depth16, K4A_IMAGE_FORMAT_DEPTH16 )->Unit( benchmark::kMicrosecond );
+
+// Single-Pass Converter into Recycled BGR Image
+void get_bgr( benchmark::State& state, const k4a_image_format_t format )
+{
+    k4a::image image = create_image( format );
+    cv::Mat bgr;
+    for( auto _ : state ){
+        k4a::get_bgr( image, bgr );
+        benchmark::DoNotOptimize( bgr.data );
+    }
+    set_pixels( state, image );
+}
+BENCHMARK_CAPTURE( get_bgr, mjpg, K4A_IMAGE_FORMAT_COLOR_MJPG )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( get_bgr, nv12, K4A_IMAGE_FORMAT_COLOR_NV12 )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( get_bgr, yuy2, K4A_IMAGE_FORMAT_COLOR_YUY2 )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( get_bgr, bgra32, K4A_IMAGE_FORMAT_COLOR_BGRA32 )->Unit( benchmark::kMicrosecond );
@@ -0,0 +1,148 @@
+#include <random>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+#include "k4a_util.hpp"
+#include "skeleton.hpp"
+
+/*
+ This is microbenchmark of depth transformation for 3D positions of keypoints.
+
+ "dense" transforms full depth image to color camera and samples it at keypoints,
+ "sparse" maps only keypoints to depth camera and samples depth image around them.
+ It uses synthetic calibration (720P color, NFOV unbinned depth) and synthetic depth, so device is not required.
+
+ kinect_bench --benchmark_filter=sparse
+*/
+
+namespace
+{
+    constexpr int32_t persons = 2;
+    constexpr int32_t keypoints_per_person = 18;
+    constexpr int32_t window = 3;
+
+    // Set Pinhole Camera with Small Distortion
+    void set_camera( k4a_calibration_camera_t& camera, const int32_t width, const int32_t height, const float focal, const float metric_radius )
+    {
+        camera.resolution_width = width;
+        camera.resolution_height = height;
+        camera.metric_radius = metric_radius;
+        camera.intrinsics.type = K4A_CALIBRATION_LENS_DISTORTION_MODEL_BROWN_CONRADY;
+        camera.intrinsics.parameter_count = 14;
+        camera.intrinsics.parameters.param = {};
+        camera.intrinsics.parameters.param.cx = width * 0.5f;
+        camera.intrinsics.parameters.param.cy = height * 0.5f;
+        camera.intrinsics.parameters.param.fx = focal;
+        camera.intrinsics.parameters.param.fy = focal;
+        camera.intrinsics.parameters.param.k1 = 0.05f;
+        camera.intrinsics.parameters.param.k2 = -0.01f;
+        camera.intrinsics.parameters.param.metric_radius = metric_radius;
+    }
+
+    // Set Translation Only Extrinsics [mm]
+    void set_extrinsics( k4a_calibration_extrinsics_t& extrinsics, const float x, const float y, const float z )
+    {
+        extrinsics = {};
+        extrinsics.rotation[0] = extrinsics.rotation[4] = extrinsics.rotation[8] = 1.0f;
+        extrinsics.translation[0] = x;
+        extrinsics.translation[1] = y;
+        extrinsics.translation[2] = z;
+    }
+
+    // Synthetic Calibration
+    k4a::calibration create_calibration()
+    {
+        k4a::calibration calibration;
+        calibration.depth_mode = K4A_DEPTH_MODE_NFOV_UNBINNED;
+        calibration.color_resolution = K4A_COLOR_RESOLUTION_720P;
+        set_camera( calibration.depth_camera_calibration, 640, 576, 504.0f, 1.74f );
+        set_camera( calibration.color_camera_calibration, 1280, 720, 605.0f, 1.7f );
+
+        for( int32_t i = 0; i < K4A_CALIBRATION_TYPE_NUM; i++ ){
+            for( int32_t j = 0; j < K4A_CALIBRATION_TYPE_NUM; j++ ){
+                set_extrinsics( calibration.extrinsics[i][j], 0.0f, 0.0f, 0.0f );
+            }
+        }
+        set_extrinsics( calibration.extrinsics[K4A_CALIBRATION_TYPE_DEPTH][K4A_CALIBRATION_TYPE_COLOR], -32.0f, -2.0f, 4.0f );
+        set_extrinsics( calibration.extrinsics[K4A_CALIBRATION_TYPE_COLOR][K4A_CALIBRATION_TYPE_DEPTH], 32.0f, 2.0f, -4.0f );
+        calibration.depth_camera_calibration.extrinsics = calibration.extrinsics[K4A_CALIBRATION_TYPE_DEPTH][K4A_CALIBRATION_TYPE_DEPTH];
+        calibration.color_camera_calibration.extrinsics = calibration.extrinsics[K4A_CALIBRATION_TYPE_DEPTH][K4A_CALIBRATION_TYPE_COLOR];
+
+        return calibration;
+    }
+
+    // Synthetic Depth Image (Slanted Plane around 2m)
+    k4a::image create_depth( const k4a::calibration& calibration )
+    {
+        const int32_t width = calibration.depth_camera_calibration.resolution_width;
+        const int32_t height = calibration.depth_camera_calibration.resolution_height;
+        k4a::image depth_image = k4a::image::create( K4A_IMAGE_FORMAT_DEPTH16, width, height, width * static_cast<int32_t>( sizeof( uint16_t ) ) );
+        for( int32_t y = 0; y < height; y++ ){
+            uint16_t* row = reinterpret_cast<uint16_t*>( depth_image.get_buffer() + y * depth_image.get_stride_bytes() );
+            for( int32_t x = 0; x < width; x++ ){
+                row[x] = static_cast<uint16_t>( 1800 + x / 2 );
+            }
+        }
+        return depth_image;
+    }
+
+    // Synthetic Keypoints
+    skeleton2d create_keypoints()
+    {
+        std::mt19937 random( 0 );
+        std::uniform_real_distribution<float> x( 320.0f, 960.0f );
+        std::uniform_real_distribution<float> y( 120.0f, 600.0f );
+
+        skeleton2d keypoints;
+        keypoints.offsets.push_back( 0 );
+        for( int32_t i = 0; i < persons; i++ ){
+            keypoints.ids.push_back( i );
+            for( int32_t j = 0; j < keypoints_per_person; j++ ){
+                keypoints.x.push_back( x( random ) );
+                keypoints.y.push_back( y( random ) );
+                keypoints.confidences.push_back( 1.0f );
+            }
+            keypoints.offsets.push_back( static_cast<int32_t>( keypoints.x.size() ) );
+        }
+        return keypoints;
+    }
+}
+
+// Dense (Full Depth Image to Color Camera, then Sample at Keypoints)
+void dense( benchmark::State& state )
+{
+    const k4a::calibration calibration = create_calibration();
+    const k4a::transformation transformation( calibration );
+    const cv::Mat color_rays = k4a::create_color_rays( calibration );
+    const k4a::image depth_image = create_depth( calibration );
+    const skeleton2d keypoints = create_keypoints();
+
+    skeleton3d skeleton;
+    for( auto _ : state ){
+        k4a::image transformed_depth_image = transformation.depth_image_to_color_camera( depth_image );
+        k4a::deproject_dense( color_rays, transformed_depth_image, keypoints, window, skeleton );
+        benchmark::DoNotOptimize( skeleton.z.data() );
+    }
+    state.SetItemsProcessed( state.iterations() * keypoints.size() );
+}
+BENCHMARK( dense )->Unit( benchmark::kMicrosecond );
+
+// Sparse (Map Keypoints to Depth Camera, then Sample around Them)
+void sparse( benchmark::State& state )
+{
+    const k4a::calibration calibration = create_calibration();
+    k4a::image depth_image = create_depth( calibration );
+    const skeleton2d keypoints = create_keypoints();
+
+    skeleton2d depth_keypoints;
+    skeleton3d skeleton;
+    for( auto _ : state ){
+        k4a::deproject_sparse( calibration, depth_image, keypoints, window, depth_keypoints, skeleton );
+        benchmark::DoNotOptimize( skeleton.z.data() );
+    }
+    state.SetItemsProcessed( state.iterations() * keypoints.size() );
+}
+BENCHMARK( sparse )->Unit( benchmark::kMicrosecond );
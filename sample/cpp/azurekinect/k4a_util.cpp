@@ -0,0 +1,206 @@
+#include "k4a_util.hpp"
+#include "convert.hpp"
+
+#include <vector>
+#include <limits>
+
+cv::Mat k4a::get_mat( k4a::image& src, bool deep_copy )
+{
+    assert( src.get_size() != 0 );
+
+    cv::Mat mat;
+    const int32_t width = src.get_width_pixels();
+    const int32_t height = src.get_height_pixels();
+
+    const k4a_image_format_t format = src.get_format();
+    switch( format )
+    {
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG:
+        {
+            // NOTE: this is slower than other formats.
+            std::vector<uint8_t> buffer( src.get_buffer(), src.get_buffer() + src.get_size() );
+            mat = cv::imdecode( buffer, cv::IMREAD_ANYCOLOR );
+            cv::cvtColor( mat, mat, cv::COLOR_BGR2BGRA );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_NV12:
+        {
+            cv::Mat nv12 = cv::Mat( height + height / 2, width, CV_8UC1, src.get_buffer() ).clone();
+            cv::cvtColor( nv12, mat, cv::COLOR_YUV2BGRA_NV12 );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_YUY2:
+        {
+            cv::Mat yuy2 = cv::Mat( height, width, CV_8UC2, src.get_buffer() ).clone();
+            cv::cvtColor( yuy2, mat, cv::COLOR_YUV2BGRA_YUY2 );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+        {
+            mat = deep_copy ? cv::Mat( height, width, CV_8UC4, src.get_buffer() ).clone()
+                            : cv::Mat( height, width, CV_8UC4, src.get_buffer() );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16:
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_IR16:
+        {
+            mat = deep_copy ? cv::Mat( height, width, CV_16UC1, reinterpret_cast<uint16_t*>( src.get_buffer() ) ).clone()
+                            : cv::Mat( height, width, CV_16UC1, reinterpret_cast<uint16_t*>( src.get_buffer() ) );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_CUSTOM8:
+        {
+            mat = cv::Mat( height, width, CV_8UC1, src.get_buffer() ).clone();
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_CUSTOM:
+        {
+            // NOTE: This is opencv_viz module format (cv::viz::WCloud).
+            const int16_t* buffer = reinterpret_cast<int16_t*>( src.get_buffer() );
+            mat = cv::Mat( height, width, CV_32FC3, cv::Vec3f::all( std::numeric_limits<float>::quiet_NaN() ) );
+            mat.forEach<cv::Vec3f>(
+                [&]( cv::Vec3f& point, const int32_t* position ){
+                    const int32_t index = ( position[0] * width + position[1] ) * 3;
+                    point = cv::Vec3f( buffer[index + 0], buffer[index + 1], buffer[index + 2] );
+                }
+            );
+            break;
+        }
+        default:
+            throw k4a::error( "Failed to convert this format!" );
+            break;
+    }
+
+    return mat;
+}
+
+void k4a::get_bgr( k4a::image& src, cv::Mat& dst )
+{
+    assert( src.get_size() != 0 );
+
+    const int32_t width = src.get_width_pixels();
+    const int32_t height = src.get_height_pixels();
+    const size_t stride = static_cast<size_t>( src.get_stride_bytes() );
+    dst.create( height, width, CV_8UC3 );
+
+    const k4a_image_format_t format = src.get_format();
+    switch( format )
+    {
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG:
+        {
+            // Decode into Destination without Copy of Compressed Buffer
+            const cv::Mat buffer = cv::Mat( 1, static_cast<int32_t>( src.get_size() ), CV_8UC1, src.get_buffer() );
+            cv::imdecode( buffer, cv::IMREAD_COLOR, &dst );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_NV12:
+        {
+            // UV Plane Follows Y Plane
+            const uint8_t* y = src.get_buffer();
+            const uint8_t* uv = y + stride * height;
+            convert_nv12_to_bgr( y, stride, uv, stride, dst.data, dst.step, width, height );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_YUY2:
+        {
+            convert_yuy2_to_bgr( src.get_buffer(), stride, dst.data, dst.step, width, height );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+        {
+            convert_bgra_to_bgr( src.get_buffer(), stride, dst.data, dst.step, width, height );
+            break;
+        }
+        default:
+            throw k4a::error( "Failed to convert this format!" );
+            break;
+    }
+}
+
+cv::Mat k4a::create_color_rays( const k4a::calibration& calibration )
+{
+    // Undistortion is Applied Once Here
+    const k4a_calibration_camera_t& color_calibration = calibration.color_camera_calibration;
+    cv::Mat color_rays( color_calibration.resolution_height, color_calibration.resolution_width, CV_32FC2 );
+    for( int32_t y = 0; y < color_rays.rows; y++ ){
+        cv::Vec2f* row = color_rays.ptr<cv::Vec2f>( y );
+        for( int32_t x = 0; x < color_rays.cols; x++ ){
+            k4a_float3_t ray;
+            const k4a_float2_t point_2d = { static_cast<float>( x ), static_cast<float>( y ) };
+            if( calibration.convert_2d_to_3d( point_2d, 1.0f, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_COLOR, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_COLOR, &ray ) ){
+                row[x] = cv::Vec2f( ray.xyz.x, ray.xyz.y );
+            }
+            else{
+                row[x] = cv::Vec2f( std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN() );
+            }
+        }
+    }
+
+    return color_rays;
+}
+
+void k4a::deproject_dense( const cv::Mat& color_rays, k4a::image& transformed_depth_image, const skeleton2d& keypoints, const int32_t window, skeleton3d& skeleton )
+{
+    // Wrap Transformed Depth Image with Row Stride
+    const cv::Mat transformed_depth( transformed_depth_image.get_height_pixels(), transformed_depth_image.get_width_pixels(), CV_16UC1, transformed_depth_image.get_buffer(), transformed_depth_image.get_stride_bytes() );
+
+    // Deproject All Keypoints with Color Intrinsics
+    constexpr float scale = 0.001f; // [mm] -> [m]
+    skeleton.reset( keypoints );
+    lookup_rays( color_rays, keypoints, skeleton );
+    sample_depth( transformed_depth, scale, keypoints, window, skeleton );
+    deproject_skeleton( skeleton );
+}
+
+void k4a::deproject_sparse( const k4a::calibration& calibration, k4a::image& depth_image, const skeleton2d& keypoints, const int32_t window, skeleton2d& depth_keypoints, skeleton3d& skeleton )
+{
+    // Map Keypoints from Color Camera to Depth Camera
+    // (Keypoints out of color image are mapped out of depth image, so these are skipped by bounds check)
+    const int32_t width = calibration.color_camera_calibration.resolution_width;
+    const int32_t height = calibration.color_camera_calibration.resolution_height;
+    const size_t size = keypoints.size();
+    depth_keypoints.x.resize( size );
+    depth_keypoints.y.resize( size );
+    for( size_t i = 0; i < size; i++ ){
+        depth_keypoints.x[i] = -1.0f;
+        depth_keypoints.y[i] = -1.0f;
+        if( keypoints.x[i] < 0.0f || width <= keypoints.x[i] || keypoints.y[i] < 0.0f || height <= keypoints.y[i] ){
+            continue;
+        }
+
+        k4a_float2_t point_2d;
+        const k4a_float2_t color_point_2d = { keypoints.x[i], keypoints.y[i] };
+        if( calibration.convert_color_2d_to_depth_2d( color_point_2d, depth_image, &point_2d ) ){
+            depth_keypoints.x[i] = point_2d.xy.x;
+            depth_keypoints.y[i] = point_2d.xy.y;
+        }
+    }
+
+    // Sample Depth around Mapped Keypoints
+    const cv::Mat depth( depth_image.get_height_pixels(), depth_image.get_width_pixels(), CV_16UC1, depth_image.get_buffer(), depth_image.get_stride_bytes() );
+    skeleton.reset( keypoints );
+    sample_depth( depth, 1.0f, depth_keypoints, window, skeleton );
+
+    // Deproject in Depth Camera, and Transform into Color Camera
+    constexpr float scale = 0.001f; // [mm] -> [m]
+    for( size_t i = 0; i < size; i++ ){
+        k4a_float3_t position;
+        const k4a_float2_t point_2d = { depth_keypoints.x[i], depth_keypoints.y[i] };
+        if( skeleton.z[i] <= 0.0f || !calibration.convert_2d_to_3d( point_2d, skeleton.z[i], k4a_calibration_type_t::K4A_CALIBRATION_TYPE_DEPTH, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_COLOR, &position ) ){
+            skeleton.valid[i] = 0;
+            continue;
+        }
+
+        skeleton.x[i] = position.xyz.x * scale;
+        skeleton.y[i] = position.xyz.y * scale;
+        skeleton.z[i] = position.xyz.z * scale;
+        skeleton.valid[i] = 1;
+    }
+}
+
+cv::Mat k4a_get_mat( k4a_image_t& src, bool deep_copy )
+{
+    k4a_image_reference( src );
+    k4a::image img = k4a::image( src );
+    return k4a::get_mat( img, deep_copy );
+}
\ No newline at end of file
@@ -1,29 +1,12 @@
-#ifndef __UTIL__
-#define __UTIL__
-
-#include <stdexcept>
-#include <sstream>
-#include <string>
-#include <memory>
-
-#include <cubemos/skeleton_tracking.h>
-
-#define MULTIPLE 16
-
-#define CHECK_SUCCESS( ret )                                                \
-    if( ret != CM_ReturnCode::CM_SUCCESS ){                                 \
-        std::stringstream ss;                                               \
-        ss << "failed to " #ret " " << std::hex << ret << "!" << std::endl; \
-        throw std::runtime_error( ss.str().c_str() );                       \
-    }
-
-using CUBEMOS_SKEL_Buffer_Ptr = std::unique_ptr<CM_SKEL_Buffer, void (*)( CM_SKEL_Buffer* )>;
-CUBEMOS_SKEL_Buffer_Ptr create_skel_buffer();
+#ifndef __K4A_UTIL__
+#define __K4A_UTIL__
 
 /*
  This is utility to that provides converter to convert k4a::image to cv::Mat.
 
  cv::Mat mat = k4a::get_mat( image );
+ k4a::get_bgr( image, bgr ); // single-pass conversion into preallocated 3-channels BGR image
+ k4a::deproject_sparse( calibration, depth_image, keypoints, 3, depth_keypoints, skeleton ); // 3D positions of keypoints
 
  Copyright (c) 2019 Tsukasa Sugiura <t.sugiura0204@gmail.com>
  Licensed under the MIT license.
@@ -51,10 +34,25 @@ CUBEMOS_SKEL_Buffer_Ptr create_skel_buffer();
 #include <k4a/k4a.hpp>
 #include <opencv2/opencv.hpp>
 
+#include "skeleton.hpp"
+
 namespace k4a{
     cv::Mat get_mat( k4a::image& src, bool deep_copy = true );
+
+    // Convert Color Image (MJPG, NV12, YUY2, BGRA32) into 3-channels BGR Image in Single Pass
+    void get_bgr( k4a::image& src, cv::Mat& dst );
+
+    // Create Ray Table (Normalized Coordinate at z = 1) of Each Color Pixel (CV_32FC2)
+    cv::Mat create_color_rays( const k4a::calibration& calibration );
+
+    // Deproject Keypoints with Depth Image that is Transformed to Color Camera (Dense)
+    void deproject_dense( const cv::Mat& color_rays, k4a::image& transformed_depth_image, const skeleton2d& keypoints, const int32_t window, skeleton3d& skeleton );
+
+    // Deproject Keypoints with Depth Image by Mapping Only Keypoints to Depth Camera (Sparse)
+    // (depth_keypoints is buffer for keypoints in depth image)
+    void deproject_sparse( const k4a::calibration& calibration, k4a::image& depth_image, const skeleton2d& keypoints, const int32_t window, skeleton2d& depth_keypoints, skeleton3d& skeleton );
 }
 
 cv::Mat k4a_get_mat( k4a_image_t& src, bool deep_copy = true );
 
-#endif // __UTIL__
\ No newline at end of file
+#endif // __K4A_UTIL__
\ No newline at end of file
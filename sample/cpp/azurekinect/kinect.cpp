@@ -1,19 +1,30 @@
 #include "kinect.hpp"
+#include "profiler.hpp"
 
-#include <array>
 #include <chrono>
-#include <vector>
-#include <string>
-#include <filesystem>
-namespace filesystem = std::filesystem;
+#include <stdexcept>
 
 // Constructor
-kinect::kinect( const uint32_t index )
+kinect::kinect( const uint32_t index, const int32_t depth_window, const transformation_mode mode, const sync_configuration& sync )
     : device_index( index ),
-      handle( nullptr ),
-      request_handle( nullptr ),
-      buffer( create_skel_buffer() ),
-      previous_buffer( create_skel_buffer() )
+      sync( sync ),
+      timestamp_offset( 0 ),
+      replay_pacer( false ),
+      mode( mode ),
+      depth_window( depth_window )
+{
+    // Initialize
+    initialize();
+}
+
+// Constructor
+kinect::kinect( const std::string& file, const int32_t depth_window, const transformation_mode mode, const bool realtime )
+    : device_index( 0 ),
+      timestamp_offset( 0 ),
+      file( file ),
+      replay_pacer( realtime ),
+      mode( mode ),
+      depth_window( depth_window )
 {
     // Initialize
     initialize();
@@ -28,11 +39,18 @@ kinect::~kinect()
 // Initialize
 void kinect::initialize()
 {
-    // Initialize Sensor
-    initialize_sensor();
+    // Initialize Sensor (or Playback)
+    if( file.empty() ){
+        initialize_sensor();
+    }
+    else{
+        initialize_playback();
+    }
 
-    // Initialize Skeleton
-    initialize_skeleton();
+    // Initialize Rays
+    if( mode == transformation_mode::dense ){
+        initialize_rays();
+    }
 }
 
 // Initialize Sensor
@@ -47,13 +65,23 @@ inline void kinect::initialize_sensor()
     // Open Default Device
     device = k4a::device::open( device_index );
 
+    // Check Sync Cables (Master Drives Sync Out, Subordinate Listens Sync In)
+    if( sync.mode == k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_MASTER && !device.is_sync_out_connected() ){
+        throw k4a::error( "Failed to found sync out cable of master device!" );
+    }
+    if( sync.mode == k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_SUBORDINATE && !device.is_sync_in_connected() ){
+        throw k4a::error( "Failed to found sync in cable of subordinate device!" );
+    }
+
     // Start Cameras with Configuration
     device_configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
-    device_configuration.color_format             = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32;
-    device_configuration.color_resolution         = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P;
-    device_configuration.depth_mode               = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
-    device_configuration.synchronized_images_only = true;
-    device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
+    device_configuration.color_format                      = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32;
+    device_configuration.color_resolution                  = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P;
+    device_configuration.depth_mode                        = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
+    device_configuration.synchronized_images_only          = true;
+    device_configuration.wired_sync_mode                   = sync.mode;
+    device_configuration.depth_delay_off_color_usec        = sync.depth_delay_usec;
+    device_configuration.subordinate_delay_off_master_usec = ( sync.mode == k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_SUBORDINATE ) ? sync.subordinate_delay_usec : 0;
     device.start_cameras( &device_configuration );
 
     // Get Calibration
@@ -63,110 +91,176 @@ inline void kinect::initialize_sensor()
     transformation = k4a::transformation( calibration );
 }
 
-// Initialize Skeleton
-inline void kinect::initialize_skeleton()
+// Initialize Playback
+inline void kinect::initialize_playback()
+{
+    // Open Recorded File
+    playback = k4a::playback::open( file.c_str() );
+
+    // Get Configuration and Calibration of Recording
+    const k4a_record_configuration_t record_configuration = playback.get_record_configuration();
+    if( !record_configuration.color_track_enabled ){
+        throw k4a::error( "Failed to found color track in " + file + "!" );
+    }
+
+    device_configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    device_configuration.color_format                      = record_configuration.color_format;
+    device_configuration.color_resolution                  = record_configuration.color_resolution;
+    device_configuration.depth_mode                        = record_configuration.depth_mode;
+    device_configuration.camera_fps                        = record_configuration.camera_fps;
+    device_configuration.wired_sync_mode                   = record_configuration.wired_sync_mode;
+    device_configuration.depth_delay_off_color_usec        = record_configuration.depth_delay_off_color_usec;
+    device_configuration.subordinate_delay_off_master_usec = record_configuration.subordinate_delay_off_master_usec;
+    timestamp_offset = std::chrono::microseconds( record_configuration.start_timestamp_offset_usec );
+    calibration = playback.get_calibration();
+
+    // Create Transformation
+    transformation = k4a::transformation( calibration );
+}
+
+// Initialize Rays
+inline void kinect::initialize_rays()
 {
-    // Create Handle
-    const filesystem::path license_directory( std::string( std::getenv( "LOCALAPPDATA" ) ) + "/Cubemos/SkeletonTracking/license" );
-    CHECK_SUCCESS( cm_skel_create_handle( &handle, license_directory.generic_string().c_str() ) );
-
-    // Load Model
-    const CM_TargetComputeDevice target_device = CM_TargetComputeDevice::CM_CPU;
-    const filesystem::path model_directory( std::string( std::getenv( "LOCALAPPDATA" ) ) + "/Cubemos/SkeletonTracking/models" );
-    const filesystem::path model( model_directory.generic_string() + "/fp32/skeleton-tracking.cubemos" ); // FP32 model
-    //const filesystem::path model( model_directory.generic_string() + "/fp16/skeleton-tracking.cubemos" ); // FP16 model
-    CHECK_SUCCESS( cm_skel_load_model( handle, target_device, model.generic_string().c_str() ) );
-
-    // Create Async Request Handle
-    CHECK_SUCCESS( cm_skel_create_async_request_handle( handle, &request_handle ) );
-
-    // Create Color Table
-    colors.push_back( cv::Scalar( 255, 0, 0 ) );
-    colors.push_back( cv::Scalar( 0, 255, 0 ) );
-    colors.push_back( cv::Scalar( 0, 0, 255 ) );
-    colors.push_back( cv::Scalar( 255, 255, 0 ) );
-    colors.push_back( cv::Scalar( 0, 255, 255 ) );
-    colors.push_back( cv::Scalar( 255, 0, 255 ) );
+    // Create Ray Table of Color Camera
+    color_rays = k4a::create_color_rays( calibration );
 }
 
 // Finalize
 void kinect::finalize()
 {
-    // Dstroy Handle and Window
-    if( handle != nullptr ){
-        cm_skel_destroy_handle( &handle );
-    }
-    if( request_handle != nullptr ){
-        cm_skel_destroy_async_request_handle( &request_handle );
-    }
-
     // Destroy Transformation
     transformation.destroy();
 
+    // Close Playback
+    if( !file.empty() ){
+        playback.close();
+        return;
+    }
+
     // Stop Cameras
     device.stop_cameras();
 
     // Close Device
     device.close();
-
-    // Close Window
-    cv::destroyAllWindows();
 }
 
-// Run
-void kinect::run()
+// Read Frame
+bool kinect::read( frame& frame )
 {
-    // Main Loop
-    while( true ){
-        // Update
-        update();
-
-        // Draw
-        draw();
-
-        // Show
-        show();
-
-        // Wait Key
-        constexpr int32_t delay = 10;
-        const int32_t key = cv::waitKey( delay );
-        if( key == 'q' ){
-            break;
+    // Update Frame
+    {
+        scoped_timer timer( stage::acquire );
+        if( !update_frame() ){
+            return false;
         }
     }
-}
 
-// Update
-void kinect::update()
-{
-    // Update Frame
-    update_frame();
+    // Stamp Arrival (Sensor Timestamp is Mapped to Steady Clock by Engine or Orchestrator)
+    frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
 
     // Update Color
     update_color();
 
     // Update Depth
-    update_depth();
+    {
+        scoped_timer timer( stage::depth );
+        update_depth();
+    }
 
-    // Update Transformation
-    update_transformation();
+    // Update Transformation (Sparse Mode Defers Transformation until Keypoints are Retrieved)
+    if( mode == transformation_mode::dense ){
+        scoped_timer timer( stage::transformation );
+        update_transformation();
+    }
 
-    // Update Skeleton
-    update_skeleton();
+    // Keep Depth Image with Color Image
+    std::shared_ptr<cv::Mat> color_buffer;
+    {
+        scoped_timer timer( stage::conversion );
+        color_buffer = retrieve_color();
+    }
+    frame.color = color_buffer ? *color_buffer : cv::Mat();
+    frame.device_timestamp = color_image.handle() ? std::chrono::nanoseconds( color_image.get_device_timestamp() + timestamp_offset ) : std::chrono::nanoseconds( 0 );
+    frame.context = std::make_shared<kinect_context>( kinect_context{ color_buffer, ( mode == transformation_mode::sparse ) ? depth_image : k4a::image(), transformed_depth_image } );
 
     // Release Capture Handle
+    color_image.reset();
     capture.reset();
+
+    return true;
+}
+
+// Deproject 2D Keypoints to 3D Positions in Batch
+bool kinect::deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const
+{
+    const std::shared_ptr<kinect_context> context = std::static_pointer_cast<kinect_context>( frame.context );
+    if( !context ){
+        return false;
+    }
+
+    // Dense (Sample Transformed Depth Image with Color Intrinsics)
+    if( mode == transformation_mode::dense ){
+        if( !context->transformed_depth_image.handle() ){
+            return false;
+        }
+
+        k4a::deproject_dense( color_rays, context->transformed_depth_image, keypoints, depth_window, skeleton );
+        return true;
+    }
+
+    // Sparse (Map Only Keypoints to Depth Camera)
+    if( !context->depth_image.handle() ){
+        return false;
+    }
+
+    k4a::deproject_sparse( calibration, context->depth_image, keypoints, depth_window, depth_keypoints, skeleton );
+    return true;
+}
+
+// Name
+std::string kinect::name() const
+{
+    if( !file.empty() ){
+        return "skeleton (" + file + ")";
+    }
+
+    return cv::format( "skeleton (kinect %d)", device_index );
+}
+
+// Number of Buffer Allocations
+uint64_t kinect::allocations() const
+{
+    return pool.allocations();
+}
+
+// Delay of Device Timestamp from Master
+std::chrono::nanoseconds kinect::sync_delay() const
+{
+    return std::chrono::microseconds( device_configuration.subordinate_delay_off_master_usec );
 }
 
 // Update Frame
-inline void kinect::update_frame()
+inline bool kinect::update_frame()
 {
-    // Get Capture Frame
-    constexpr std::chrono::milliseconds time_out( K4A_WAIT_INFINITE );
-    const bool result = device.get_capture( &capture, time_out );
-    if( !result ){
-        this->~kinect();
+    // Get Capture Frame (Bounded Wait, so Capture Thread can be Stopped even if Device Stalls or is Unplugged)
+    if( file.empty() ){
+        constexpr std::chrono::milliseconds time_out( 1000 );
+        if( !device.get_capture( &capture, time_out ) ){
+            throw std::runtime_error( "failed to get capture (timeout)!" );
+        }
+        return true;
     }
+
+    // Get Next Capture from Recorded File (Skip Captures without Color Image)
+    do{
+        if( !playback.get_next_capture( &capture ) ){
+            return false;
+        }
+    } while( !capture.get_color_image() );
+
+    // Wait until Recorded Time of Capture
+    replay_pacer.wait( capture.get_color_image().get_device_timestamp() );
+    return true;
 }
 
 // Update Color
@@ -187,6 +281,7 @@ inline void kinect::update_depth()
 void kinect::update_transformation()
 {
     if( !color_image.handle() || !depth_image.handle() ){
+        transformed_depth_image.reset();
         return;
     }
 
@@ -194,134 +289,17 @@ void kinect::update_transformation()
     transformed_depth_image = transformation.depth_image_to_color_camera( depth_image );
 }
 
-// Update Skeleton
-inline void kinect::update_skeleton()
-{
-    if( !color_image.handle() ){
-        return;
-    }
-
-    // Get cv::Mat from k4a::image
-    cv::Mat frame = k4a::get_mat( color_image );
-
-    // Only Support 3-channels Image
-    if( frame.channels() == 4 ){
-        cv::cvtColor( frame, frame, cv::COLOR_BGRA2BGR );
-    }
-
-    // Create Image
-    CM_Image image = CM_Image{
-        reinterpret_cast<void*>( frame.data ),
-        CM_Datatype::CM_UINT8,
-        frame.cols,
-        frame.rows,
-        frame.channels(),
-        static_cast<int32_t>( frame.step[0] ),
-        CM_MemoryOrder::CM_HWC
-    };
-
-    // Async Inference
-    constexpr int32_t size = MULTIPLE * 12; // 16 * n
-    CHECK_SUCCESS( cm_skel_estimate_keypoints_start_async( handle, request_handle, &image, size ) );
-}
-
-// Draw
-void kinect::draw()
-{
-    // Draw Color
-    draw_color();
-
-    // Draw Skeleton
-    draw_skeleton();
-}
-
-// Draw Color
-inline void kinect::draw_color()
+// Retrieve Color Image
+inline std::shared_ptr<cv::Mat> kinect::retrieve_color()
 {
     if( !color_image.handle() ){
-        return;
+        return nullptr;
     }
 
-    // Get cv::Mat from k4a::image
-    color = k4a::get_mat( color_image );
-
-    // Release Color Image Handle
-    color_image.reset();
-}
-
-// Draw Skeleton
-inline void kinect::draw_skeleton()
-{
-    if( color.empty() ){
-        return;
-    }
-
-    if( !transformed_depth_image.handle() ){
-        return;
-    }
-
-    // Get Inference Result
-    const std::chrono::milliseconds timeout( 1000 );
-    const CM_ReturnCode result = cm_skel_wait_for_keypoints( handle, request_handle, buffer.get(), timeout.count() );
-
-    // Draw Skeleton
-    if( result == CM_ReturnCode::CM_SUCCESS ){
-        // Update Tracking ID
-        CHECK_SUCCESS( cm_skel_update_tracking_id( handle, previous_buffer.get(), buffer.get() ) );
-
-        // Draw Skeleton
-        uint16_t* transformed_depth = reinterpret_cast<uint16_t*>( transformed_depth_image.get_buffer() );
-        for( int32_t i = 0; i < buffer->numSkeletons; i++ ){
-            const CM_SKEL_KeypointsBuffer& skeleton = buffer->skeletons[i];
-            for( int32_t j = 0; j < skeleton.numKeyPoints; j++ ){
-                constexpr float threshold = 0.5f;
-                if( skeleton.confidences[j] < threshold ){
-                    continue;
-                }
-
-                // Draw Joint
-                constexpr int32_t radius = 5;
-                const cv::Point point = cv::Point( skeleton.keypoints_coord_x[j], skeleton.keypoints_coord_y[j] );
-                const cv::Scalar color = colors[skeleton.id % colors.size()];
-                cv::circle( this->color, point, radius, colors[skeleton.id % colors.size()], -1, cv::LineTypes::LINE_AA );
-
-                // Get 3D Position
-                k4a_float3_t point_3d;
-                const k4a_float2_t point_2d = { point.x, point.y };
-                const bool result = calibration.convert_2d_to_3d( point_2d, transformed_depth[point.y * point.x], k4a_calibration_type_t::K4A_CALIBRATION_TYPE_COLOR, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_COLOR, &point_3d );
-                if( !result ){
-                    continue;
-                }
-
-                // Draw 3D Position
-                constexpr int32_t offcet = 20;
-                constexpr double scale = 0.5;
-                const std::string label = cv::format( "( %8.2f, %8.2f, %8.2f )", point_3d.xyz.x, point_3d.xyz.y, point_3d.xyz.z );
-                cv::putText( this->color, label, cv::Point( point.x - offcet, point.y - offcet ), cv::FONT_HERSHEY_COMPLEX, scale, color );
-            }
-        }
-
-        // Swap and Release Previous Buffer
-        previous_buffer.swap( buffer );
-        cm_skel_release_buffer( buffer.get() );
-    }
-}
-
-// Show
-void kinect::show()
-{
-    // Show Skeleton
-    show_skeleton();
-}
-
-// Show Color
-inline void kinect::show_skeleton()
-{
-    if( color.empty() ){
-        return;
-    }
+    // Convert k4a::image into Recycled Buffer in Single Pass (Only Support 3-channels Image)
+    const cv::Size size( color_image.get_width_pixels(), color_image.get_height_pixels() );
+    std::shared_ptr<cv::Mat> buffer = pool.acquire( size, CV_8UC3 );
+    k4a::get_bgr( color_image, *buffer );
 
-    // Show Image
-    const cv::String window_name = cv::format( "skeleton (kinect %d)", device_index );
-    cv::imshow( window_name, color );
+    return buffer;
 }
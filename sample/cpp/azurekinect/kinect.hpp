@@ -1,15 +1,43 @@
 #ifndef __KINECT__
 #define __KINECT__
 
-#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
 
 #include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
 #include <opencv2/opencv.hpp>
-#include <cubemos/skeleton_tracking.h>
 
-#include "util.hpp"
+#include "source.hpp"
+#include "pool.hpp"
+#include "pacer.hpp"
+#include "k4a_util.hpp"
 
-class kinect
+// Transformation Mode of Depth
+enum class transformation_mode
+{
+    dense, // transform full depth image to color camera before inference
+    sparse // map only keypoints to depth camera after inference
+};
+
+// Wired Sync Configuration (Master/Subordinate Rig)
+struct sync_configuration
+{
+    k4a_wired_sync_mode_t mode = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
+    int32_t depth_delay_usec = 0;        // delay of depth from color (e.g. 160us x index avoids interference of depth lasers)
+    uint32_t subordinate_delay_usec = 0; // delay of subordinate from master (subordinate only)
+};
+
+// Frame Context (Keep Color Buffer and Depth Image until Result is Retrieved)
+struct kinect_context
+{
+    std::shared_ptr<cv::Mat> color_buffer;
+    k4a::image depth_image;             // sparse mode
+    k4a::image transformed_depth_image; // dense mode
+};
+
+class kinect : public source
 {
 private:
     // Kinect
@@ -19,44 +47,52 @@ private:
     k4a::transformation transformation;
     k4a_device_configuration_t device_configuration;
     uint32_t device_index;
+    sync_configuration sync;
+    std::chrono::microseconds timestamp_offset; // start of recording (aligns device timestamps of several files)
+    cv::Mat color_rays; // ray (normalized coordinate at z = 1) of each color pixel (dense mode)
+
+    // Playback (Empty File means Live Device)
+    k4a::playback playback;
+    std::string file;
+    pacer replay_pacer;
 
     // Color
     k4a::image color_image;
-    cv::Mat color;
+    frame_pool pool; // recycled buffers for converted color image
 
     // Depth
     k4a::image depth_image;
 
     // Transformed
     k4a::image transformed_depth_image;
-
-    // Cubemos
-    CM_SKEL_Handle* handle;
-    CM_SKEL_AsyncRequestHandle* request_handle;
-    CUBEMOS_SKEL_Buffer_Ptr buffer;
-    CUBEMOS_SKEL_Buffer_Ptr previous_buffer;
-
-    // Visualize
-    std::vector<cv::Scalar> colors;
+    transformation_mode mode;
+    int32_t depth_window; // window size of median filter for depth at keypoints
+    mutable skeleton2d depth_keypoints; // keypoints mapped to depth image (sparse mode)
 
 public:
-    // Constructor
-    kinect( const uint32_t index = K4A_DEVICE_DEFAULT );
+    // Constructor (Live Device, Subordinates must be Opened before Master)
+    kinect( const uint32_t index = K4A_DEVICE_DEFAULT, const int32_t depth_window = 3, const transformation_mode mode = transformation_mode::sparse, const sync_configuration& sync = sync_configuration() );
+
+    // Constructor (Recorded File *.mkv, realtime = false means max throughput)
+    kinect( const std::string& file, const int32_t depth_window = 3, const transformation_mode mode = transformation_mode::sparse, const bool realtime = true );
 
     // Destructor
     ~kinect();
 
-    // Run
-    void run();
+    // Read Frame
+    bool read( frame& frame ) override;
+
+    // Deproject 2D Keypoints to 3D Positions in Batch
+    bool deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const override;
 
-    // Update
-    void update();
+    // Name
+    std::string name() const override;
 
-    // Draw
-    void draw();
+    // Number of Buffer Allocations
+    uint64_t allocations() const;
 
-    // Show
-    void show();
+    // Delay of Device Timestamp from Master (Subtracted to Align Captures of Rig)
+    std::chrono::nanoseconds sync_delay() const;
 
 private:
     // Initialize
@@ -65,14 +101,17 @@ private:
     // Initialize Sensor
     void initialize_sensor();
 
-    // Initialize Skeleton
-    void initialize_skeleton();
+    // Initialize Playback
+    void initialize_playback();
+
+    // Initialize Rays
+    void initialize_rays();
 
     // Finalize
     void finalize();
 
-    // Update Frame
-    void update_frame();
+    // Update Frame (Return false at End of File)
+    bool update_frame();
 
     // Update Color
     void update_color();
@@ -83,17 +122,8 @@ private:
     // Update Transformation
     void update_transformation();
 
-    // Update Skeleton
-    void update_skeleton();
-
-    // Draw Color
-    void draw_color();
-
-    // Draw Skeleton
-    void draw_skeleton();
-
-    // Show Skeleton
-    void show_skeleton();
+    // Retrieve Color Image
+    std::shared_ptr<cv::Mat> retrieve_color();
 };
 
 #endif // __KINECT__
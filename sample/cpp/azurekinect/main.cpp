@@ -1,13 +1,85 @@
 #include <iostream>
 #include <sstream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <algorithm>
 
 #include "kinect.hpp"
+#include "engine.hpp"
+#include "orchestrator.hpp"
+#include "option.hpp"
+#include "interrupt.hpp"
+
+// Parse Transformation Mode
+transformation_mode parse_transformation( const std::string& transformation )
+{
+    if( transformation == "sparse" ){
+        return transformation_mode::sparse;
+    }
+    if( transformation == "dense" ){
+        return transformation_mode::dense;
+    }
+
+    throw std::runtime_error( "failed to parse --transformation " + transformation + " (sparse or dense)!" );
+}
+
+// Wired Sync Configuration of Device (First Device is Master)
+sync_configuration get_sync_configuration( const options& options, const size_t index )
+{
+    sync_configuration sync;
+    if( !is_synchronized( options ) ){
+        return sync;
+    }
+
+    // Offset Depth Capture of Each Device to Avoid Interference of Depth Lasers (Color Cameras are Synchronized)
+    constexpr int32_t depth_delay_usec = 160;
+    sync.mode = ( index == 0 ) ? k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_MASTER : k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_SUBORDINATE;
+    sync.depth_delay_usec = depth_delay_usec * static_cast<int32_t>( index );
+    return sync;
+}
 
 int main( int argc, char* argv[] )
 {
     try{
-        kinect kinect;
-        kinect.run();
+        const options options = parse_options( argc, argv );
+        install_interrupt_handler();
+
+        // Open Devices (or Recorded Files)
+        // (Subordinates are Opened before Master, because Master Starts Sync Pulses when Cameras are Started)
+        const std::vector<std::string> inputs = get_inputs( options );
+        const size_t count = inputs.empty() ? options.devices : inputs.size();
+        std::vector<std::unique_ptr<kinect>> kinects( count );
+        for( size_t i = count; 0 < i--; ){
+            if( inputs.empty() ){
+                kinects[i] = std::make_unique<kinect>( static_cast<uint32_t>( i ), options.depth_window, parse_transformation( options.transformation ), get_sync_configuration( options, i ) );
+            }
+            else{
+                kinects[i] = std::make_unique<kinect>( inputs[i], options.depth_window, parse_transformation( options.transformation ), is_realtime( options ) );
+            }
+        }
+
+        std::vector<source*> sources;
+        std::vector<std::chrono::nanoseconds> delays;
+        for( const std::unique_ptr<kinect>& kinect : kinects ){
+            sources.push_back( kinect.get() );
+            delays.push_back( kinect->sync_delay() );
+        }
+
+        // Run Skeleton Tracking of Wired Sync Rig (Skeletons of Synchronized Frames are Fused)
+        if( is_synchronized( options ) ){
+            orchestrator orchestrator( create_backend( options ), std::max( options.depth, sources.size() ), options.inference_size );
+            run( orchestrator, sources, create_synchronization( options, delays ), options );
+        }
+        // Run Skeleton Tracking (Several Devices Share One Model)
+        else if( sources.size() == 1 ){
+            engine engine( create_backend( options ), options.depth, options.inference_size );
+            run( engine, *sources.front(), options );
+        }
+        else{
+            orchestrator orchestrator( create_backend( options ), options.depth, options.inference_size );
+            run( orchestrator, sources, options );
+        }
     }
     catch( const k4a::error& error ){
         std::cout << error.what() << std::endl;
@@ -19,4 +91,4 @@ int main( int argc, char* argv[] )
     }
 
     return 0;
-}
\ No newline at end of file
+}
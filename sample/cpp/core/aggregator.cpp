@@ -0,0 +1,160 @@
+#include "aggregator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Constructor
+capture_aggregator::capture_aggregator( const size_t devices, const std::chrono::nanoseconds tolerance, const size_t capacity, const bool lossless )
+    : queues( devices ),
+      tolerance( tolerance ),
+      capacity( std::max<size_t>( capacity, 1 ) ),
+      lossless( lossless ),
+      stopped( false ),
+      drop_count( 0 )
+{
+    if( devices == 0 ){
+        throw std::runtime_error( "failed to create aggregator (no device)!" );
+    }
+}
+
+// Set Sync Delay of Device
+void capture_aggregator::set_delay( const size_t device, const std::chrono::nanoseconds delay )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    queues.at( device ).delay = delay;
+}
+
+// Push Frame of Device
+void capture_aggregator::push( const size_t device, frame&& frame )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    queue& queue = queues.at( device );
+
+    // Wait for Space (Lossless) or Drop Oldest Frame (Live)
+    if( lossless ){
+        popped.wait( lock, [&]{ return stopped || queue.frames.size() < capacity; } );
+        if( stopped ){
+            return;
+        }
+    }
+    else if( queue.frames.size() >= capacity ){
+        queue.frames.pop_front();
+        drop_count++;
+    }
+
+    queue.frames.push_back( std::move( frame ) );
+    lock.unlock();
+    pushed.notify_all();
+}
+
+// Close Device
+void capture_aggregator::close( const size_t device )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        queues.at( device ).closed = true;
+    }
+    pushed.notify_all();
+}
+
+// Stop
+void capture_aggregator::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopped = true;
+    }
+    pushed.notify_all();
+    popped.notify_all();
+}
+
+// Pop Group of Aligned Frames
+bool capture_aggregator::pop( std::vector<frame>& group, const std::chrono::milliseconds timeout )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+    bool gathered = try_gather( group );
+    while( !gathered && !stopped && !is_finished() ){
+        if( pushed.wait_until( lock, deadline ) == std::cv_status::timeout ){
+            gathered = try_gather( group );
+            break;
+        }
+        gathered = try_gather( group );
+    }
+
+    // Wake Up Capture Threads (Queues may have Space after Gather or Drop)
+    lock.unlock();
+    popped.notify_all();
+    return gathered;
+}
+
+// Check Group can not be Completed
+bool capture_aggregator::finished() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return stopped || is_finished();
+}
+
+// Number of Frames Dropped
+uint64_t capture_aggregator::drops() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return drop_count;
+}
+
+// Aligned Time of Frame
+inline std::chrono::nanoseconds capture_aggregator::get_aligned_time( const queue& queue, const frame& frame ) const
+{
+    return frame.device_timestamp - queue.delay;
+}
+
+// Check Group can not be Completed
+inline bool capture_aggregator::is_finished() const
+{
+    for( const queue& queue : queues ){
+        if( queue.closed && queue.frames.empty() ){
+            return true;
+        }
+    }
+    return false;
+}
+
+// Try to Gather Group from Heads of Queues
+inline bool capture_aggregator::try_gather( std::vector<frame>& group )
+{
+    group.clear();
+    while( true ){
+        // Wait until Every Device has Frame
+        for( const queue& queue : queues ){
+            if( queue.frames.empty() ){
+                return false;
+            }
+        }
+
+        // Latest Head
+        std::chrono::nanoseconds latest = get_aligned_time( queues.front(), queues.front().frames.front() );
+        for( const queue& queue : queues ){
+            latest = std::max( latest, get_aligned_time( queue, queue.frames.front() ) );
+        }
+
+        // Drop Heads Older than Latest Head by Tolerance (They Never Match Later Frames)
+        bool aligned = true;
+        for( queue& queue : queues ){
+            if( latest - get_aligned_time( queue, queue.frames.front() ) > tolerance ){
+                queue.frames.pop_front();
+                drop_count++;
+                aligned = false;
+            }
+        }
+        if( !aligned ){
+            continue;
+        }
+
+        // Move Aligned Heads into Group
+        for( queue& queue : queues ){
+            group.push_back( std::move( queue.frames.front() ) );
+            queue.frames.pop_front();
+        }
+        return true;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef __AGGREGATOR__
+#define __AGGREGATOR__
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+
+#include "source.hpp"
+
+/*
+ This is capture aggregator that groups frames of synchronized devices by device timestamp.
+
+ Each capture thread pushes frames of its device into bounded queue,
+ and consumer pops group that has one frame of every device.
+ Device timestamp minus sync delay of device (e.g. subordinate delay of wired sync) is aligned time,
+ and heads of queues are grouped if their aligned times are within tolerance of latest head.
+ Older heads never match later frames, so they are dropped.
+ If queue is full, oldest frame is dropped (live), or capture thread waits (lossless, for replay at max throughput).
+
+ capture_aggregator aggregator( 2, std::chrono::microseconds( 2000 ) );
+ aggregator.set_delay( 1, subordinate.sync_delay() );
+
+ // Capture Thread of Device i
+ aggregator.push( i, std::move( frame ) );
+ aggregator.close( i ); // end of stream
+
+ // Consumer
+ std::vector<frame> group;
+ while( aggregator.pop( group, std::chrono::milliseconds( 10 ) ) ){
+ }
+*/
+class capture_aggregator
+{
+private:
+    // Queue of Device
+    struct queue
+    {
+        std::deque<frame> frames;
+        std::chrono::nanoseconds delay = std::chrono::nanoseconds( 0 );
+        bool closed = false;
+    };
+
+    std::vector<queue> queues;
+    std::chrono::nanoseconds tolerance;
+    size_t capacity;
+    bool lossless;
+    bool stopped;
+    uint64_t drop_count;
+
+    mutable std::mutex mutex;
+    std::condition_variable pushed;
+    std::condition_variable popped;
+
+public:
+    // Constructor
+    capture_aggregator( const size_t devices, const std::chrono::nanoseconds tolerance, const size_t capacity = 4, const bool lossless = false );
+
+    // Set Sync Delay of Device (Subtracted from Device Timestamp)
+    void set_delay( const size_t device, const std::chrono::nanoseconds delay );
+
+    // Push Frame of Device (Capture Thread)
+    void push( const size_t device, frame&& frame );
+
+    // Close Device (End of Stream)
+    void close( const size_t device );
+
+    // Stop (Wake Up All Waiting Threads)
+    void stop();
+
+    // Pop Group of Aligned Frames (Ordered by Device, Return false at Timeout or if Group can not be Completed)
+    bool pop( std::vector<frame>& group, const std::chrono::milliseconds timeout );
+
+    // Check Group can not be Completed (Any Closed Device has No Frame)
+    bool finished() const;
+
+    // Number of Frames Dropped (Unmatched or Overflowed)
+    uint64_t drops() const;
+
+private:
+    // Aligned Time of Frame
+    std::chrono::nanoseconds get_aligned_time( const queue& queue, const frame& frame ) const;
+
+    // Check Group can not be Completed (Lock must be Held)
+    bool is_finished() const;
+
+    // Try to Gather Group from Heads of Queues (Lock must be Held)
+    bool try_gather( std::vector<frame>& group );
+};
+
+#endif // __AGGREGATOR__
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "arena.hpp"
+
+std::atomic<uint64_t> skeleton_arena::total_allocation_count( 0 );
+
+// Constructor
+skeleton_arena::skeleton_arena( const size_t buffers, const size_t capacity, const size_t joints )
+    : capacity( capacity ),
+      joints( joints ),
+      allocation_count( 0 ),
+      backend_allocation_count( 0 )
+{
+    // Preallocate Buffers
+    for( size_t i = 0; i < buffers; i++ ){
+        slots.push_back( std::make_unique<slot>() );
+        allocate( *slots.back(), capacity, joints );
+        free_slots.push_back( slots.back().get() );
+    }
+}
+
+// Acquire Empty Buffer
+CUBEMOS_SKEL_Buffer_Ptr skeleton_arena::acquire()
+{
+    // Grow Arena if All Buffers are in Use
+    if( free_slots.empty() ){
+        slots.push_back( std::make_unique<slot>() );
+        allocate( *slots.back(), capacity, joints );
+        free_slots.push_back( slots.back().get() );
+    }
+
+    slot* target = free_slots.back();
+    free_slots.pop_back();
+    target->buffer.numSkeletons = 0;
+
+    return CUBEMOS_SKEL_Buffer_Ptr( &target->buffer, [this]( CM_SKEL_Buffer* pb ){ release( pb ); } );
+}
+
+// Copy Keypoints of Result of Backend into Buffer of Arena, and Release Result
+void skeleton_arena::store( backend& backend, CM_SKEL_Buffer* source, CM_SKEL_Buffer* buffer )
+{
+    slot& target = find( buffer );
+    if( source == nullptr || source->skeletons == nullptr ){
+        target.buffer.numSkeletons = 0;
+        return;
+    }
+
+    // Release Result after Copy (Skeletons were Allocated by Backend)
+    const CUBEMOS_SKEL_Buffer_Ptr result( source, [&backend]( CM_SKEL_Buffer* pb ){ backend.release_buffer( pb ); } );
+    backend_allocation_count++;
+    if( source->numSkeletons <= 0 ){
+        target.buffer.numSkeletons = 0;
+        return;
+    }
+
+    // Reallocate Block only if Result Exceeds Capacity
+    const size_t persons = static_cast<size_t>( source->numSkeletons );
+    size_t keypoints = 0;
+    for( size_t i = 0; i < persons; i++ ){
+        keypoints = std::max( keypoints, static_cast<size_t>( std::max( source->skeletons[i].numKeyPoints, 0 ) ) );
+    }
+    if( target.capacity < persons || target.stride < keypoints ){
+        allocate( target, std::max( target.capacity, persons ), std::max( target.stride, keypoints ) );
+    }
+
+    // Copy Keypoints (Skeletons Point into Block)
+    for( size_t i = 0; i < persons; i++ ){
+        const CM_SKEL_KeypointsBuffer& from = source->skeletons[i];
+        CM_SKEL_KeypointsBuffer& to = target.skeletons[i];
+        const int32_t count = std::max( from.numKeyPoints, 0 );
+        to.id = from.id;
+        to.numKeyPoints = count;
+        std::copy( from.keypoints_coord_x, from.keypoints_coord_x + count, to.keypoints_coord_x );
+        std::copy( from.keypoints_coord_y, from.keypoints_coord_y + count, to.keypoints_coord_y );
+        std::copy( from.confidences, from.confidences + count, to.confidences );
+    }
+    target.buffer.numSkeletons = static_cast<int32_t>( persons );
+}
+
+// Number of Allocations of This Arena
+uint64_t skeleton_arena::allocations() const
+{
+    return allocation_count;
+}
+
+// Number of Results Allocated by Backend and Released by This Arena
+uint64_t skeleton_arena::backend_allocations() const
+{
+    return backend_allocation_count;
+}
+
+// Number of Allocations of All Arenas
+uint64_t skeleton_arena::total_allocations()
+{
+    return total_allocation_count;
+}
+
+// Allocate Block of Slot for Persons x Joints
+void skeleton_arena::allocate( slot& slot, const size_t persons, const size_t keypoints )
+{
+    // Round Stride up to Cache Line, so Each Channel of Each Skeleton Starts on Cache Line
+    constexpr size_t floats = alignment / sizeof( float );
+    const size_t stride = std::max<size_t>( ( keypoints + floats - 1 ) / floats * floats, floats );
+    const size_t channel = persons * stride;
+
+    // Block of x, y and Confidences
+    slot.block.reset( static_cast<float*>( ::operator new[]( 3 * channel * sizeof( float ), std::align_val_t( alignment ) ) ) );
+    slot.capacity = persons;
+    slot.stride = stride;
+    allocation_count++;
+    total_allocation_count++;
+
+    // Skeletons Point into Block
+    slot.skeletons.resize( persons );
+    for( size_t i = 0; i < persons; i++ ){
+        CM_SKEL_KeypointsBuffer& skeleton = slot.skeletons[i];
+        skeleton.id = -1;
+        skeleton.numKeyPoints = 0;
+        skeleton.keypoints_coord_x = slot.block.get() + i * stride;
+        skeleton.keypoints_coord_y = slot.block.get() + channel + i * stride;
+        skeleton.confidences = slot.block.get() + 2 * channel + i * stride;
+    }
+    slot.buffer.skeletons = slot.skeletons.data();
+    slot.buffer.numSkeletons = 0;
+}
+
+// Find Slot of Buffer
+skeleton_arena::slot& skeleton_arena::find( const CM_SKEL_Buffer* buffer )
+{
+    for( const std::unique_ptr<slot>& candidate : slots ){
+        if( &candidate->buffer == buffer ){
+            return *candidate;
+        }
+    }
+
+    throw std::runtime_error( "failed to find buffer in arena!" );
+}
+
+// Return Buffer to Free List
+void skeleton_arena::release( CM_SKEL_Buffer* buffer )
+{
+    slot& target = find( buffer );
+    target.buffer.numSkeletons = 0;
+    free_slots.push_back( &target );
+}
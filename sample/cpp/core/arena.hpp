@@ -0,0 +1,93 @@
+#ifndef __ARENA__
+#define __ARENA__
+
+#include <new>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <cubemos/skeleton_tracking.h>
+
+#include "util.hpp"
+#include "backend.hpp"
+
+/*
+ This is arena of result buffers that replaces per-frame buffers of backend after retrieve.
+
+ Keypoints of result are copied into preallocated buffer of arena, and buffer of backend is released immediately,
+ so tracking, mapping and latest result never hold memory of backend across frames.
+ Each buffer is one cache-aligned block in SoA layout (x, y and confidence of max persons x joints),
+ and skeletons of buffer point into block, so buffer is compatible with CM_SKEL_Buffer of SDK.
+ Buffers are returned to free list of arena when released (unique_ptr), and are reused by next result,
+ and block is reallocated only if result exceeds capacity of block.
+ Backend (SDK) still allocates skeletons of each result in wait_for_keypoints() that must be released,
+ so they are counted separately from blocks of arena (result_arena benchmark reports both per result).
+ Arena is not thread safe, so it is owned by thread that retrieves results.
+
+ skeleton_arena arena;
+ CUBEMOS_SKEL_Buffer_Ptr result = arena.acquire();
+ arena.store( backend, sdk_buffer, result.get() ); // sdk_buffer is released
+ previous_buffer = std::move( result ); // previous buffer returns to free list
+*/
+class skeleton_arena
+{
+private:
+    // Cache Line Size (Alignment of Blocks and Stride of Skeletons)
+    static constexpr size_t alignment = 64;
+
+    // Buffer (Skeletons Point into Block)
+    struct slot
+    {
+        CM_SKEL_Buffer buffer;
+        std::vector<CM_SKEL_KeypointsBuffer> skeletons;
+        std::unique_ptr<float[], void( * )( float* )> block{ nullptr, []( float* p ){ ::operator delete[]( p, std::align_val_t( alignment ) ); } };
+        size_t capacity = 0; // max persons
+        size_t stride = 0;   // floats of each skeleton in each channel (multiple of cache line)
+    };
+
+    std::vector<std::unique_ptr<slot>> slots;
+    std::vector<slot*> free_slots;
+    size_t capacity;
+    size_t joints;
+
+    // Allocation Counters
+    uint64_t allocation_count;
+    uint64_t backend_allocation_count;
+    static std::atomic<uint64_t> total_allocation_count;
+
+public:
+    // Constructor (Buffers are Preallocated for Persons x Joints)
+    skeleton_arena( const size_t buffers = 2, const size_t capacity = 64, const size_t joints = 18 );
+
+    skeleton_arena( const skeleton_arena& ) = delete;
+    skeleton_arena& operator=( const skeleton_arena& ) = delete;
+
+    // Acquire Empty Buffer (Buffer Returns to Arena when Released)
+    CUBEMOS_SKEL_Buffer_Ptr acquire();
+
+    // Copy Keypoints of Result of Backend into Buffer of Arena, and Release Result
+    void store( backend& backend, CM_SKEL_Buffer* source, CM_SKEL_Buffer* buffer );
+
+    // Number of Allocations of Blocks of This Arena
+    uint64_t allocations() const;
+
+    // Number of Results Allocated by Backend and Released by This Arena
+    uint64_t backend_allocations() const;
+
+    // Number of Allocations of All Arenas
+    static uint64_t total_allocations();
+
+private:
+    // Allocate Block of Slot for Persons x Joints
+    void allocate( slot& slot, const size_t persons, const size_t keypoints );
+
+    // Find Slot of Buffer
+    slot& find( const CM_SKEL_Buffer* buffer );
+
+    // Return Buffer to Free List
+    void release( CM_SKEL_Buffer* buffer );
+};
+
+#endif // __ARENA__
@@ -0,0 +1,76 @@
+#include "backend.hpp"
+
+#ifdef HAVE_CUBEMOS
+// Constructor
+cubemos_backend::cubemos_backend()
+    : handle( nullptr )
+{
+}
+
+// Destructor
+cubemos_backend::~cubemos_backend()
+{
+    // Destroy Async Request Handles
+    for( CM_SKEL_AsyncRequestHandle*& request_handle : request_handles ){
+        if( request_handle != nullptr ){
+            cm_skel_destroy_async_request_handle( &request_handle );
+        }
+    }
+
+    // Destroy Handle
+    if( handle != nullptr ){
+        cm_skel_destroy_handle( &handle );
+    }
+}
+
+// Create Handle
+CM_ReturnCode cubemos_backend::create_handle( const std::string& license_directory )
+{
+    return cm_skel_create_handle( &handle, license_directory.c_str() );
+}
+
+// Load Model
+CM_ReturnCode cubemos_backend::load_model( const CM_TargetComputeDevice target_device, const std::string& model )
+{
+    return cm_skel_load_model( handle, target_device, model.c_str() );
+}
+
+// Create Async Request
+CM_ReturnCode cubemos_backend::create_async_request( size_t& request )
+{
+    CM_SKEL_AsyncRequestHandle* request_handle = nullptr;
+    const CM_ReturnCode result = cm_skel_create_async_request_handle( handle, &request_handle );
+    if( result != CM_ReturnCode::CM_SUCCESS ){
+        return result;
+    }
+
+    request = request_handles.size();
+    request_handles.push_back( request_handle );
+
+    return result;
+}
+
+// Start Async Inference
+CM_ReturnCode cubemos_backend::estimate_keypoints_start_async( const size_t request, const CM_Image& image, const int32_t size )
+{
+    return cm_skel_estimate_keypoints_start_async( handle, request_handles[request], &image, size );
+}
+
+// Wait for Keypoints
+CM_ReturnCode cubemos_backend::wait_for_keypoints( const size_t request, CM_SKEL_Buffer* buffer, const int32_t timeout )
+{
+    return cm_skel_wait_for_keypoints( handle, request_handles[request], buffer, timeout );
+}
+
+// Update Tracking ID
+CM_ReturnCode cubemos_backend::update_tracking_id( const CM_SKEL_Buffer* previous_buffer, CM_SKEL_Buffer* buffer )
+{
+    return cm_skel_update_tracking_id( handle, previous_buffer, buffer );
+}
+
+// Release Buffer
+void cubemos_backend::release_buffer( CM_SKEL_Buffer* buffer )
+{
+    cm_skel_release_buffer( buffer );
+}
+#endif
@@ -0,0 +1,78 @@
+#ifndef __BACKEND__
+#define __BACKEND__
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+#include <cubemos/skeleton_tracking.h>
+
+/*
+ This is interface of inference backend that matches cm_skel_* functions used in samples.
+
+ Async requests are identified by index that is returned from create_async_request().
+ Buffers that are filled by wait_for_keypoints() must be released by release_buffer() of same backend.
+
+ std::unique_ptr<backend> backend = std::make_unique<cubemos_backend>(); // or mock_backend
+ backend->create_handle( license_directory );
+ backend->load_model( CM_TargetComputeDevice::CM_CPU, model );
+*/
+class backend
+{
+public:
+    // Destructor
+    virtual ~backend() = default;
+
+    // Create Handle
+    virtual CM_ReturnCode create_handle( const std::string& license_directory ) = 0;
+
+    // Load Model
+    virtual CM_ReturnCode load_model( const CM_TargetComputeDevice target_device, const std::string& model ) = 0;
+
+    // Create Async Request
+    virtual CM_ReturnCode create_async_request( size_t& request ) = 0;
+
+    // Start Async Inference
+    virtual CM_ReturnCode estimate_keypoints_start_async( const size_t request, const CM_Image& image, const int32_t size ) = 0;
+
+    // Wait for Keypoints
+    virtual CM_ReturnCode wait_for_keypoints( const size_t request, CM_SKEL_Buffer* buffer, const int32_t timeout ) = 0;
+
+    // Update Tracking ID
+    virtual CM_ReturnCode update_tracking_id( const CM_SKEL_Buffer* previous_buffer, CM_SKEL_Buffer* buffer ) = 0;
+
+    // Release Buffer
+    virtual void release_buffer( CM_SKEL_Buffer* buffer ) = 0;
+};
+
+#ifdef HAVE_CUBEMOS
+// Backend of Skeleton Tracking SDK by Cubemos
+class cubemos_backend : public backend
+{
+private:
+    // Cubemos
+    CM_SKEL_Handle* handle;
+    std::vector<CM_SKEL_AsyncRequestHandle*> request_handles;
+
+public:
+    // Constructor
+    cubemos_backend();
+
+    // Destructor
+    ~cubemos_backend();
+
+    cubemos_backend( const cubemos_backend& ) = delete;
+    cubemos_backend& operator=( const cubemos_backend& ) = delete;
+
+    CM_ReturnCode create_handle( const std::string& license_directory ) override;
+    CM_ReturnCode load_model( const CM_TargetComputeDevice target_device, const std::string& model ) override;
+    CM_ReturnCode create_async_request( size_t& request ) override;
+    CM_ReturnCode estimate_keypoints_start_async( const size_t request, const CM_Image& image, const int32_t size ) override;
+    CM_ReturnCode wait_for_keypoints( const size_t request, CM_SKEL_Buffer* buffer, const int32_t timeout ) override;
+    CM_ReturnCode update_tracking_id( const CM_SKEL_Buffer* previous_buffer, CM_SKEL_Buffer* buffer ) override;
+    void release_buffer( CM_SKEL_Buffer* buffer ) override;
+};
+#endif
+
+#endif // __BACKEND__
@@ -0,0 +1,152 @@
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+#include <opencv2/opencv.hpp>
+
+#include "convert.hpp"
+
+/*
+ This is microbenchmark of color converters into packed BGR (input of inference).
+
+ "opencv" is previous two-step path (clone of source buffer, cvtColor into BGRA, then cvtColor into BGR),
+ and others are single-pass converters with specified instruction set.
+
+ skeleton_bench --benchmark_filter=nv12
+*/
+
+namespace
+{
+    constexpr int32_t width = 1280;
+    constexpr int32_t height = 720;
+
+    // Synthetic Source Buffer
+    std::vector<uint8_t> create_source( const size_t size )
+    {
+        std::mt19937 random( 0 );
+        std::vector<uint8_t> source( size );
+        for( uint8_t& value : source ){
+            value = static_cast<uint8_t>( random() );
+        }
+        return source;
+    }
+
+    // Skip Benchmark if Instruction Set is Not Available
+    bool check_instruction_set( benchmark::State& state, const instruction_set isa )
+    {
+        if( !is_instruction_set_available( isa ) ){
+            state.SkipWithError( "instruction set is not available" );
+            return false;
+        }
+        state.SetLabel( get_instruction_set_name( isa ) );
+        return true;
+    }
+
+    // Set Processed Pixels
+    void set_pixels( benchmark::State& state )
+    {
+        state.SetItemsProcessed( state.iterations() * width * height );
+    }
+}
+
+// BGRA to BGR
+void bgra_opencv( benchmark::State& state )
+{
+    const std::vector<uint8_t> source = create_source( width * height * 4 );
+    cv::Mat bgr;
+    for( auto _ : state ){
+        const cv::Mat bgra = cv::Mat( height, width, CV_8UC4, const_cast<uint8_t*>( source.data() ) ).clone();
+        cv::cvtColor( bgra, bgr, cv::COLOR_BGRA2BGR );
+        benchmark::DoNotOptimize( bgr.data );
+    }
+    set_pixels( state );
+}
+BENCHMARK( bgra_opencv );
+
+void bgra_convert( benchmark::State& state, const instruction_set isa )
+{
+    if( !check_instruction_set( state, isa ) ){
+        return;
+    }
+
+    const std::vector<uint8_t> source = create_source( width * height * 4 );
+    cv::Mat bgr( height, width, CV_8UC3 );
+    for( auto _ : state ){
+        convert_bgra_to_bgr( source.data(), width * 4, bgr.data, bgr.step, width, height, isa );
+        benchmark::DoNotOptimize( bgr.data );
+    }
+    set_pixels( state );
+}
+BENCHMARK_CAPTURE( bgra_convert, scalar, instruction_set::scalar );
+BENCHMARK_CAPTURE( bgra_convert, sse41, instruction_set::sse41 );
+BENCHMARK_CAPTURE( bgra_convert, avx2, instruction_set::avx2 );
+BENCHMARK_CAPTURE( bgra_convert, neon, instruction_set::neon );
+
+// NV12 to BGR
+void nv12_opencv( benchmark::State& state )
+{
+    const std::vector<uint8_t> source = create_source( width * ( height + height / 2 ) );
+    cv::Mat bgra, bgr;
+    for( auto _ : state ){
+        const cv::Mat nv12 = cv::Mat( height + height / 2, width, CV_8UC1, const_cast<uint8_t*>( source.data() ) ).clone();
+        cv::cvtColor( nv12, bgra, cv::COLOR_YUV2BGRA_NV12 );
+        cv::cvtColor( bgra, bgr, cv::COLOR_BGRA2BGR );
+        benchmark::DoNotOptimize( bgr.data );
+    }
+    set_pixels( state );
+}
+BENCHMARK( nv12_opencv );
+
+void nv12_convert( benchmark::State& state, const instruction_set isa )
+{
+    if( !check_instruction_set( state, isa ) ){
+        return;
+    }
+
+    const std::vector<uint8_t> source = create_source( width * ( height + height / 2 ) );
+    cv::Mat bgr( height, width, CV_8UC3 );
+    for( auto _ : state ){
+        convert_nv12_to_bgr( source.data(), width, source.data() + width * height, width, bgr.data, bgr.step, width, height, isa );
+        benchmark::DoNotOptimize( bgr.data );
+    }
+    set_pixels( state );
+}
+BENCHMARK_CAPTURE( nv12_convert, scalar, instruction_set::scalar );
+BENCHMARK_CAPTURE( nv12_convert, sse41, instruction_set::sse41 );
+BENCHMARK_CAPTURE( nv12_convert, avx2, instruction_set::avx2 );
+BENCHMARK_CAPTURE( nv12_convert, neon, instruction_set::neon );
+
+// YUY2 to BGR
+void yuy2_opencv( benchmark::State& state )
+{
+    const std::vector<uint8_t> source = create_source( width * height * 2 );
+    cv::Mat bgra, bgr;
+    for( auto _ : state ){
+        const cv::Mat yuy2 = cv::Mat( height, width, CV_8UC2, const_cast<uint8_t*>( source.data() ) ).clone();
+        cv::cvtColor( yuy2, bgra, cv::COLOR_YUV2BGRA_YUY2 );
+        cv::cvtColor( bgra, bgr, cv::COLOR_BGRA2BGR );
+        benchmark::DoNotOptimize( bgr.data );
+    }
+    set_pixels( state );
+}
+BENCHMARK( yuy2_opencv );
+
+void yuy2_convert( benchmark::State& state, const instruction_set isa )
+{
+    if( !check_instruction_set( state, isa ) ){
+        return;
+    }
+
+    const std::vector<uint8_t> source = create_source( width * height * 2 );
+    cv::Mat bgr( height, width, CV_8UC3 );
+    for( auto _ : state ){
+        convert_yuy2_to_bgr( source.data(), width * 2, bgr.data, bgr.step, width, height, isa );
+        benchmark::DoNotOptimize( bgr.data );
+    }
+    set_pixels( state );
+}
+BENCHMARK_CAPTURE( yuy2_convert, scalar, instruction_set::scalar );
+BENCHMARK_CAPTURE( yuy2_convert, sse41, instruction_set::sse41 );
+BENCHMARK_CAPTURE( yuy2_convert, avx2, instruction_set::avx2 );
+BENCHMARK_CAPTURE( yuy2_convert, neon, instruction_set::neon );
@@ -0,0 +1,295 @@
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+#include <opencv2/opencv.hpp>
+#include <cubemos/skeleton_tracking.h>
+
+#include "convert.hpp"
+#include "pool.hpp"
+#include "skeleton.hpp"
+#include "renderer.hpp"
+#include "mock.hpp"
+#include "tracker.hpp"
+#include "arena.hpp"
+
+/*
+ This is microbenchmark of hot paths of pipeline other than color converters.
+
+ "image" is CM_Image construction from captured BGRA frame (previous clone/cvtColor path vs single-pass into recycled buffer),
+ "source_pool" is reading frames of mock source while N frames are in flight,
+ "deprojection" is per-joint (window copy, median and deprojection of each joint) vs batched (SoA) deprojection,
+ "tracking" is association of native tracker (hungarian and greedy) over N skeletons,
+ "result_arena" is copy of result into recycled buffer of arena and release of result of backend,
+ and "draw" is overlay drawing of skeletons with 3D positions.
+ "image_pool", "source_pool" and "result_arena" report allocations per iteration after warm-up, and fail if steady state allocates.
+ All benchmarks use synthetic data, so device and license are not required.
+
+ skeleton_bench --benchmark_filter=deprojection --benchmark_format=json --benchmark_out=skeleton_bench.json
+*/
+
+namespace
+{
+    constexpr int32_t width = 1280;
+    constexpr int32_t height = 720;
+    constexpr int32_t window = 3;
+    constexpr float fx = 605.0f;
+    constexpr float fy = 605.0f;
+    constexpr float cx = width * 0.5f;
+    constexpr float cy = height * 0.5f;
+    constexpr float depth_scale = 0.001f;
+
+    // Synthetic Keypoints of Persons
+    skeleton2d create_keypoints( const int32_t persons )
+    {
+        mock_backend backend;
+        CM_SKEL_Buffer buffer = {};
+        mock_backend::generate( &buffer, 0, persons, width, height );
+        for( int32_t i = 0; i < buffer.numSkeletons; i++ ){
+            buffer.skeletons[i].id = i;
+        }
+
+        skeleton2d keypoints;
+        keypoints.assign( &buffer );
+
+        backend.release_buffer( &buffer );
+        return keypoints;
+    }
+
+    // Synthetic Depth Image (Slanted Plane around 2m with Holes)
+    cv::Mat create_depth()
+    {
+        cv::Mat depth( height, width, CV_16UC1 );
+        for( int32_t y = 0; y < height; y++ ){
+            uint16_t* row = depth.ptr<uint16_t>( y );
+            for( int32_t x = 0; x < width; x++ ){
+                row[x] = ( ( x + y ) % 5 == 0 ) ? 0 : static_cast<uint16_t>( 1800 + x / 4 );
+            }
+        }
+        return depth;
+    }
+
+    // Synthetic BGRA Frame
+    cv::Mat create_frame()
+    {
+        cv::Mat frame( height, width, CV_8UC4 );
+        cv::randu( frame, cv::Scalar::all( 0 ), cv::Scalar::all( 255 ) );
+        return frame;
+    }
+
+    // Report Allocations per Iteration after Warm-Up (Steady State must Allocate Nothing)
+    void report_allocations( benchmark::State& state, const uint64_t allocations )
+    {
+        state.counters["allocations"] = benchmark::Counter( static_cast<double>( allocations ), benchmark::Counter::kAvgIterations );
+        if( allocations != 0 ){
+            state.SkipWithError( "buffers are allocated after warm-up!" );
+        }
+    }
+
+    // Wrap Frame into CM_Image
+    CM_Image create_image( const cv::Mat& frame )
+    {
+        return CM_Image{
+            reinterpret_cast<void*>( frame.data ),
+            CM_Datatype::CM_UINT8,
+            frame.cols,
+            frame.rows,
+            frame.channels(),
+            static_cast<int32_t>( frame.step[0] ),
+            CM_MemoryOrder::CM_HWC
+        };
+    }
+}
+
+// CM_Image (Clone, cvtColor into New Image, then Wrap)
+void image_opencv( benchmark::State& state )
+{
+    const cv::Mat bgra = create_frame();
+    for( auto _ : state ){
+        cv::Mat bgr;
+        cv::cvtColor( bgra.clone(), bgr, cv::COLOR_BGRA2BGR );
+        const CM_Image image = create_image( bgr );
+        benchmark::DoNotOptimize( image.data );
+    }
+    state.SetItemsProcessed( state.iterations() * width * height );
+}
+BENCHMARK( image_opencv )->Unit( benchmark::kMicrosecond );
+
+// CM_Image (Single-Pass Conversion into Recycled Buffer, then Wrap)
+void image_pool( benchmark::State& state )
+{
+    const cv::Mat bgra = create_frame();
+    frame_pool pool;
+    pool.acquire( cv::Size( width, height ), CV_8UC3 );
+    const uint64_t preallocations = pool.allocations();
+    for( auto _ : state ){
+        const std::shared_ptr<cv::Mat> bgr = pool.acquire( cv::Size( width, height ), CV_8UC3 );
+        convert_bgra_to_bgr( bgra.data, bgra.step, bgr->data, bgr->step, width, height );
+        const CM_Image image = create_image( *bgr );
+        benchmark::DoNotOptimize( image.data );
+    }
+    state.SetItemsProcessed( state.iterations() * width * height );
+    report_allocations( state, pool.allocations() - preallocations );
+}
+BENCHMARK( image_pool )->Unit( benchmark::kMicrosecond );
+
+// Frames of Source with N Frames in Flight (Frames Held by Inference and Renderer Keep Buffers of Pool)
+void source_pool( benchmark::State& state )
+{
+    const size_t in_flight = static_cast<size_t>( state.range( 0 ) );
+    mock_source source( width, height );
+    std::vector<frame> frames( in_flight );
+
+    // Warm-Up (Pool Grows to Frames in Flight)
+    uint64_t index = 0;
+    for( size_t i = 0; i < 2 * in_flight; i++ ){
+        frame& frame = frames[index++ % in_flight];
+        frame = ::frame();
+        source.read( frame );
+    }
+    const uint64_t preallocations = source.allocations();
+
+    for( auto _ : state ){
+        frame& frame = frames[index++ % in_flight];
+        frame = ::frame();
+        source.read( frame );
+        benchmark::DoNotOptimize( frame.color.data );
+    }
+    report_allocations( state, source.allocations() - preallocations );
+}
+BENCHMARK( source_pool )->Arg( 1 )->Arg( 4 )->Unit( benchmark::kMicrosecond );
+
+// Deprojection (Per-Joint, Previous Path)
+void deprojection_joint( benchmark::State& state )
+{
+    const cv::Mat depth = create_depth();
+    const skeleton2d keypoints = create_keypoints( static_cast<int32_t>( state.range( 0 ) ) );
+    std::vector<cv::Point3f> positions;
+    for( auto _ : state ){
+        positions.clear();
+        for( size_t i = 0; i < keypoints.size(); i++ ){
+            // Copy Non-Zero Depth in Window
+            const cv::Rect roi = cv::Rect( static_cast<int32_t>( keypoints.x[i] ) - window / 2, static_cast<int32_t>( keypoints.y[i] ) - window / 2, window, window ) & cv::Rect( 0, 0, width, height );
+            std::vector<uint16_t> values;
+            for( int32_t y = roi.y; y < roi.y + roi.height; y++ ){
+                for( int32_t x = roi.x; x < roi.x + roi.width; x++ ){
+                    const uint16_t value = depth.at<uint16_t>( y, x );
+                    if( value != 0 ){
+                        values.push_back( value );
+                    }
+                }
+            }
+
+            // Median and Deprojection
+            if( values.empty() ){
+                positions.push_back( cv::Point3f() );
+                continue;
+            }
+            std::nth_element( values.begin(), values.begin() + values.size() / 2, values.end() );
+            const float z = values[values.size() / 2] * depth_scale;
+            positions.push_back( cv::Point3f( ( keypoints.x[i] - cx ) / fx * z, ( keypoints.y[i] - cy ) / fy * z, z ) );
+        }
+        benchmark::DoNotOptimize( positions.data() );
+    }
+    state.SetItemsProcessed( state.iterations() * keypoints.size() );
+}
+BENCHMARK( deprojection_joint )->RangeMultiplier( 4 )->Range( 1, 64 );
+
+// Deprojection (Batched)
+void deprojection_batch( benchmark::State& state )
+{
+    const cv::Mat depth = create_depth();
+    const skeleton2d keypoints = create_keypoints( static_cast<int32_t>( state.range( 0 ) ) );
+    skeleton3d skeleton;
+    for( auto _ : state ){
+        skeleton.reset( keypoints );
+        sample_depth( depth, depth_scale, keypoints, window, skeleton );
+        compute_rays( fx, fy, cx, cy, keypoints, skeleton );
+        deproject_skeleton( skeleton );
+        benchmark::DoNotOptimize( skeleton.z.data() );
+    }
+    state.SetItemsProcessed( state.iterations() * keypoints.size() );
+}
+BENCHMARK( deprojection_batch )->RangeMultiplier( 4 )->Range( 1, 64 );
+
+// Tracking ID Association of Native Tracker over N Skeletons
+void tracking( benchmark::State& state, const tracking_method method )
+{
+    const int32_t persons = static_cast<int32_t>( state.range( 0 ) );
+    mock_backend backend;
+    skeleton_tracker tracker( method, 64 );
+    CM_SKEL_Buffer buffer = {};
+
+    uint64_t index = 0;
+    for( auto _ : state ){
+        // Generate Next Result (Not Measured)
+        state.PauseTiming();
+        backend.release_buffer( &buffer );
+        mock_backend::generate( &buffer, index++, persons, width, height );
+        state.ResumeTiming();
+
+        tracker.update( &buffer );
+        benchmark::DoNotOptimize( buffer.skeletons );
+    }
+    state.SetItemsProcessed( state.iterations() * persons );
+
+    backend.release_buffer( &buffer );
+}
+BENCHMARK_CAPTURE( tracking, hungarian, tracking_method::hungarian )->RangeMultiplier( 4 )->Range( 1, 64 );
+BENCHMARK_CAPTURE( tracking, greedy, tracking_method::greedy )->RangeMultiplier( 4 )->Range( 1, 64 );
+
+// Copy of Result into Arena over N Skeletons
+void result_arena( benchmark::State& state )
+{
+    const int32_t persons = static_cast<int32_t>( state.range( 0 ) );
+    mock_backend backend;
+    skeleton_arena arena;
+    CUBEMOS_SKEL_Buffer_Ptr previous_buffer = arena.acquire();
+    CM_SKEL_Buffer buffer = {};
+    const uint64_t preallocations = arena.allocations();
+
+    uint64_t index = 0;
+    for( auto _ : state ){
+        // Generate Next Result (Not Measured)
+        state.PauseTiming();
+        mock_backend::generate( &buffer, index++, persons, width, height );
+        state.ResumeTiming();
+
+        // Copy and Release Result of Backend (Same as Engine)
+        CUBEMOS_SKEL_Buffer_Ptr latest_buffer = arena.acquire();
+        arena.store( backend, &buffer, latest_buffer.get() );
+        previous_buffer = std::move( latest_buffer );
+        benchmark::DoNotOptimize( previous_buffer->skeletons );
+    }
+    state.SetItemsProcessed( state.iterations() * persons );
+    report_allocations( state, arena.allocations() - preallocations );
+
+    // Result Buffers of Backend (SDK Allocates Skeletons of Each Result, Arena doesn't Remove It)
+    state.counters["backend_allocations"] = benchmark::Counter( static_cast<double>( arena.backend_allocations() ), benchmark::Counter::kAvgIterations );
+}
+BENCHMARK( result_arena )->RangeMultiplier( 4 )->Range( 1, 64 );
+
+// Overlay Drawing (Joints and 3D Positions)
+void draw( benchmark::State& state )
+{
+    const cv::Mat depth = create_depth();
+    const skeleton2d keypoints = create_keypoints( static_cast<int32_t>( state.range( 0 ) ) );
+    skeleton3d skeleton;
+    skeleton.reset( keypoints );
+    sample_depth( depth, depth_scale, keypoints, window, skeleton );
+    compute_rays( fx, fy, cx, cy, keypoints, skeleton );
+    deproject_skeleton( skeleton );
+
+    const cv::Mat frame( height, width, CV_8UC3, cv::Scalar( 64, 64, 64 ) );
+    const std::vector<cv::Scalar> colors = { cv::Scalar( 255, 0, 0 ), cv::Scalar( 0, 255, 0 ), cv::Scalar( 0, 0, 255 ) };
+    cv::Mat image;
+    for( auto _ : state ){
+        frame.copyTo( image );
+        draw_skeleton( image, keypoints, skeleton, colors );
+        benchmark::DoNotOptimize( image.data );
+    }
+    state.SetItemsProcessed( state.iterations() * keypoints.size() );
+}
+BENCHMARK( draw )->RangeMultiplier( 4 )->Range( 1, 16 )->Unit( benchmark::kMicrosecond );
@@ -0,0 +1,116 @@
+#include "capture.hpp"
+
+// Constructor
+threaded_source::threaded_source( ::source& source )
+    : frame_source( source ),
+      running( true ),
+      finished( false )
+{
+    // Start Capture Thread
+    thread = std::thread( &threaded_source::capture, this );
+}
+
+// Destructor
+threaded_source::~threaded_source()
+{
+    // Stop Capture Thread
+    stop();
+}
+
+// Read Newest Frame
+bool threaded_source::read( frame& frame )
+{
+    // Wait for Next Frame
+    bool fetched = false;
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        published.wait( lock, [&]{
+            fetched = frames.fetch();
+            return fetched || finished;
+        } );
+    }
+
+    // Frame Published before End of Stream is Still Returned
+    if( !fetched && !frames.fetch() ){
+        // Rethrow Error of Capture Thread
+        stop();
+        if( error ){
+            std::rethrow_exception( error );
+        }
+        return false;
+    }
+
+    // Take Front Buffer (Reference of Context is Released from Mailbox)
+    ::frame& front = frames.front();
+    frame = std::move( front );
+    front = ::frame();
+
+    return true;
+}
+
+// Deproject 2D Keypoints to 3D Positions in Batch
+bool threaded_source::deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const
+{
+    return frame_source.deproject( frame, keypoints, skeleton );
+}
+
+// Name
+std::string threaded_source::name() const
+{
+    return frame_source.name();
+}
+
+// Number of Dropped Frames
+uint64_t threaded_source::drops() const
+{
+    return frames.drops();
+}
+
+// Capture (Capture Thread)
+void threaded_source::capture()
+{
+    try{
+        while( running ){
+            // Read Frame into Back Buffer
+            frame& frame = frames.back();
+            frame = ::frame();
+            if( !frame_source.read( frame ) ){
+                break;
+            }
+
+            // Stamp Frame at Arrival (Not when Reader Fetches)
+            if( frame.timestamp.count() == 0 ){
+                frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+            }
+
+            // Publish Latest Frame (Stale Frame is Dropped if Reader doesn't Fetch)
+            frames.publish();
+            notify();
+        }
+    }
+    catch( ... ){
+        error = std::current_exception();
+    }
+
+    finished = true;
+    notify();
+}
+
+// Notify Reader (Capture Thread)
+void threaded_source::notify()
+{
+    // Lock before Notify, so Reader never Misses Frame between Check and Wait
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+    }
+    published.notify_one();
+}
+
+// Stop Capture Thread
+void threaded_source::stop()
+{
+    running = false;
+    if( thread.joinable() ){
+        thread.join();
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef __CAPTURE__
+#define __CAPTURE__
+
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <condition_variable>
+
+#include "source.hpp"
+#include "mailbox.hpp"
+#include "skeleton.hpp"
+
+/*
+ This is frame source that reads frames of another source on dedicated capture thread.
+
+ Capture thread keeps reading source (cv::VideoCapture, rs2::pipeline or k4a::device) as fast as source delivers,
+ and publishes each frame into lock-free mailbox (triple buffer) with latest-wins semantics,
+ so driver queue never fills up with stale frames while inference stalls,
+ and read() always returns newest frame that has not been returned yet (reader blocks on condition variable until frame is published).
+ Frames that are overwritten before read() are counted as drops.
+ Capture thread is joined after current read of source returns, so source must not wait for frame indefinitely.
+ Deprojection is forwarded to source (same as capture threads of orchestrator).
+
+ realsense sensor( 0 );
+ threaded_source source( sensor );
+ engine.run( source );
+ std::cout << source.drops() << std::endl;
+*/
+class threaded_source : public source
+{
+private:
+    // Source
+    ::source& frame_source;
+
+    // Capture Thread
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> finished;
+    std::exception_ptr error;
+    mailbox<frame> frames; // latest frame (capture thread -> reader)
+    std::mutex mutex;
+    std::condition_variable published; // notified when frame is published or capture is finished
+
+public:
+    // Constructor (Capture Thread Starts Immediately)
+    threaded_source( ::source& source );
+
+    // Destructor
+    ~threaded_source();
+
+    threaded_source( const threaded_source& ) = delete;
+    threaded_source& operator=( const threaded_source& ) = delete;
+
+    // Read Newest Frame (Wait for Next Frame, Return false at End of Stream)
+    bool read( frame& frame ) override;
+
+    // Deproject 2D Keypoints to 3D Positions in Batch
+    bool deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const override;
+
+    // Name
+    std::string name() const override;
+
+    // Number of Dropped (Overwritten before Read) Frames
+    uint64_t drops() const;
+
+private:
+    // Capture (Capture Thread)
+    void capture();
+
+    // Notify Reader (Capture Thread)
+    void notify();
+
+    // Stop Capture Thread
+    void stop();
+};
+
+#endif // __CAPTURE__
@@ -0,0 +1,64 @@
+#include <algorithm>
+
+#include "clock.hpp"
+
+// Constructor
+clock_mapper::clock_mapper( const std::chrono::nanoseconds window, const size_t capacity )
+    : samples( std::max<size_t>( capacity, 1 ) ),
+      head( 0 ),
+      count( 0 ),
+      window( window ),
+      previous_device_timestamp( 0 )
+{
+}
+
+// Update with Frame and Map Sensor Time to Host Time
+std::chrono::nanoseconds clock_mapper::map( const std::chrono::nanoseconds device_timestamp, const std::chrono::nanoseconds arrival )
+{
+    if( device_timestamp.count() == 0 ){
+        return arrival;
+    }
+
+    // Restart if Sensor Clock Jumps Backward
+    if( device_timestamp < previous_device_timestamp ){
+        reset();
+    }
+    previous_device_timestamp = device_timestamp;
+
+    // Remove Samples that are Not Smaller than New Offset from Tail (They can't be Minimum Any More)
+    const sample latest = { arrival, arrival - device_timestamp };
+    while( count != 0 && latest.offset <= samples[( head + count - 1 ) % samples.size()].offset ){
+        count--;
+    }
+
+    // Remove Samples out of Window (or Oldest Sample if Queue is Full) from Head
+    while( count != 0 && samples[head].arrival < arrival - window ){
+        head = ( head + 1 ) % samples.size();
+        count--;
+    }
+    if( count == samples.size() ){
+        head = ( head + 1 ) % samples.size();
+        count--;
+    }
+
+    // Push New Offset
+    samples[( head + count ) % samples.size()] = latest;
+    count++;
+
+    // Sensor Time on Host Clock (Minimum Offset is Not Larger than Offset of This Frame, so Never Later than Arrival)
+    return device_timestamp + samples[head].offset;
+}
+
+// Estimated Offset of Clocks
+std::chrono::nanoseconds clock_mapper::offset() const
+{
+    return ( count != 0 ) ? samples[head].offset : std::chrono::nanoseconds( 0 );
+}
+
+// Reset Estimate
+void clock_mapper::reset()
+{
+    head = 0;
+    count = 0;
+    previous_device_timestamp = std::chrono::nanoseconds( 0 );
+}
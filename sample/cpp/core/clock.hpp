@@ -0,0 +1,51 @@
+#ifndef __CLOCK__
+#define __CLOCK__
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+
+/*
+ This is clock mapper that converts timestamp of sensor clock (device domain) to host monotonic clock (steady clock).
+
+ Arrival time of frame on host is sensor time + offset of clocks + transport delay (USB, driver, decode),
+ and transport delay is never negative, so offset is estimated by minimum of ( arrival - sensor time ) over sliding window.
+ Minimum is kept in monotonic queue (amortized O(1), preallocated), and window keeps drift of clocks within estimate.
+ Constant part of transport delay is not observable, so mapped sensor time is late by minimum transport delay.
+ Mapped sensor time is never later than arrival time. Mapper restarts if sensor clock jumps backward (device reset or loop of replay).
+
+ clock_mapper mapper;
+ frame.sensor_timestamp = mapper.map( frame.device_timestamp, frame.timestamp ); // sensor time on steady clock
+*/
+class clock_mapper
+{
+private:
+    // Sample of Offset ( Arrival - Sensor Time )
+    struct sample
+    {
+        std::chrono::nanoseconds arrival;
+        std::chrono::nanoseconds offset;
+    };
+
+    // Monotonic Queue (Offsets Increase from Head to Tail, Head is Minimum in Window)
+    std::vector<sample> samples;
+    size_t head;
+    size_t count;
+    std::chrono::nanoseconds window;
+    std::chrono::nanoseconds previous_device_timestamp;
+
+public:
+    // Constructor (Window is Span of Samples that Minimum is Taken over)
+    clock_mapper( const std::chrono::nanoseconds window = std::chrono::seconds( 2 ), const size_t capacity = 256 );
+
+    // Update with Frame and Map Sensor Time to Host Time (Return Arrival if Sensor Time is Not Available)
+    std::chrono::nanoseconds map( const std::chrono::nanoseconds device_timestamp, const std::chrono::nanoseconds arrival );
+
+    // Estimated Offset of Clocks ( Host - Sensor )
+    std::chrono::nanoseconds offset() const;
+
+    // Reset Estimate
+    void reset();
+};
+
+#endif // __CLOCK__
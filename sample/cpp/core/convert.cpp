@@ -0,0 +1,592 @@
+#include "convert.hpp"
+
+#include <algorithm>
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#define CONVERT_X86
+#include <immintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#elif defined( __aarch64__ ) || defined( _M_ARM64 ) || defined( __ARM_NEON )
+#define CONVERT_NEON
+#include <arm_neon.h>
+#endif
+
+// Enable Instruction Set per Function (MSVC doesn't need it)
+#if defined( CONVERT_X86 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define TARGET_SSE41 __attribute__( ( target( "sse4.1" ) ) )
+#define TARGET_AVX2  __attribute__( ( target( "avx2" ) ) )
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#endif
+
+namespace
+{
+    // Fixed-Point BT.601 Coefficients (Same as cv::cvtColor)
+    constexpr int32_t SHIFT = 20;
+    constexpr int32_t HALF = 1 << ( SHIFT - 1 );
+    constexpr int32_t CY  =  1220542; // 1.164
+    constexpr int32_t CUB =  2116026; // 2.018
+    constexpr int32_t CUG =  -409993; // -0.391
+    constexpr int32_t CVG =  -852492; // -0.813
+    constexpr int32_t CVR =  1673527; // 1.596
+
+    inline uint8_t saturate( const int32_t value )
+    {
+        return static_cast<uint8_t>( std::min( std::max( value, 0 ), 255 ) );
+    }
+
+    // Convert Pair of Pixels that Share Chroma
+    inline void yuv_to_bgr( const int32_t y0, const int32_t y1, int32_t u, int32_t v, uint8_t* dst )
+    {
+        u -= 128;
+        v -= 128;
+        const int32_t ruv = HALF + CVR * v;
+        const int32_t guv = HALF + CVG * v + CUG * u;
+        const int32_t buv = HALF + CUB * u;
+
+        const int32_t yy0 = std::max( 0, y0 - 16 ) * CY;
+        dst[0] = saturate( ( yy0 + buv ) >> SHIFT );
+        dst[1] = saturate( ( yy0 + guv ) >> SHIFT );
+        dst[2] = saturate( ( yy0 + ruv ) >> SHIFT );
+
+        const int32_t yy1 = std::max( 0, y1 - 16 ) * CY;
+        dst[3] = saturate( ( yy1 + buv ) >> SHIFT );
+        dst[4] = saturate( ( yy1 + guv ) >> SHIFT );
+        dst[5] = saturate( ( yy1 + ruv ) >> SHIFT );
+    }
+
+    // Scalar (Also Used for Remaining Pixels of SIMD)
+    void bgra_to_bgr_row_scalar( const uint8_t* src, uint8_t* dst, const int32_t begin, const int32_t end )
+    {
+        for( int32_t x = begin; x < end; x++ ){
+            dst[x * 3 + 0] = src[x * 4 + 0];
+            dst[x * 3 + 1] = src[x * 4 + 1];
+            dst[x * 3 + 2] = src[x * 4 + 2];
+        }
+    }
+
+    void nv12_to_bgr_row_scalar( const uint8_t* y, const uint8_t* uv, uint8_t* dst, const int32_t begin, const int32_t end )
+    {
+        for( int32_t x = begin; x < end; x += 2 ){
+            const int32_t y1 = ( x + 1 < end ) ? y[x + 1] : y[x];
+            uint8_t pixels[6];
+            yuv_to_bgr( y[x], y1, uv[x], uv[x + 1], pixels );
+            std::copy( pixels, pixels + ( ( x + 1 < end ) ? 6 : 3 ), dst + x * 3 );
+        }
+    }
+
+    void yuy2_to_bgr_row_scalar( const uint8_t* src, uint8_t* dst, const int32_t begin, const int32_t end )
+    {
+        for( int32_t x = begin; x < end; x += 2 ){
+            const uint8_t* yuyv = src + x * 2;
+            uint8_t pixels[6];
+            yuv_to_bgr( yuyv[0], yuyv[2], yuyv[1], yuyv[3], pixels );
+            std::copy( pixels, pixels + ( ( x + 1 < end ) ? 6 : 3 ), dst + x * 3 );
+        }
+    }
+
+#if defined( CONVERT_X86 )
+    // Interleave 16 Pixels of B, G, R Planes into Packed BGR (48 bytes)
+    TARGET_SSE41 inline void store_bgr_sse41( uint8_t* dst, const __m128i b, const __m128i g, const __m128i r )
+    {
+        const __m128i b0 = _mm_setr_epi8(  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1,  5 );
+        const __m128i g0 = _mm_setr_epi8( -1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1 );
+        const __m128i r0 = _mm_setr_epi8( -1, -1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1 );
+        const __m128i b1 = _mm_setr_epi8( -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10, -1 );
+        const __m128i g1 = _mm_setr_epi8(  5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10 );
+        const __m128i r1 = _mm_setr_epi8( -1,  5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1 );
+        const __m128i b2 = _mm_setr_epi8( -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1 );
+        const __m128i g2 = _mm_setr_epi8( -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1 );
+        const __m128i r2 = _mm_setr_epi8( 10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15 );
+
+        const __m128i out0 = _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( b, b0 ), _mm_shuffle_epi8( g, g0 ) ), _mm_shuffle_epi8( r, r0 ) );
+        const __m128i out1 = _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( b, b1 ), _mm_shuffle_epi8( g, g1 ) ), _mm_shuffle_epi8( r, r1 ) );
+        const __m128i out2 = _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( b, b2 ), _mm_shuffle_epi8( g, g2 ) ), _mm_shuffle_epi8( r, r2 ) );
+
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( dst +  0 ), out0 );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + 16 ), out1 );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + 32 ), out2 );
+    }
+
+    // Compute 16 Pixels of One Channel ( ( y + chroma ) >> SHIFT )
+    TARGET_SSE41 inline __m128i channel_sse41( const __m128i y[4], const __m128i c_lo, const __m128i c_hi )
+    {
+        // Duplicate Chroma for Pair of Pixels
+        const __m128i v0 = _mm_srai_epi32( _mm_add_epi32( y[0], _mm_unpacklo_epi32( c_lo, c_lo ) ), SHIFT );
+        const __m128i v1 = _mm_srai_epi32( _mm_add_epi32( y[1], _mm_unpackhi_epi32( c_lo, c_lo ) ), SHIFT );
+        const __m128i v2 = _mm_srai_epi32( _mm_add_epi32( y[2], _mm_unpacklo_epi32( c_hi, c_hi ) ), SHIFT );
+        const __m128i v3 = _mm_srai_epi32( _mm_add_epi32( y[3], _mm_unpackhi_epi32( c_hi, c_hi ) ), SHIFT );
+        return _mm_packus_epi16( _mm_packs_epi32( v0, v1 ), _mm_packs_epi32( v2, v3 ) );
+    }
+
+    // Convert 16 Pixels ( y: 16 bytes, uv: u0-u7 in low 8 bytes, v0-v7 in high 8 bytes )
+    TARGET_SSE41 inline void yuv16_to_bgr_sse41( const __m128i y, const __m128i uv, uint8_t* dst )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i c16 = _mm_set1_epi32( 16 );
+        const __m128i c128 = _mm_set1_epi32( 128 );
+        const __m128i cy = _mm_set1_epi32( CY );
+        const __m128i half = _mm_set1_epi32( HALF );
+
+        // Luma ( max( 0, y - 16 ) * CY )
+        __m128i yy[4];
+        yy[0] = _mm_cvtepu8_epi32( y );
+        yy[1] = _mm_cvtepu8_epi32( _mm_srli_si128( y, 4 ) );
+        yy[2] = _mm_cvtepu8_epi32( _mm_srli_si128( y, 8 ) );
+        yy[3] = _mm_cvtepu8_epi32( _mm_srli_si128( y, 12 ) );
+        for( int32_t i = 0; i < 4; i++ ){
+            yy[i] = _mm_mullo_epi32( _mm_max_epi32( _mm_sub_epi32( yy[i], c16 ), zero ), cy );
+        }
+
+        // Chroma ( u - 128, v - 128 )
+        const __m128i u_lo = _mm_sub_epi32( _mm_cvtepu8_epi32( uv ), c128 );
+        const __m128i u_hi = _mm_sub_epi32( _mm_cvtepu8_epi32( _mm_srli_si128( uv, 4 ) ), c128 );
+        const __m128i v_lo = _mm_sub_epi32( _mm_cvtepu8_epi32( _mm_srli_si128( uv, 8 ) ), c128 );
+        const __m128i v_hi = _mm_sub_epi32( _mm_cvtepu8_epi32( _mm_srli_si128( uv, 12 ) ), c128 );
+
+        const __m128i ruv_lo = _mm_add_epi32( half, _mm_mullo_epi32( v_lo, _mm_set1_epi32( CVR ) ) );
+        const __m128i ruv_hi = _mm_add_epi32( half, _mm_mullo_epi32( v_hi, _mm_set1_epi32( CVR ) ) );
+        const __m128i guv_lo = _mm_add_epi32( half, _mm_add_epi32( _mm_mullo_epi32( v_lo, _mm_set1_epi32( CVG ) ), _mm_mullo_epi32( u_lo, _mm_set1_epi32( CUG ) ) ) );
+        const __m128i guv_hi = _mm_add_epi32( half, _mm_add_epi32( _mm_mullo_epi32( v_hi, _mm_set1_epi32( CVG ) ), _mm_mullo_epi32( u_hi, _mm_set1_epi32( CUG ) ) ) );
+        const __m128i buv_lo = _mm_add_epi32( half, _mm_mullo_epi32( u_lo, _mm_set1_epi32( CUB ) ) );
+        const __m128i buv_hi = _mm_add_epi32( half, _mm_mullo_epi32( u_hi, _mm_set1_epi32( CUB ) ) );
+
+        store_bgr_sse41( dst, channel_sse41( yy, buv_lo, buv_hi ), channel_sse41( yy, guv_lo, guv_hi ), channel_sse41( yy, ruv_lo, ruv_hi ) );
+    }
+
+    // SSE4.1
+    TARGET_SSE41 void bgra_to_bgr_row_sse41( const uint8_t* src, uint8_t* dst, const int32_t width )
+    {
+        const __m128i mask = _mm_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+
+        int32_t x = 0;
+        for( ; x + 16 <= width; x += 16 ){
+            const __m128i a = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 4 +  0 ) ), mask );
+            const __m128i b = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 4 + 16 ) ), mask );
+            const __m128i c = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 4 + 32 ) ), mask );
+            const __m128i d = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 4 + 48 ) ), mask );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * 3 +  0 ), _mm_or_si128( a, _mm_slli_si128( b, 12 ) ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * 3 + 16 ), _mm_or_si128( _mm_srli_si128( b, 4 ), _mm_slli_si128( c, 8 ) ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * 3 + 32 ), _mm_or_si128( _mm_srli_si128( c, 8 ), _mm_slli_si128( d, 4 ) ) );
+        }
+
+        bgra_to_bgr_row_scalar( src, dst, x, width );
+    }
+
+    TARGET_SSE41 void nv12_to_bgr_row_sse41( const uint8_t* y, const uint8_t* uv, uint8_t* dst, const int32_t width )
+    {
+        // Deinterleave u0 v0 u1 v1 ... into u0-u7, v0-v7
+        const __m128i mask = _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15 );
+
+        int32_t x = 0;
+        for( ; x + 16 <= width; x += 16 ){
+            const __m128i y16 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( y + x ) );
+            const __m128i uv16 = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( uv + x ) ), mask );
+            yuv16_to_bgr_sse41( y16, uv16, dst + x * 3 );
+        }
+
+        nv12_to_bgr_row_scalar( y, uv, dst, x, width );
+    }
+
+    TARGET_SSE41 void yuy2_to_bgr_row_sse41( const uint8_t* src, uint8_t* dst, const int32_t width )
+    {
+        // Deinterleave y0 u0 y1 v0 ... into y0-y7, u0-u3, v0-v3
+        const __m128i mask = _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15 );
+
+        int32_t x = 0;
+        for( ; x + 16 <= width; x += 16 ){
+            const __m128i a = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 2 +  0 ) ), mask );
+            const __m128i b = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 2 + 16 ) ), mask );
+            const __m128i y16 = _mm_unpacklo_epi64( a, b );
+            const __m128i uv16 = _mm_unpackhi_epi32( a, b ); // u0-u3 u4-u7 v0-v3 v4-v7
+            yuv16_to_bgr_sse41( y16, uv16, dst + x * 3 );
+        }
+
+        yuy2_to_bgr_row_scalar( src, dst, x, width );
+    }
+
+    // AVX2
+    TARGET_AVX2 void bgra_to_bgr_row_avx2( const uint8_t* src, uint8_t* dst, const int32_t width )
+    {
+        const __m256i mask = _mm256_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                               0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+        const __m256i compact = _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 3, 7 );
+
+        int32_t x = 0;
+        for( ; x + 8 <= width; x += 8 ){
+            // 8 Pixels (32 bytes) into 24 bytes
+            const __m256i bgra = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + x * 4 ) );
+            const __m256i bgr = _mm256_permutevar8x32_epi32( _mm256_shuffle_epi8( bgra, mask ), compact );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * 3 ), _mm256_castsi256_si128( bgr ) );
+            _mm_storel_epi64( reinterpret_cast<__m128i*>( dst + x * 3 + 16 ), _mm256_extracti128_si256( bgr, 1 ) );
+        }
+
+        bgra_to_bgr_row_scalar( src, dst, x, width );
+    }
+
+    // Compute 32 Pixels of One Channel ( ( y + chroma ) >> SHIFT )
+    TARGET_AVX2 inline __m256i channel_avx2( const __m256i y[4], const __m256i c_lo, const __m256i c_hi )
+    {
+        // Duplicate Chroma for Pair of Pixels
+        const __m256i dup_lo = _mm256_setr_epi32( 0, 0, 1, 1, 2, 2, 3, 3 );
+        const __m256i dup_hi = _mm256_setr_epi32( 4, 4, 5, 5, 6, 6, 7, 7 );
+        const __m256i v0 = _mm256_srai_epi32( _mm256_add_epi32( y[0], _mm256_permutevar8x32_epi32( c_lo, dup_lo ) ), SHIFT );
+        const __m256i v1 = _mm256_srai_epi32( _mm256_add_epi32( y[1], _mm256_permutevar8x32_epi32( c_lo, dup_hi ) ), SHIFT );
+        const __m256i v2 = _mm256_srai_epi32( _mm256_add_epi32( y[2], _mm256_permutevar8x32_epi32( c_hi, dup_lo ) ), SHIFT );
+        const __m256i v3 = _mm256_srai_epi32( _mm256_add_epi32( y[3], _mm256_permutevar8x32_epi32( c_hi, dup_hi ) ), SHIFT );
+
+        // Pack within Lanes, then Restore Order of Lanes
+        const __m256i v01 = _mm256_permute4x64_epi64( _mm256_packs_epi32( v0, v1 ), 0xD8 );
+        const __m256i v23 = _mm256_permute4x64_epi64( _mm256_packs_epi32( v2, v3 ), 0xD8 );
+        return _mm256_permute4x64_epi64( _mm256_packus_epi16( v01, v23 ), 0xD8 );
+    }
+
+    // Convert 32 Pixels ( y: 32 bytes, u: 16 bytes, v: 16 bytes )
+    TARGET_AVX2 inline void yuv32_to_bgr_avx2( const __m256i y, const __m128i u, const __m128i v, uint8_t* dst )
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i c16 = _mm256_set1_epi32( 16 );
+        const __m256i c128 = _mm256_set1_epi32( 128 );
+        const __m256i cy = _mm256_set1_epi32( CY );
+        const __m256i half = _mm256_set1_epi32( HALF );
+
+        // Luma ( max( 0, y - 16 ) * CY )
+        const __m128i y_lo = _mm256_castsi256_si128( y );
+        const __m128i y_hi = _mm256_extracti128_si256( y, 1 );
+        __m256i yy[4];
+        yy[0] = _mm256_cvtepu8_epi32( y_lo );
+        yy[1] = _mm256_cvtepu8_epi32( _mm_srli_si128( y_lo, 8 ) );
+        yy[2] = _mm256_cvtepu8_epi32( y_hi );
+        yy[3] = _mm256_cvtepu8_epi32( _mm_srli_si128( y_hi, 8 ) );
+        for( int32_t i = 0; i < 4; i++ ){
+            yy[i] = _mm256_mullo_epi32( _mm256_max_epi32( _mm256_sub_epi32( yy[i], c16 ), zero ), cy );
+        }
+
+        // Chroma ( u - 128, v - 128 )
+        const __m256i u_lo = _mm256_sub_epi32( _mm256_cvtepu8_epi32( u ), c128 );
+        const __m256i u_hi = _mm256_sub_epi32( _mm256_cvtepu8_epi32( _mm_srli_si128( u, 8 ) ), c128 );
+        const __m256i v_lo = _mm256_sub_epi32( _mm256_cvtepu8_epi32( v ), c128 );
+        const __m256i v_hi = _mm256_sub_epi32( _mm256_cvtepu8_epi32( _mm_srli_si128( v, 8 ) ), c128 );
+
+        const __m256i ruv_lo = _mm256_add_epi32( half, _mm256_mullo_epi32( v_lo, _mm256_set1_epi32( CVR ) ) );
+        const __m256i ruv_hi = _mm256_add_epi32( half, _mm256_mullo_epi32( v_hi, _mm256_set1_epi32( CVR ) ) );
+        const __m256i guv_lo = _mm256_add_epi32( half, _mm256_add_epi32( _mm256_mullo_epi32( v_lo, _mm256_set1_epi32( CVG ) ), _mm256_mullo_epi32( u_lo, _mm256_set1_epi32( CUG ) ) ) );
+        const __m256i guv_hi = _mm256_add_epi32( half, _mm256_add_epi32( _mm256_mullo_epi32( v_hi, _mm256_set1_epi32( CVG ) ), _mm256_mullo_epi32( u_hi, _mm256_set1_epi32( CUG ) ) ) );
+        const __m256i buv_lo = _mm256_add_epi32( half, _mm256_mullo_epi32( u_lo, _mm256_set1_epi32( CUB ) ) );
+        const __m256i buv_hi = _mm256_add_epi32( half, _mm256_mullo_epi32( u_hi, _mm256_set1_epi32( CUB ) ) );
+
+        const __m256i b = channel_avx2( yy, buv_lo, buv_hi );
+        const __m256i g = channel_avx2( yy, guv_lo, guv_hi );
+        const __m256i r = channel_avx2( yy, ruv_lo, ruv_hi );
+
+        // Interleave
+        store_bgr_sse41( dst +  0, _mm256_castsi256_si128( b ), _mm256_castsi256_si128( g ), _mm256_castsi256_si128( r ) );
+        store_bgr_sse41( dst + 48, _mm256_extracti128_si256( b, 1 ), _mm256_extracti128_si256( g, 1 ), _mm256_extracti128_si256( r, 1 ) );
+    }
+
+    TARGET_AVX2 void nv12_to_bgr_row_avx2( const uint8_t* y, const uint8_t* uv, uint8_t* dst, const int32_t width )
+    {
+        // Deinterleave u0 v0 u1 v1 ... into u0-u7, v0-v7 (per 16 bytes)
+        const __m128i mask = _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15 );
+
+        int32_t x = 0;
+        for( ; x + 32 <= width; x += 32 ){
+            const __m256i y32 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( y + x ) );
+            const __m128i a = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( uv + x +  0 ) ), mask );
+            const __m128i b = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( uv + x + 16 ) ), mask );
+            yuv32_to_bgr_avx2( y32, _mm_unpacklo_epi64( a, b ), _mm_unpackhi_epi64( a, b ), dst + x * 3 );
+        }
+
+        nv12_to_bgr_row_sse41( y + x, uv + x, dst + x * 3, width - x );
+    }
+
+    TARGET_AVX2 void yuy2_to_bgr_row_avx2( const uint8_t* src, uint8_t* dst, const int32_t width )
+    {
+        // Deinterleave y0 u0 y1 v0 ... into y0-y7, u0-u3, v0-v3 (per 16 bytes)
+        const __m128i mask = _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15 );
+
+        int32_t x = 0;
+        for( ; x + 32 <= width; x += 32 ){
+            __m128i p[4];
+            for( int32_t i = 0; i < 4; i++ ){
+                p[i] = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 2 + i * 16 ) ), mask );
+            }
+
+            // y: p0.y p1.y p2.y p3.y, u: p0.u p1.u p2.u p3.u, v: p0.v p1.v p2.v p3.v
+            const __m256i y32 = _mm256_setr_m128i( _mm_unpacklo_epi64( p[0], p[1] ), _mm_unpacklo_epi64( p[2], p[3] ) );
+            const __m128i uv01 = _mm_unpackhi_epi32( p[0], p[1] ); // u0-3 u4-7 v0-3 v4-7
+            const __m128i uv23 = _mm_unpackhi_epi32( p[2], p[3] ); // u8-11 u12-15 v8-11 v12-15
+            yuv32_to_bgr_avx2( y32, _mm_unpacklo_epi64( uv01, uv23 ), _mm_unpackhi_epi64( uv01, uv23 ), dst + x * 3 );
+        }
+
+        yuy2_to_bgr_row_sse41( src + x * 2, dst + x * 3, width - x );
+    }
+#endif
+
+#if defined( CONVERT_NEON )
+    // Compute 8 Pixels of One Channel ( ( y + chroma ) >> SHIFT )
+    inline uint8x8_t channel_neon( const int32x4_t y_lo, const int32x4_t y_hi, const int32x4_t c_lo, const int32x4_t c_hi )
+    {
+        const int32x4_t lo = vshrq_n_s32( vaddq_s32( y_lo, c_lo ), SHIFT );
+        const int32x4_t hi = vshrq_n_s32( vaddq_s32( y_hi, c_hi ), SHIFT );
+        return vqmovun_s16( vcombine_s16( vqmovn_s32( lo ), vqmovn_s32( hi ) ) );
+    }
+
+    // Luma ( max( 0, y - 16 ) * CY )
+    inline void luma_neon( const uint8x8_t y, int32x4_t& y_lo, int32x4_t& y_hi )
+    {
+        const int16x8_t y16 = vreinterpretq_s16_u16( vmovl_u8( y ) );
+        y_lo = vmulq_n_s32( vmaxq_s32( vsubq_s32( vmovl_s16( vget_low_s16( y16 ) ), vdupq_n_s32( 16 ) ), vdupq_n_s32( 0 ) ), CY );
+        y_hi = vmulq_n_s32( vmaxq_s32( vsubq_s32( vmovl_s16( vget_high_s16( y16 ) ), vdupq_n_s32( 16 ) ), vdupq_n_s32( 0 ) ), CY );
+    }
+
+    // Convert 16 Pixels ( y_even: y0 y2 ..., y_odd: y1 y3 ..., u: 8 bytes, v: 8 bytes )
+    inline void yuv16_to_bgr_neon( const uint8x8_t y_even, const uint8x8_t y_odd, const uint8x8_t u, const uint8x8_t v, uint8_t* dst )
+    {
+        int32x4_t ye_lo, ye_hi, yo_lo, yo_hi;
+        luma_neon( y_even, ye_lo, ye_hi );
+        luma_neon( y_odd, yo_lo, yo_hi );
+
+        const int16x8_t u16 = vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( u ) ), vdupq_n_s16( 128 ) );
+        const int16x8_t v16 = vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( v ) ), vdupq_n_s16( 128 ) );
+        const int32x4_t u_lo = vmovl_s16( vget_low_s16( u16 ) );
+        const int32x4_t u_hi = vmovl_s16( vget_high_s16( u16 ) );
+        const int32x4_t v_lo = vmovl_s16( vget_low_s16( v16 ) );
+        const int32x4_t v_hi = vmovl_s16( vget_high_s16( v16 ) );
+
+        const int32x4_t half = vdupq_n_s32( HALF );
+        const int32x4_t ruv_lo = vmlaq_n_s32( half, v_lo, CVR );
+        const int32x4_t ruv_hi = vmlaq_n_s32( half, v_hi, CVR );
+        const int32x4_t guv_lo = vmlaq_n_s32( vmlaq_n_s32( half, v_lo, CVG ), u_lo, CUG );
+        const int32x4_t guv_hi = vmlaq_n_s32( vmlaq_n_s32( half, v_hi, CVG ), u_hi, CUG );
+        const int32x4_t buv_lo = vmlaq_n_s32( half, u_lo, CUB );
+        const int32x4_t buv_hi = vmlaq_n_s32( half, u_hi, CUB );
+
+        // Even and Odd Pixels Share Chroma, then Zip
+        const uint8x8x2_t b = vzip_u8( channel_neon( ye_lo, ye_hi, buv_lo, buv_hi ), channel_neon( yo_lo, yo_hi, buv_lo, buv_hi ) );
+        const uint8x8x2_t g = vzip_u8( channel_neon( ye_lo, ye_hi, guv_lo, guv_hi ), channel_neon( yo_lo, yo_hi, guv_lo, guv_hi ) );
+        const uint8x8x2_t r = vzip_u8( channel_neon( ye_lo, ye_hi, ruv_lo, ruv_hi ), channel_neon( yo_lo, yo_hi, ruv_lo, ruv_hi ) );
+
+        uint8x16x3_t bgr;
+        bgr.val[0] = vcombine_u8( b.val[0], b.val[1] );
+        bgr.val[1] = vcombine_u8( g.val[0], g.val[1] );
+        bgr.val[2] = vcombine_u8( r.val[0], r.val[1] );
+        vst3q_u8( dst, bgr );
+    }
+
+    void bgra_to_bgr_row_neon( const uint8_t* src, uint8_t* dst, const int32_t width )
+    {
+        int32_t x = 0;
+        for( ; x + 16 <= width; x += 16 ){
+            const uint8x16x4_t bgra = vld4q_u8( src + x * 4 );
+            uint8x16x3_t bgr;
+            bgr.val[0] = bgra.val[0];
+            bgr.val[1] = bgra.val[1];
+            bgr.val[2] = bgra.val[2];
+            vst3q_u8( dst + x * 3, bgr );
+        }
+
+        bgra_to_bgr_row_scalar( src, dst, x, width );
+    }
+
+    void nv12_to_bgr_row_neon( const uint8_t* y, const uint8_t* uv, uint8_t* dst, const int32_t width )
+    {
+        int32_t x = 0;
+        for( ; x + 16 <= width; x += 16 ){
+            const uint8x8x2_t yy = vld2_u8( y + x );
+            const uint8x8x2_t uuvv = vld2_u8( uv + x );
+            yuv16_to_bgr_neon( yy.val[0], yy.val[1], uuvv.val[0], uuvv.val[1], dst + x * 3 );
+        }
+
+        nv12_to_bgr_row_scalar( y, uv, dst, x, width );
+    }
+
+    void yuy2_to_bgr_row_neon( const uint8_t* src, uint8_t* dst, const int32_t width )
+    {
+        int32_t x = 0;
+        for( ; x + 16 <= width; x += 16 ){
+            const uint8x8x4_t yuyv = vld4_u8( src + x * 2 );
+            yuv16_to_bgr_neon( yuyv.val[0], yuyv.val[2], yuyv.val[1], yuyv.val[3], dst + x * 3 );
+        }
+
+        yuy2_to_bgr_row_scalar( src, dst, x, width );
+    }
+#endif
+
+    // Resolve Automatic Instruction Set, and Fallback if Not Available
+    instruction_set resolve( const instruction_set isa )
+    {
+        if( isa == instruction_set::automatic || !is_instruction_set_available( isa ) ){
+            return detect_instruction_set();
+        }
+        return isa;
+    }
+}
+
+// Detect Best Available Instruction Set
+instruction_set detect_instruction_set()
+{
+    static const instruction_set best = [](){
+#if defined( CONVERT_X86 )
+        if( is_instruction_set_available( instruction_set::avx2 ) ){
+            return instruction_set::avx2;
+        }
+        if( is_instruction_set_available( instruction_set::sse41 ) ){
+            return instruction_set::sse41;
+        }
+#elif defined( CONVERT_NEON )
+        return instruction_set::neon;
+#endif
+        return instruction_set::scalar;
+    }();
+
+    return best;
+}
+
+// Check Instruction Set is Available
+bool is_instruction_set_available( const instruction_set isa )
+{
+    switch( isa ){
+        case instruction_set::automatic:
+        case instruction_set::scalar:
+            return true;
+#if defined( CONVERT_X86 )
+#if defined( _MSC_VER ) && !defined( __clang__ )
+        case instruction_set::sse41:
+        {
+            int32_t info[4];
+            __cpuid( info, 1 );
+            return ( info[2] & ( 1 << 19 ) ) != 0;
+        }
+        case instruction_set::avx2:
+        {
+            int32_t info[4];
+            __cpuid( info, 1 );
+            const bool os_avx = ( info[2] & ( 1 << 27 ) ) != 0 && ( _xgetbv( 0 ) & 0x6 ) == 0x6;
+            __cpuidex( info, 7, 0 );
+            return os_avx && ( info[1] & ( 1 << 5 ) ) != 0;
+        }
+#else
+        case instruction_set::sse41:
+            return __builtin_cpu_supports( "sse4.1" );
+        case instruction_set::avx2:
+            return __builtin_cpu_supports( "avx2" );
+#endif
+#endif
+#if defined( CONVERT_NEON )
+        case instruction_set::neon:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+// Name of Instruction Set
+const char* get_instruction_set_name( const instruction_set isa )
+{
+    switch( isa ){
+        case instruction_set::automatic:
+            return get_instruction_set_name( detect_instruction_set() );
+        case instruction_set::scalar:
+            return "scalar";
+        case instruction_set::sse41:
+            return "sse4.1";
+        case instruction_set::avx2:
+            return "avx2";
+        case instruction_set::neon:
+            return "neon";
+        default:
+            return "unknown";
+    }
+}
+
+// Convert BGRA to BGR
+void convert_bgra_to_bgr( const uint8_t* src, const size_t src_stride, uint8_t* dst, const size_t dst_stride, const int32_t width, const int32_t height, const instruction_set isa )
+{
+    const instruction_set target = resolve( isa );
+    for( int32_t y = 0; y < height; y++ ){
+        const uint8_t* src_row = src + y * src_stride;
+        uint8_t* dst_row = dst + y * dst_stride;
+        switch( target ){
+#if defined( CONVERT_X86 )
+            case instruction_set::avx2:
+                bgra_to_bgr_row_avx2( src_row, dst_row, width );
+                break;
+            case instruction_set::sse41:
+                bgra_to_bgr_row_sse41( src_row, dst_row, width );
+                break;
+#endif
+#if defined( CONVERT_NEON )
+            case instruction_set::neon:
+                bgra_to_bgr_row_neon( src_row, dst_row, width );
+                break;
+#endif
+            default:
+                bgra_to_bgr_row_scalar( src_row, dst_row, 0, width );
+                break;
+        }
+    }
+}
+
+// Convert NV12 (Y Plane and Interleaved UV Plane) to BGR
+void convert_nv12_to_bgr( const uint8_t* src_y, const size_t src_y_stride, const uint8_t* src_uv, const size_t src_uv_stride, uint8_t* dst, const size_t dst_stride, const int32_t width, const int32_t height, const instruction_set isa )
+{
+    const instruction_set target = resolve( isa );
+    for( int32_t y = 0; y < height; y++ ){
+        // UV Plane is Shared by Two Rows
+        const uint8_t* y_row = src_y + y * src_y_stride;
+        const uint8_t* uv_row = src_uv + ( y / 2 ) * src_uv_stride;
+        uint8_t* dst_row = dst + y * dst_stride;
+        switch( target ){
+#if defined( CONVERT_X86 )
+            case instruction_set::avx2:
+                nv12_to_bgr_row_avx2( y_row, uv_row, dst_row, width );
+                break;
+            case instruction_set::sse41:
+                nv12_to_bgr_row_sse41( y_row, uv_row, dst_row, width );
+                break;
+#endif
+#if defined( CONVERT_NEON )
+            case instruction_set::neon:
+                nv12_to_bgr_row_neon( y_row, uv_row, dst_row, width );
+                break;
+#endif
+            default:
+                nv12_to_bgr_row_scalar( y_row, uv_row, dst_row, 0, width );
+                break;
+        }
+    }
+}
+
+// Convert YUY2 (Y0 U0 Y1 V0) to BGR
+void convert_yuy2_to_bgr( const uint8_t* src, const size_t src_stride, uint8_t* dst, const size_t dst_stride, const int32_t width, const int32_t height, const instruction_set isa )
+{
+    const instruction_set target = resolve( isa );
+    for( int32_t y = 0; y < height; y++ ){
+        const uint8_t* src_row = src + y * src_stride;
+        uint8_t* dst_row = dst + y * dst_stride;
+        switch( target ){
+#if defined( CONVERT_X86 )
+            case instruction_set::avx2:
+                yuy2_to_bgr_row_avx2( src_row, dst_row, width );
+                break;
+            case instruction_set::sse41:
+                yuy2_to_bgr_row_sse41( src_row, dst_row, width );
+                break;
+#endif
+#if defined( CONVERT_NEON )
+            case instruction_set::neon:
+                yuy2_to_bgr_row_neon( src_row, dst_row, width );
+                break;
+#endif
+            default:
+                yuy2_to_bgr_row_scalar( src_row, dst_row, 0, width );
+                break;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef __CONVERT__
+#define __CONVERT__
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ This is single-pass color converters into packed BGR (CM_HWC, CM_UINT8) that is input of inference.
+
+ Each converter is vectorized with SSE4.1/AVX2 (x86) or NEON (ARM),
+ and the best instruction set is selected at runtime.
+ YUV converters use same fixed-point BT.601 coefficients as cv::cvtColor,
+ so results are identical to cv::COLOR_YUV2BGR_NV12/cv::COLOR_YUV2BGR_YUY2.
+
+ convert_bgra_to_bgr( bgra, width * 4, bgr, width * 3, width, height );
+ convert_nv12_to_bgr( y, width, y + width * height, width, bgr, width * 3, width, height );
+*/
+
+// Instruction Set
+enum class instruction_set
+{
+    automatic, // best available instruction set
+    scalar,
+    sse41,
+    avx2,
+    neon
+};
+
+// Detect Best Available Instruction Set
+instruction_set detect_instruction_set();
+
+// Check Instruction Set is Available
+bool is_instruction_set_available( const instruction_set isa );
+
+// Name of Instruction Set
+const char* get_instruction_set_name( const instruction_set isa );
+
+// Convert BGRA to BGR
+void convert_bgra_to_bgr( const uint8_t* src, const size_t src_stride, uint8_t* dst, const size_t dst_stride, const int32_t width, const int32_t height, const instruction_set isa = instruction_set::automatic );
+
+// Convert NV12 (Y Plane and Interleaved UV Plane) to BGR
+void convert_nv12_to_bgr( const uint8_t* src_y, const size_t src_y_stride, const uint8_t* src_uv, const size_t src_uv_stride, uint8_t* dst, const size_t dst_stride, const int32_t width, const int32_t height, const instruction_set isa = instruction_set::automatic );
+
+// Convert YUY2 (Y0 U0 Y1 V0) to BGR
+void convert_yuy2_to_bgr( const uint8_t* src, const size_t src_stride, uint8_t* dst, const size_t dst_stride, const int32_t width, const int32_t height, const instruction_set isa = instruction_set::automatic );
+
+#endif // __CONVERT__
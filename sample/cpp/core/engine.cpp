@@ -0,0 +1,526 @@
+#include "engine.hpp"
+#include "interrupt.hpp"
+#include "profiler.hpp"
+
+#include <chrono>
+#include <string>
+
+// Check Stop Condition
+bool is_stopped( const limit& limit, const uint64_t frames, const std::chrono::steady_clock::time_point start )
+{
+    // Interrupted by SIGINT/SIGTERM
+    if( is_interrupted() ){
+        return true;
+    }
+
+    // Frame Count
+    if( 0 < limit.frames && limit.frames <= frames ){
+        return true;
+    }
+
+    // Duration
+    if( std::chrono::milliseconds( 0 ) < limit.duration && limit.duration <= std::chrono::steady_clock::now() - start ){
+        return true;
+    }
+
+    return false;
+}
+
+// Constructor
+engine::engine( std::unique_ptr<backend> backend, const size_t inference_depth, const int32_t inference_size )
+    : inference_backend( std::move( backend ) ),
+      inference_depth( inference_depth ),
+      inference_size( inference_size ),
+      buffer( create_skel_buffer( *inference_backend ) ),
+      arena( 2 ),
+      previous_buffer( arena.acquire() ),
+      result( CM_ReturnCode::CM_ERROR ),
+      deprojected( false ),
+      skip_interval( 1 ),
+      previous_result_time( 0 ),
+      violations( 0 ),
+      frame_index( 0 )
+{
+    // Initialize
+    initialize();
+}
+
+// Destructor
+engine::~engine()
+{
+    // Finalize
+    finalize();
+}
+
+// Run (Window)
+void engine::run( source& source, const limit& limit )
+{
+    // Start Render Thread
+    renderer renderer( source.name() );
+
+    // Main Loop (Never Waits for Rendering)
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( uint64_t frames = 0; !renderer.closed() && !is_stopped( limit, frames, start ); frames++ ){
+        // Update
+        if( !update( source ) ){
+            // Retrieve Remaining Results (Skipped Frames are Already Published)
+            while( !ring->empty() ){
+                if( update_result( source ) && !propagator ){
+                    publish( renderer );
+                }
+            }
+
+            renderer.wait();
+            return;
+        }
+
+        // Publish
+        publish( renderer );
+    }
+
+    // Retrieve Remaining Results (Skipped Frames are Already Published)
+    while( !ring->empty() ){
+        if( update_result( source ) && !propagator ){
+            publish( renderer );
+        }
+    }
+}
+
+// Run (Headless)
+void engine::run( source& source, sink& sink, const limit& limit )
+{
+    // Main Loop (No Drawing)
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( uint64_t frames = 0; !is_stopped( limit, frames, start ); frames++ ){
+        // Update
+        if( !update( source ) ){
+            break;
+        }
+
+        // Publish
+        publish( sink );
+    }
+
+    // Retrieve Remaining Results (Skipped Frames are Already Published)
+    while( !ring->empty() ){
+        if( update_result( source ) && !propagator ){
+            publish( sink );
+        }
+    }
+
+    sink.flush();
+}
+
+// Initialize
+void engine::initialize()
+{
+    cv::setUseOptimized( true );
+
+    // Initialize Skeleton
+    initialize_skeleton();
+}
+
+// Initialize Skeleton
+void engine::initialize_skeleton()
+{
+    // Create Handle
+    CHECK_SUCCESS( inference_backend->create_handle( get_license_directory() ) );
+
+    // Load Model
+    const CM_TargetComputeDevice target_device = CM_TargetComputeDevice::CM_CPU;
+    const std::string model = get_model_file(); // FP32 model
+    //const std::string model = get_model_file( true ); // FP16 model
+    CHECK_SUCCESS( inference_backend->load_model( target_device, model ) );
+
+    // Create Native Tracker
+    tracker = std::make_unique<skeleton_tracker>( tracking_method::hungarian );
+
+    // Create Async Requests
+    ring = std::make_unique<inference_ring>( *inference_backend, inference_depth, inference_size );
+    frames.resize( ring->depth() );
+    layouts.resize( ring->depth() );
+}
+
+// Finalize
+void engine::finalize()
+{
+    // Drain In-Flight Requests (Handle is Destroyed with Backend)
+    ring.reset();
+    for( ::frame& frame : frames ){
+        frame = ::frame();
+    }
+    layouts.clear();
+    buffer.reset();
+    previous_buffer.reset();
+}
+
+// Adapt Inference Size to Budget of Policy
+void engine::adapt( const resolution_policy& policy )
+{
+    controller = std::make_unique<resolution_controller>( policy, inference_size );
+    ring->set_size( controller->size() );
+}
+
+// Skip Inference of Frames
+void engine::skip( const size_t interval, const propagation_mode mode )
+{
+    skip_interval = interval;
+    if( interval == 1 ){
+        propagator.reset();
+        return;
+    }
+
+    propagator = std::make_unique<keypoint_propagator>( mode );
+}
+
+// Set Tracking Method of Tracking ID
+void engine::track( const tracking_method method )
+{
+    if( method == tracking_method::backend ){
+        tracker.reset();
+        return;
+    }
+
+    tracker = std::make_unique<skeleton_tracker>( method );
+}
+
+// Smooth Joints of Each Track with Filters of Policy
+void engine::smooth( const filter_policy& policy )
+{
+    if( policy.mode == filter_mode::none ){
+        filter.reset();
+        return;
+    }
+
+    filter = std::make_unique<joint_filter>( policy );
+}
+
+// Set Latency Budget of SLO
+void engine::enforce( const std::chrono::nanoseconds budget )
+{
+    monitor.set_budget( budget );
+}
+
+// Get Rolling Metrics of Age of Published Results
+latency_metrics engine::get_latency() const
+{
+    return monitor.metrics();
+}
+
+// Crop Regions around Tracked People for Inference
+void engine::crop( const int32_t interval )
+{
+    if( interval == 0 ){
+        cropper.reset();
+        return;
+    }
+
+    cropper = std::make_unique<roi_cropper>( interval );
+}
+
+// Update
+bool engine::update( source& source )
+{
+    // Update Frame
+    frame frame;
+    if( !update_frame( source, frame ) ){
+        return false;
+    }
+
+    // Update Skipping (Every Frame is Published with Propagated Keypoints)
+    if( propagator ){
+        update_skipping( source, frame );
+        return true;
+    }
+
+    // Update Result (Wait until Oldest Request is Completed)
+    result_frame = ::frame();
+    while( ring->full() ){
+        update_result( source );
+    }
+
+    // Update Skeleton
+    update_skeleton( frame );
+
+    return true;
+}
+
+// Update Frame
+inline bool engine::update_frame( source& source, frame& frame )
+{
+    // Read Frame from Source
+    {
+        scoped_timer timer( stage::capture, frame_index );
+        if( !source.read( frame ) ){
+            return false;
+        }
+    }
+
+    // Stamp Frame (Sensor Time is Mapped to Steady Clock)
+    if( frame.timestamp.count() == 0 ){
+        frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+    }
+    frame.sensor_timestamp = clock.map( frame.device_timestamp, frame.timestamp );
+    frame.index = frame_index++;
+
+    return true;
+}
+
+// Update Skeleton
+inline void engine::update_skeleton( const frame& frame )
+{
+    if( frame.color.empty() ){
+        return;
+    }
+
+    // Crop Regions around Tracked People (Full Frame without Cropper)
+    roi_layout layout;
+    cv::Mat input = frame.color;
+    if( cropper ){
+        scoped_timer timer( stage::crop, frame.index );
+        input = cropper->crop( frame.color, layout );
+    }
+
+    // Async Inference
+    scoped_timer timer( stage::submit, frame.index );
+    const std::chrono::nanoseconds start = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+    const size_t slot = ring->submit( input );
+    frames[slot] = frame;
+    frames[slot].inference_start = start;
+    layouts[slot] = std::move( layout );
+}
+
+// Update Result
+bool engine::update_result( const source& source, const bool wait )
+{
+    // Retrieve Oldest Result
+    // (Frame of Result is Known after Retrieve, so Wait is Recorded Manually)
+    size_t slot;
+    CM_ReturnCode status;
+    const std::chrono::steady_clock::time_point wait_start = std::chrono::steady_clock::now();
+    if( wait ){
+        status = ring->retrieve( buffer.get(), slot );
+        if( status == CM_ReturnCode::CM_TIMEOUT ){
+            return false;
+        }
+    }
+    else if( !ring->try_retrieve( buffer.get(), slot, status ) ){
+        return false;
+    }
+    result = status;
+    const std::chrono::steady_clock::time_point wait_end = std::chrono::steady_clock::now();
+    result_frame = frames[slot];
+    result_frame.inference_end = std::chrono::duration_cast<std::chrono::nanoseconds>( wait_end.time_since_epoch() );
+    frames[slot] = frame();
+    const roi_layout layout = std::move( layouts[slot] );
+    layouts[slot] = roi_layout();
+    profiler::record( stage::inference, result_frame.index, wait_end - wait_start );
+
+    // Update Resolution
+    update_resolution();
+
+    if( result == CM_ReturnCode::CM_SUCCESS ){
+        // Copy Result into Arena and Release Buffer of Backend
+        CUBEMOS_SKEL_Buffer_Ptr latest_buffer = arena.acquire();
+        arena.store( *inference_backend, buffer.get(), latest_buffer.get() );
+
+        // Map Keypoints from Mosaic to Full Frame (Tracking Matches Full Frame Coordinates)
+        roi_cropper::map( layout, latest_buffer.get() );
+
+        // Update Tracking ID
+        scoped_timer timer( stage::tracking, result_frame.index );
+        if( tracker ){
+            tracker->update( latest_buffer.get() );
+        }
+        else{
+            CHECK_SUCCESS( inference_backend->update_tracking_id( previous_buffer.get(), latest_buffer.get() ) );
+        }
+
+        // Replace Previous Buffer (Previous Buffer Returns to Free List of Arena)
+        previous_buffer = std::move( latest_buffer );
+
+        // Regions of Next Submits from Latest Result
+        if( cropper ){
+            cropper->update( previous_buffer.get() );
+        }
+    }
+
+    // Update Correction (Keypoints are Published on Following Frames)
+    if( propagator ){
+        update_correction();
+        return true;
+    }
+
+    // Update Deprojection
+    update_deprojection( source );
+    return true;
+}
+
+// Update Skipping
+inline void engine::update_skipping( const source& source, const frame& frame )
+{
+    // Inference on Every n-th Frame (or whenever Request is Free)
+    const bool infer = !frame.color.empty() && ( skip_interval == 0 || frame.index % skip_interval == 0 );
+
+    // Retrieve Completed Results (Wait Only if Request is Needed for Inference of Every n-th Frame)
+    while( !ring->empty() ){
+        const bool wait = infer && skip_interval != 0 && ring->full();
+        if( !update_result( source, wait ) ){
+            break;
+        }
+    }
+
+    // Async Inference
+    if( infer && !ring->full() ){
+        update_skeleton( frame );
+    }
+
+    // Update Propagation
+    update_propagation( frame );
+
+    // Update Deprojection (Depth of This Frame)
+    update_deprojection( source );
+}
+
+// Update Correction
+inline void engine::update_correction()
+{
+    if( result != CM_ReturnCode::CM_SUCCESS ){
+        return;
+    }
+
+    // Correct with Keypoints of Latest Result
+    keypoints.assign( previous_buffer.get() );
+    propagator->correct( result_frame, keypoints );
+}
+
+// Update Propagation
+inline void engine::update_propagation( const frame& frame )
+{
+    scoped_timer timer( stage::propagation, frame.index );
+    result_frame = frame;
+    result = propagator->predict( result_frame, keypoints ) ? CM_ReturnCode::CM_SUCCESS : CM_ReturnCode::CM_ERROR;
+}
+
+// Update Deprojection
+inline void engine::update_deprojection( const source& source )
+{
+    if( result != CM_ReturnCode::CM_SUCCESS ){
+        keypoints.clear();
+        skeleton.clear();
+        deprojected = false;
+        return;
+    }
+
+    {
+        // Gather Keypoints of Latest Result (Propagated Keypoints are Already Gathered)
+        scoped_timer timer( stage::deprojection, result_frame.index );
+        if( !propagator ){
+            keypoints.assign( previous_buffer.get() );
+        }
+
+        // Deproject All Keypoints in Batch
+        deprojected = source.deproject( result_frame, keypoints, skeleton );
+        if( !deprojected ){
+            skeleton.clear();
+        }
+    }
+
+    // Update Filter
+    update_filter();
+}
+
+// Update Filter
+inline void engine::update_filter()
+{
+    if( !filter ){
+        return;
+    }
+
+    // Smooth 2D and 3D Joints of Each Track
+    scoped_timer timer( stage::filter, result_frame.index );
+    filter->apply( result_frame.timestamp, keypoints, skeleton );
+}
+
+// Publish Result to Renderer
+void engine::publish( renderer& renderer )
+{
+    if( result_frame.color.empty() ){
+        return;
+    }
+
+    // Publish Latest Frame and Skeletons
+    result_frame.publish_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+    renderer.publish( result_frame, keypoints, skeleton );
+
+    // Record Latency
+    update_latency();
+}
+
+// Publish Result to Sink
+void engine::publish( sink& sink )
+{
+    if( result_frame.color.empty() ){
+        return;
+    }
+
+    // Write Latest Skeletons
+    {
+        scoped_timer timer( stage::write, result_frame.index );
+        result_frame.publish_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+        sink.write( result_frame, keypoints, skeleton );
+    }
+
+    // Record Latency
+    update_latency();
+}
+
+// Update Latency (Age of Published Result from Sensor Timestamp)
+inline void engine::update_latency()
+{
+    // Record Age of Result (Violations of SLO are Counted as Gauge)
+    if( monitor.record( result_frame ) ){
+        profiler::set_gauge( "slo_violations", static_cast<int64_t>( ++violations ) );
+    }
+
+    if( !profiler::is_enabled() ){
+        return;
+    }
+
+    profiler::record( stage::transport, result_frame.index, result_frame.timestamp - result_frame.sensor_timestamp );
+    profiler::record( stage::latency, result_frame.index, result_frame.publish_timestamp - result_frame.sensor_timestamp );
+}
+
+// Update Resolution
+inline void engine::update_resolution()
+{
+    if( !controller ){
+        return;
+    }
+
+    // Duration of Result in Metric of Policy
+    const std::chrono::nanoseconds now = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+    const std::chrono::nanoseconds duration = ( controller->metric() == budget_metric::latency ) ? now - result_frame.sensor_timestamp : now - previous_result_time;
+    const bool first = ( previous_result_time.count() == 0 );
+    previous_result_time = now;
+    if( first && controller->metric() == budget_metric::interval ){
+        return;
+    }
+
+    // Change Inference Size of Next Submits
+    if( controller->update( duration ) ){
+        ring->set_size( controller->size() );
+    }
+}
+
+// Get 2D Skeletons of Latest Result
+const skeleton2d& engine::get_keypoints() const
+{
+    return keypoints;
+}
+
+// Get 3D Skeletons of Latest Result
+const skeleton3d& engine::get_skeleton() const
+{
+    return skeleton;
+}
@@ -0,0 +1,194 @@
+#ifndef __ENGINE__
+#define __ENGINE__
+
+#include <vector>
+#include <memory>
+#include <chrono>
+
+#include <opencv2/opencv.hpp>
+#include <cubemos/skeleton_tracking.h>
+
+#include "util.hpp"
+#include "backend.hpp"
+#include "inference.hpp"
+#include "source.hpp"
+#include "skeleton.hpp"
+#include "renderer.hpp"
+#include "sink.hpp"
+#include "resolution.hpp"
+#include "propagation.hpp"
+#include "roi.hpp"
+#include "tracker.hpp"
+#include "filter.hpp"
+#include "arena.hpp"
+#include "clock.hpp"
+#include "latency.hpp"
+
+// Stop Condition of Run (0 means unlimited)
+struct limit
+{
+    uint64_t frames = 0;
+    std::chrono::milliseconds duration = std::chrono::milliseconds( 0 );
+};
+
+// Check Stop Condition (Limit is Reached or Interrupted)
+bool is_stopped( const limit& limit, const uint64_t frames, const std::chrono::steady_clock::time_point start );
+
+/*
+ This is skeleton pipeline engine that is shared by all samples.
+
+ It reads frames from source, keeps several inferences in flight,
+ updates tracking id, and publishes retrieved results to render thread.
+
+ camera_source source( 0 );
+ engine engine( std::make_unique<cubemos_backend>() );
+ engine.run( source );       // draw/show skeletons in window
+ engine.run( source, sink ); // headless (write skeletons to sink without drawing)
+ engine.adapt( policy );     // choose inference size within latency budget
+ engine.skip( 3, propagation_mode::flow ); // inference on every 3rd frame, optical flow on others
+ engine.crop( 30 );          // infer regions around tracked people, full frame on every 30th inference
+ engine.track( tracking_method::greedy ); // native tracker with greedy assignment
+ engine.smooth( policy );    // smooth 2D and 3D joints of each track
+ engine.enforce( std::chrono::milliseconds( 100 ) ); // count results older than 100 ms (engine.get_latency())
+*/
+class engine
+{
+private:
+    // Cubemos
+    std::unique_ptr<backend> inference_backend;
+    std::unique_ptr<inference_ring> ring;
+    size_t inference_depth;
+    int32_t inference_size;
+    std::vector<frame> frames; // frame of each in-flight request
+    CUBEMOS_SKEL_Buffer_Ptr buffer;          // filled by backend (released right after copy into arena)
+    skeleton_arena arena;                    // recycled buffers of results
+    CUBEMOS_SKEL_Buffer_Ptr previous_buffer; // latest result (buffer of arena)
+
+    // Result
+    CM_ReturnCode result;
+    frame result_frame;
+    skeleton2d keypoints;
+    skeleton3d skeleton;
+    bool deprojected;
+
+    // Native Tracker (Tracking ID is Updated by Backend if Empty)
+    std::unique_ptr<skeleton_tracker> tracker;
+
+    // Temporal Filter of Joints (Empty means Raw Joints)
+    std::unique_ptr<joint_filter> filter;
+
+    // Frame Skipping (Inference on Some Frames, Keypoints of Other Frames are Propagated)
+    std::unique_ptr<keypoint_propagator> propagator;
+    size_t skip_interval; // inference on every n-th frame (0 means whenever request is free)
+
+    // Region of Interest (Mosaic of Regions around Tracked People)
+    std::unique_ptr<roi_cropper> cropper;
+    std::vector<roi_layout> layouts; // layout of each in-flight request
+
+    // Adaptive Inference Size
+    std::unique_ptr<resolution_controller> controller;
+    std::chrono::nanoseconds previous_result_time;
+
+    // Clock of Sensor and Age of Results
+    clock_mapper clock;      // sensor time to steady clock
+    latency_monitor monitor; // rolling age of published results
+    uint64_t violations;     // results older than budget of SLO
+
+    // Frame Counter
+    uint64_t frame_index;
+
+public:
+    // Constructor
+    engine( std::unique_ptr<backend> backend, const size_t inference_depth = 2, const int32_t inference_size = MULTIPLE * 12 );
+
+    // Destructor
+    ~engine();
+
+    engine( const engine& ) = delete;
+    engine& operator=( const engine& ) = delete;
+
+    // Run (Window)
+    void run( source& source, const limit& limit = ::limit() );
+
+    // Run (Headless)
+    void run( source& source, sink& sink, const limit& limit = ::limit() );
+
+    // Adapt Inference Size to Budget of Policy
+    void adapt( const resolution_policy& policy );
+
+    // Skip Inference of Frames (Interval 0 means Inference whenever Request is Free, 1 means No Skipping)
+    void skip( const size_t interval, const propagation_mode mode = propagation_mode::extrapolation );
+
+    // Set Tracking Method of Tracking ID (Native Hungarian by Default)
+    void track( const tracking_method method );
+
+    // Smooth Joints of Each Track with Filters of Policy
+    void smooth( const filter_policy& policy );
+
+    // Set Latency Budget of SLO (Age of Result from Sensor Time to Publish, 0 means No SLO)
+    void enforce( const std::chrono::nanoseconds budget );
+
+    // Get Rolling Metrics of Age of Published Results
+    latency_metrics get_latency() const;
+
+    // Crop Regions around Tracked People for Inference (Interval is Inferences between Full Frames, 0 means No Cropping)
+    void crop( const int32_t interval );
+
+    // Update (Return false at End of Stream)
+    bool update( source& source );
+
+    // Publish Result to Renderer
+    void publish( renderer& renderer );
+
+    // Publish Result to Sink
+    void publish( sink& sink );
+
+    // Get 2D Skeletons of Latest Result
+    const skeleton2d& get_keypoints() const;
+
+    // Get 3D Skeletons of Latest Result (Empty if Source doesn't Support Deprojection)
+    const skeleton3d& get_skeleton() const;
+
+private:
+    // Initialize
+    void initialize();
+
+    // Initialize Skeleton
+    void initialize_skeleton();
+
+    // Finalize
+    void finalize();
+
+    // Update Frame
+    bool update_frame( source& source, frame& frame );
+
+    // Update Skeleton
+    void update_skeleton( const frame& frame );
+
+    // Update Result (Retrieve Oldest Result, Return false if Result is Not Completed, or Not Completed within Timeout if wait is true)
+    bool update_result( const source& source, const bool wait = true );
+
+    // Update Skipping (Submit Some Frames, Retrieve Completed Results without Waiting)
+    void update_skipping( const source& source, const frame& frame );
+
+    // Update Correction (Correct Propagator with Result)
+    void update_correction();
+
+    // Update Propagation (Propagate Keypoints of Latest Result to Frame)
+    void update_propagation( const frame& frame );
+
+    // Update Deprojection
+    void update_deprojection( const source& source );
+
+    // Update Filter (Smooth Joints of Latest Result)
+    void update_filter();
+
+    // Update Latency (Age of Published Result from Sensor Timestamp)
+    void update_latency();
+
+    // Update Resolution (Feed Duration of Result to Controller)
+    void update_resolution();
+
+};
+
+#endif // __ENGINE__
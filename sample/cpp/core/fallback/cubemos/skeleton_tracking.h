@@ -0,0 +1,76 @@
+#ifndef __FALLBACK_SKELETON_TRACKING__
+#define __FALLBACK_SKELETON_TRACKING__
+
+/*
+ This is fallback header that declares only types of Skeleton Tracking SDK by Cubemos.
+
+ It is used instead of SDK header when SDK is not found (WITH_CUBEMOS=OFF),
+ so skeleton_core can be built with mock backend on machine that has no SDK and license.
+ No cm_skel_* function is declared, so only mock backend is available.
+*/
+
+#include <stdint.h>
+
+typedef enum CM_ReturnCode
+{
+    CM_SUCCESS = 0,
+    CM_ERROR = 1,
+    CM_FILE_DOES_NOT_EXIST = 2,
+    CM_INVALID_ARGUMENT = 3,
+    CM_INVALID_ACTIVATION_KEY = 4,
+    CM_ACTIVATION_FAILED = 5,
+    CM_NOT_IMPLEMENTED = 6,
+    CM_TIMEOUT = 7
+} CM_ReturnCode;
+
+typedef enum CM_Datatype
+{
+    CM_UINT8 = 0,
+    CM_INT8,
+    CM_UINT16,
+    CM_INT16,
+    CM_FLOAT16,
+    CM_FLOAT32
+} CM_Datatype;
+
+typedef enum CM_MemoryOrder
+{
+    CM_HWC = 0,
+    CM_CHW
+} CM_MemoryOrder;
+
+typedef enum CM_TargetComputeDevice
+{
+    CM_CPU = 0,
+    CM_GPU,
+    CM_MYRIAD,
+    CM_HDDL
+} CM_TargetComputeDevice;
+
+typedef struct CM_Image
+{
+    void* data;
+    CM_Datatype dataType;
+    int nWidth;
+    int nHeight;
+    int nChannels;
+    int nStride;
+    CM_MemoryOrder imageLayout;
+} CM_Image;
+
+typedef struct CM_SKEL_KeypointsBuffer
+{
+    int id;
+    int numKeyPoints;
+    float* keypoints_coord_x;
+    float* keypoints_coord_y;
+    float* confidences;
+} CM_SKEL_KeypointsBuffer;
+
+typedef struct CM_SKEL_Buffer
+{
+    CM_SKEL_KeypointsBuffer* skeletons;
+    int numSkeletons;
+} CM_SKEL_Buffer;
+
+#endif // __FALLBACK_SKELETON_TRACKING__
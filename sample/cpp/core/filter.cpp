@@ -0,0 +1,292 @@
+#include "filter.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    constexpr float pi = 3.14159265358979f;
+
+    // Min Interval of Measurements (Frames of Same Timestamp don't Divide by Zero) [s]
+    constexpr float min_interval = 1.0e-4f;
+
+    // Initial Variance of Velocity relative to Variance of Measurement (Kalman) [1/s^2]
+    constexpr float initial_velocity_variance = 100.0f;
+}
+
+// Constructor
+joint_filter::joint_filter( const filter_policy& policy, const size_t capacity )
+    : policy( policy ),
+      capacity( capacity ),
+      previous_timestamp( 0 )
+{
+    if( capacity == 0 ){
+        throw std::runtime_error( "failed to create joint filter (capacity is 0)!" );
+    }
+
+    // Allocate Slots and Banks
+    slot_ids.resize( capacity, -1 );
+    last_seen.resize( capacity, std::chrono::nanoseconds( 0 ) );
+    slots.reserve( capacity );
+    initialize_bank( keypoints_bank, policy.keypoints, 2 );
+    initialize_bank( skeleton_bank, policy.skeleton, 3 );
+}
+
+// Filter Keypoints and 3D Joints of Frame in Place
+void joint_filter::apply( const std::chrono::nanoseconds timestamp, skeleton2d& keypoints, skeleton3d& skeleton )
+{
+    if( policy.mode == filter_mode::none ){
+        return;
+    }
+
+    // Interval from Previous Frame [s]
+    const float dt = ( previous_timestamp.count() == 0 ) ? 0.0f : std::max( std::chrono::duration<float>( timestamp - previous_timestamp ).count(), 0.0f );
+    previous_timestamp = timestamp;
+
+    // Update Slots of Tracks
+    update_slots( timestamp, keypoints.ids );
+
+    // Scatter Measurements by Slot of Track
+    const bool has_skeleton = ( skeleton.size() == keypoints.size() && skeleton.skeletons() == keypoints.skeletons() );
+    std::fill( keypoints_bank.measured.begin(), keypoints_bank.measured.end(), 0.0f );
+    std::fill( skeleton_bank.measured.begin(), skeleton_bank.measured.end(), 0.0f );
+    for( size_t i = 0; i < keypoints.skeletons(); i++ ){
+        if( slots[i] < 0 ){
+            continue;
+        }
+
+        const size_t offset = static_cast<size_t>( slots[i] ) * joints;
+        const size_t count = std::min( static_cast<size_t>( keypoints.offsets[i + 1] - keypoints.offsets[i] ), joints );
+        for( size_t joint = 0; joint < count; joint++ ){
+            const size_t index = static_cast<size_t>( keypoints.offsets[i] ) + joint;
+            const size_t element = offset + joint;
+            if( 0.0f < keypoints.confidences[index] && 0.0f <= keypoints.x[index] && 0.0f <= keypoints.y[index] ){
+                keypoints_bank.channels[0].input[element] = keypoints.x[index];
+                keypoints_bank.channels[1].input[element] = keypoints.y[index];
+                keypoints_bank.measured[element] = 1.0f;
+            }
+            if( has_skeleton && skeleton.valid[index] ){
+                skeleton_bank.channels[0].input[element] = skeleton.x[index];
+                skeleton_bank.channels[1].input[element] = skeleton.y[index];
+                skeleton_bank.channels[2].input[element] = skeleton.z[index];
+                skeleton_bank.measured[element] = 1.0f;
+            }
+        }
+    }
+
+    // Update All Joints of All Tracks
+    update_bank( keypoints_bank, dt );
+    if( has_skeleton ){
+        update_bank( skeleton_bank, dt );
+    }
+
+    // Gather Filtered Values of Measured Joints
+    for( size_t i = 0; i < keypoints.skeletons(); i++ ){
+        if( slots[i] < 0 ){
+            continue;
+        }
+
+        const size_t offset = static_cast<size_t>( slots[i] ) * joints;
+        const size_t count = std::min( static_cast<size_t>( keypoints.offsets[i + 1] - keypoints.offsets[i] ), joints );
+        for( size_t joint = 0; joint < count; joint++ ){
+            const size_t index = static_cast<size_t>( keypoints.offsets[i] ) + joint;
+            const size_t element = offset + joint;
+            if( 0.0f < keypoints_bank.measured[element] ){
+                keypoints.x[index] = keypoints_bank.channels[0].value[element];
+                keypoints.y[index] = keypoints_bank.channels[1].value[element];
+            }
+            if( has_skeleton && 0.0f < skeleton_bank.measured[element] ){
+                skeleton.x[index] = skeleton_bank.channels[0].value[element];
+                skeleton.y[index] = skeleton_bank.channels[1].value[element];
+                skeleton.z[index] = skeleton_bank.channels[2].value[element];
+            }
+        }
+    }
+}
+
+// Reset All States
+void joint_filter::reset()
+{
+    std::fill( slot_ids.begin(), slot_ids.end(), -1 );
+    std::fill( keypoints_bank.initialized.begin(), keypoints_bank.initialized.end(), 0.0f );
+    std::fill( skeleton_bank.initialized.begin(), skeleton_bank.initialized.end(), 0.0f );
+    previous_timestamp = std::chrono::nanoseconds( 0 );
+}
+
+// Mode
+filter_mode joint_filter::get_mode() const
+{
+    return policy.mode;
+}
+
+// Initialize Bank
+inline void joint_filter::initialize_bank( bank& bank, const filter_parameters& parameters, const size_t coordinates )
+{
+    const size_t size = capacity * joints;
+    bank.parameters = parameters;
+    bank.channels.resize( coordinates );
+    for( channel& channel : bank.channels ){
+        channel.input.resize( size );
+        channel.value.resize( size );
+        channel.velocity.resize( size );
+        channel.p00.resize( size );
+        channel.p01.resize( size );
+        channel.p11.resize( size );
+    }
+    bank.measured.resize( size );
+    bank.initialized.resize( size );
+    bank.elapsed.resize( size );
+}
+
+// Update Slots of Tracks
+inline void joint_filter::update_slots( const std::chrono::nanoseconds timestamp, const std::vector<int64_t>& ids )
+{
+    // Release Tracks that are Not Seen for Timeout
+    for( size_t slot = 0; slot < capacity; slot++ ){
+        if( 0 <= slot_ids[slot] && policy.timeout < timestamp - last_seen[slot] ){
+            slot_ids[slot] = -1;
+        }
+    }
+
+    // Find Slot of Each Track (Few Tracks, so Linear Search is Fine)
+    slots.assign( ids.size(), -1 );
+    for( size_t i = 0; i < ids.size(); i++ ){
+        if( ids[i] < 0 ){
+            continue;
+        }
+
+        const std::vector<int64_t>::const_iterator iterator = std::find( slot_ids.begin(), slot_ids.end(), ids[i] );
+        if( iterator != slot_ids.end() ){
+            slots[i] = static_cast<int32_t>( iterator - slot_ids.begin() );
+        }
+        else{
+            // Assign Free Slot to New Track (Not Filtered if Capacity is Exhausted)
+            const std::vector<int64_t>::iterator free = std::find( slot_ids.begin(), slot_ids.end(), -1 );
+            if( free == slot_ids.end() ){
+                continue;
+            }
+
+            *free = ids[i];
+            slots[i] = static_cast<int32_t>( free - slot_ids.begin() );
+            const size_t offset = static_cast<size_t>( slots[i] ) * joints;
+            std::fill( keypoints_bank.initialized.begin() + offset, keypoints_bank.initialized.begin() + offset + joints, 0.0f );
+            std::fill( skeleton_bank.initialized.begin() + offset, skeleton_bank.initialized.begin() + offset + joints, 0.0f );
+        }
+
+        last_seen[slots[i]] = timestamp;
+    }
+}
+
+// Update Bank
+inline void joint_filter::update_bank( bank& bank, const float dt )
+{
+    // Elapsed Time since Last Measurement (Joint Missing for Timeout Restarts Filter)
+    const size_t size = bank.elapsed.size();
+    const float timeout = std::chrono::duration<float>( policy.timeout ).count();
+    float* elapsed = bank.elapsed.data();
+    float* initialized = bank.initialized.data();
+    for( size_t i = 0; i < size; i++ ){
+        elapsed[i] += dt;
+        initialized[i] = ( elapsed[i] <= timeout ) ? initialized[i] : 0.0f;
+    }
+
+    // Update Each Coordinate
+    for( channel& channel : bank.channels ){
+        if( policy.mode == filter_mode::one_euro ){
+            update_one_euro( channel, bank );
+        }
+        else{
+            update_kalman( channel, bank, dt );
+        }
+    }
+
+    // Measured Joints are Initialized
+    const float* measured = bank.measured.data();
+    for( size_t i = 0; i < size; i++ ){
+        elapsed[i] *= 1.0f - measured[i];
+        initialized[i] += measured[i] * ( 1.0f - initialized[i] );
+    }
+}
+
+// Update One-Euro Filters of Coordinate
+inline void joint_filter::update_one_euro( channel& channel, const bank& bank ) const
+{
+    // Single Pass over SoA (Vectorized by Compiler)
+    const filter_parameters& parameters = bank.parameters;
+    const float derivative_tau = 1.0f / ( 2.0f * pi * parameters.derivative_cutoff );
+    const size_t size = channel.value.size();
+    const float* input = channel.input.data();
+    float* value = channel.value.data();
+    float* velocity = channel.velocity.data();
+    const float* measured = bank.measured.data();
+    const float* initialized = bank.initialized.data();
+    const float* elapsed = bank.elapsed.data();
+    for( size_t i = 0; i < size; i++ ){
+        // Smoothing Factor of Interval is dt / ( dt + tau ), tau = 1 / ( 2 * pi * cutoff )
+        const float dt = ( min_interval < elapsed[i] ) ? elapsed[i] : min_interval;
+        const float derivative = ( input[i] - value[i] ) / dt;
+        const float filtered_derivative = velocity[i] + dt / ( dt + derivative_tau ) * ( derivative - velocity[i] );
+        const float cutoff = parameters.min_cutoff + parameters.beta * std::fabs( filtered_derivative );
+        const float alpha = dt / ( dt + 1.0f / ( 2.0f * pi * cutoff ) );
+        const float filtered = value[i] + alpha * ( input[i] - value[i] );
+
+        // Measured Joint is Filtered (or Starts with Measurement), Others Keep State
+        // (Masks are Blended Arithmetically, so Loop has No Branch)
+        const float m = measured[i];
+        const float s = initialized[i];
+        value[i] += m * ( input[i] + s * ( filtered - input[i] ) - value[i] );
+        velocity[i] += m * ( s * filtered_derivative - velocity[i] );
+    }
+}
+
+// Update Kalman Filters of Coordinate
+inline void joint_filter::update_kalman( channel& channel, const bank& bank, const float dt ) const
+{
+    // Single Pass over SoA (Vectorized by Compiler)
+    const filter_parameters& parameters = bank.parameters;
+    const float q = parameters.process_noise;
+    const float r = parameters.measurement_noise;
+    const size_t size = channel.value.size();
+    const float* input = channel.input.data();
+    float* value = channel.value.data();
+    float* velocity = channel.velocity.data();
+    float* p00 = channel.p00.data();
+    float* p01 = channel.p01.data();
+    float* p11 = channel.p11.data();
+    const float* measured = bank.measured.data();
+    const float* initialized = bank.initialized.data();
+    for( size_t i = 0; i < size; i++ ){
+        // Predict with Constant Velocity (Unmeasured Joints Coast)
+        const float position = value[i] + velocity[i] * dt;
+        const float a = p00[i] + dt * ( 2.0f * p01[i] + dt * p11[i] ) + q * dt * dt * dt / 3.0f;
+        const float b = p01[i] + dt * p11[i] + q * dt * dt / 2.0f;
+        const float c = p11[i] + q * dt;
+
+        // Correct with Measurement (Tracked Joint)
+        const float m = measured[i];
+        const float s = initialized[i];
+        const float gain0 = m * a / ( a + r );
+        const float gain1 = m * b / ( a + r );
+        const float innovation = input[i] - position;
+        const float tracked_value = position + gain0 * innovation;
+        const float tracked_velocity = velocity[i] + gain1 * innovation;
+        const float tracked_p00 = ( 1.0f - gain0 ) * a;
+        const float tracked_p01 = ( 1.0f - gain0 ) * b;
+        const float tracked_p11 = c - gain1 * b;
+
+        // Start with Measurement (New Joint), Unmeasured New Joint Keeps State
+        const float started_value = value[i] + m * ( input[i] - value[i] );
+        const float started_velocity = ( 1.0f - m ) * velocity[i];
+        const float started_p00 = p00[i] + m * ( r - p00[i] );
+        const float started_p01 = ( 1.0f - m ) * p01[i];
+        const float started_p11 = p11[i] + m * ( r * initial_velocity_variance - p11[i] );
+
+        // Select by Mask Arithmetically (Loop has No Branch)
+        value[i] = started_value + s * ( tracked_value - started_value );
+        velocity[i] = started_velocity + s * ( tracked_velocity - started_velocity );
+        p00[i] = started_p00 + s * ( tracked_p00 - started_p00 );
+        p01[i] = started_p01 + s * ( tracked_p01 - started_p01 );
+        p11[i] = started_p11 + s * ( tracked_p11 - started_p11 );
+    }
+}
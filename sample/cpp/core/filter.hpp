@@ -0,0 +1,119 @@
+#ifndef __FILTER__
+#define __FILTER__
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "skeleton.hpp"
+
+/*
+ This is bank of temporal filters that smooth 2D keypoints and 3D joints of each track.
+
+ Each joint of each track (tracking id) has its own filter for each coordinate.
+ One-Euro is low-pass filter whose cutoff rises with speed (little jitter at rest, little lag in motion).
+ Kalman is constant-velocity model of each coordinate (position and velocity with covariance).
+ Filter states are stored in flat arrays (SoA) of capacity x joints, so measurements are scattered by slot of track,
+ all joints of all tracks are updated in one branchless pass per coordinate,
+ and filtered values are gathered back. Missing joints (no confidence or no depth) are not updated and stay missing.
+ State of track is released when track isn't seen for timeout.
+
+ filter_policy policy;
+ policy.mode = filter_mode::one_euro;
+ joint_filter filter( policy );
+ filter.apply( frame.timestamp, keypoints, skeleton ); // after deprojection
+*/
+
+// Filter Mode
+enum class filter_mode
+{
+    none,     // raw joints
+    one_euro, // speed adaptive low-pass filter
+    kalman    // constant velocity Kalman filter
+};
+
+// Parameters of Filters (Units of Coordinate, 2D is Pixel and 3D is Meter)
+struct filter_parameters
+{
+    float min_cutoff = 1.0f;        // One-Euro: cutoff at rest [Hz]
+    float beta = 0.01f;             // One-Euro: increase of cutoff with speed [Hz / (unit/s)]
+    float derivative_cutoff = 1.0f; // One-Euro: cutoff of speed [Hz]
+    float process_noise = 1.0e4f;   // Kalman: spectral density of acceleration [unit^2/s^3]
+    float measurement_noise = 4.0f; // Kalman: variance of measurement [unit^2]
+};
+
+// Policy of Filters
+struct filter_policy
+{
+    filter_mode mode = filter_mode::none;
+    filter_parameters keypoints;                                  // 2D keypoints [pixel]
+    filter_parameters skeleton = { 1.0f, 1.0f, 1.0f, 1.0f, 4.0e-4f }; // 3D joints [m]
+    std::chrono::nanoseconds timeout = std::chrono::milliseconds( 500 ); // release state of unseen track or joint
+};
+
+class joint_filter
+{
+private:
+    // State of Filters of One Coordinate (Element of Joint j of Slot s is s * joints + j)
+    struct channel
+    {
+        std::vector<float> input;    // measurement
+        std::vector<float> value;    // filtered position
+        std::vector<float> velocity; // filtered derivative (One-Euro) or velocity (Kalman)
+        std::vector<float> p00;      // covariance (Kalman)
+        std::vector<float> p01;
+        std::vector<float> p11;
+    };
+
+    // Filters of 2D Keypoints or 3D Joints
+    struct bank
+    {
+        filter_parameters parameters;
+        std::vector<channel> channels;    // x, y (, z)
+        std::vector<float> measured;      // 1 if measurement is available in this frame, otherwise 0 (float mask keeps loops vectorizable)
+        std::vector<float> initialized;   // 1 if filter has state, otherwise 0
+        std::vector<float> elapsed;       // time since last measurement [s]
+    };
+
+    filter_policy policy;
+    size_t capacity;                        // max number of tracks
+    static constexpr size_t joints = 18;
+    std::vector<int64_t> slot_ids;          // tracking id of each slot (-1 means free)
+    std::vector<std::chrono::nanoseconds> last_seen;
+    std::vector<int32_t> slots;             // slot of each skeleton of frame (-1 means not filtered)
+    std::chrono::nanoseconds previous_timestamp;
+    bank keypoints_bank;
+    bank skeleton_bank;
+
+public:
+    // Constructor
+    joint_filter( const filter_policy& policy, const size_t capacity = 64 );
+
+    // Filter Keypoints and 3D Joints of Frame in Place (Skeleton may be Empty)
+    void apply( const std::chrono::nanoseconds timestamp, skeleton2d& keypoints, skeleton3d& skeleton );
+
+    // Reset All States
+    void reset();
+
+    // Mode
+    filter_mode get_mode() const;
+
+private:
+    // Initialize Bank
+    void initialize_bank( bank& bank, const filter_parameters& parameters, const size_t coordinates );
+
+    // Update Slots of Tracks (Release Unseen Tracks, Assign Slots to New Tracks)
+    void update_slots( const std::chrono::nanoseconds timestamp, const std::vector<int64_t>& ids );
+
+    // Update Bank (One Pass over All Joints of All Tracks)
+    void update_bank( bank& bank, const float dt );
+
+    // Update One-Euro Filters of Coordinate
+    void update_one_euro( channel& channel, const bank& bank ) const;
+
+    // Update Kalman Filters of Coordinate
+    void update_kalman( channel& channel, const bank& bank, const float dt ) const;
+};
+
+#endif // __FILTER__
@@ -0,0 +1,208 @@
+#include "fusion.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include <opencv2/opencv.hpp>
+
+// Load Extrinsics of Devices from File
+std::vector<extrinsics> load_extrinsics( const std::string& path )
+{
+    cv::FileStorage storage( path, cv::FileStorage::READ );
+    if( !storage.isOpened() ){
+        throw std::runtime_error( "failed to open extrinsics " + path + "!" );
+    }
+
+    // Read Rotation and Translation of Each Device
+    std::vector<extrinsics> transforms;
+    const cv::FileNode devices = storage["devices"];
+    for( cv::FileNodeIterator iterator = devices.begin(); iterator != devices.end(); ++iterator ){
+        std::vector<float> rotation, translation;
+        ( *iterator )["rotation"] >> rotation;
+        ( *iterator )["translation"] >> translation;
+        if( rotation.size() != 9 || translation.size() != 3 ){
+            throw std::runtime_error( "failed to read extrinsics " + path + " (rotation is 3x3 and translation is 3)!" );
+        }
+
+        transforms.push_back( extrinsics() );
+        std::copy( rotation.begin(), rotation.end(), transforms.back().rotation );
+        std::copy( translation.begin(), translation.end(), transforms.back().translation );
+    }
+
+    if( transforms.empty() ){
+        throw std::runtime_error( "failed to read extrinsics " + path + " (no device)!" );
+    }
+
+    return transforms;
+}
+
+// Constructor
+skeleton_fusion::skeleton_fusion( const std::vector<extrinsics>& transforms, const float distance )
+    : transforms( transforms ),
+      distance( distance ),
+      cluster_count( 0 )
+{
+}
+
+// Fuse Skeletons of Devices
+void skeleton_fusion::fuse( const std::vector<const skeleton2d*>& keypoints, const std::vector<const skeleton3d*>& skeletons, skeleton2d& fused_keypoints, skeleton3d& fused_skeleton )
+{
+    if( keypoints.size() != skeletons.size() ){
+        throw std::runtime_error( "failed to fuse (number of keypoints is not equal to number of skeletons)!" );
+    }
+    if( !transforms.empty() && transforms.size() < skeletons.size() ){
+        throw std::runtime_error( "failed to fuse (extrinsics of device is not found)!" );
+    }
+
+    // Transform Skeletons of Each Device into Common Coordinate
+    update_transformation( skeletons );
+
+    // Associate Skeletons of Devices into Clusters
+    update_association();
+
+    // Merge Clusters into Fused Skeletons
+    update_fusion( keypoints, fused_keypoints, fused_skeleton );
+}
+
+// Transform Skeletons of Each Device into Common Coordinate
+inline void skeleton_fusion::update_transformation( const std::vector<const skeleton3d*>& skeletons )
+{
+    this->skeletons.resize( skeletons.size() );
+    for( size_t i = 0; i < skeletons.size(); i++ ){
+        // Copy into Recycled Buffers (Skeleton without Depth is Not Fused)
+        skeleton3d& skeleton = this->skeletons[i];
+        if( skeletons[i] == nullptr ){
+            skeleton.clear();
+            continue;
+        }
+        skeleton = *skeletons[i];
+
+        if( !transforms.empty() ){
+            transform_skeleton( transforms[i].rotation, transforms[i].translation, skeleton );
+        }
+    }
+}
+
+// Associate Skeletons of Devices into Clusters
+inline void skeleton_fusion::update_association()
+{
+    cluster_count = 0;
+    for( size_t device = 0; device < skeletons.size(); device++ ){
+        for( size_t skeleton = 0; skeleton < skeletons[device].skeletons(); skeleton++ ){
+            const member candidate = { device, skeleton };
+
+            // Find Nearest Cluster that doesn't have Skeleton of Same Device
+            size_t nearest = cluster_count;
+            float nearest_distance = distance;
+            for( size_t i = 0; i < cluster_count; i++ ){
+                if( clusters[i].back().device == device ){
+                    continue;
+                }
+
+                const float mean_distance = get_distance( clusters[i].front(), candidate );
+                if( 0.0f <= mean_distance && mean_distance < nearest_distance ){
+                    nearest = i;
+                    nearest_distance = mean_distance;
+                }
+            }
+
+            // Create New Cluster (Recycle Buffer)
+            if( nearest == cluster_count ){
+                if( clusters.size() <= cluster_count ){
+                    clusters.emplace_back();
+                }
+                clusters[cluster_count++].clear();
+            }
+
+            clusters[nearest].push_back( candidate );
+        }
+    }
+}
+
+// Merge Clusters into Fused Skeletons
+inline void skeleton_fusion::update_fusion( const std::vector<const skeleton2d*>& keypoints, skeleton2d& fused_keypoints, skeleton3d& fused_skeleton )
+{
+    // Layout of Fused Skeletons (Same Joints as First Member)
+    fused_keypoints.clear();
+    fused_keypoints.offsets.push_back( 0 );
+    for( size_t i = 0; i < cluster_count; i++ ){
+        const member& first = clusters[i].front();
+        const skeleton2d& source = *keypoints[first.device];
+        const int32_t begin = source.offsets[first.skeleton];
+        const int32_t end = source.offsets[first.skeleton + 1];
+        fused_keypoints.ids.push_back( source.ids[first.skeleton] );
+        fused_keypoints.x.insert( fused_keypoints.x.end(), source.x.begin() + begin, source.x.begin() + end );
+        fused_keypoints.y.insert( fused_keypoints.y.end(), source.y.begin() + begin, source.y.begin() + end );
+        fused_keypoints.confidences.insert( fused_keypoints.confidences.end(), end - begin, 0.0f );
+        fused_keypoints.offsets.push_back( static_cast<int32_t>( fused_keypoints.x.size() ) );
+    }
+    fused_skeleton.reset( fused_keypoints );
+
+    // Confidence Weighted Mean of Valid Joints
+    for( size_t i = 0; i < cluster_count; i++ ){
+        const int32_t offset = fused_keypoints.offsets[i];
+        const int32_t count = fused_keypoints.offsets[i + 1] - offset;
+        for( int32_t joint = 0; joint < count; joint++ ){
+            float x = 0.0f, y = 0.0f, z = 0.0f, weights = 0.0f, confidence = 0.0f;
+            for( const member& member : clusters[i] ){
+                const skeleton3d& skeleton = skeletons[member.device];
+                const int32_t begin = skeleton.offsets[member.skeleton];
+                if( skeleton.offsets[member.skeleton + 1] - begin <= joint ){
+                    continue;
+                }
+
+                const int32_t index = begin + joint;
+                const float score = keypoints[member.device]->confidences[index];
+                confidence = std::max( confidence, score );
+                if( !skeleton.valid[index] ){
+                    continue;
+                }
+
+                const float weight = std::max( score, std::numeric_limits<float>::epsilon() );
+                x += skeleton.x[index] * weight;
+                y += skeleton.y[index] * weight;
+                z += skeleton.z[index] * weight;
+                weights += weight;
+            }
+
+            const int32_t index = offset + joint;
+            fused_keypoints.confidences[index] = confidence;
+            fused_skeleton.valid[index] = ( weights > 0.0f ) ? 1 : 0;
+            fused_skeleton.x[index] = ( weights > 0.0f ) ? x / weights : 0.0f;
+            fused_skeleton.y[index] = ( weights > 0.0f ) ? y / weights : 0.0f;
+            fused_skeleton.z[index] = ( weights > 0.0f ) ? z / weights : 0.0f;
+        }
+    }
+}
+
+// Mean Distance of Common Valid Joints
+inline float skeleton_fusion::get_distance( const member& a, const member& b ) const
+{
+    constexpr int32_t minimum_joints = 3;
+
+    const skeleton3d& skeleton_a = skeletons[a.device];
+    const skeleton3d& skeleton_b = skeletons[b.device];
+    const int32_t begin_a = skeleton_a.offsets[a.skeleton];
+    const int32_t begin_b = skeleton_b.offsets[b.skeleton];
+    const int32_t count = std::min( skeleton_a.offsets[a.skeleton + 1] - begin_a, skeleton_b.offsets[b.skeleton + 1] - begin_b );
+
+    float sum = 0.0f;
+    int32_t joints = 0;
+    for( int32_t joint = 0; joint < count; joint++ ){
+        const int32_t index_a = begin_a + joint;
+        const int32_t index_b = begin_b + joint;
+        if( !skeleton_a.valid[index_a] || !skeleton_b.valid[index_b] ){
+            continue;
+        }
+
+        const float dx = skeleton_a.x[index_a] - skeleton_b.x[index_b];
+        const float dy = skeleton_a.y[index_a] - skeleton_b.y[index_b];
+        const float dz = skeleton_a.z[index_a] - skeleton_b.z[index_b];
+        sum += std::sqrt( dx * dx + dy * dy + dz * dz );
+        joints++;
+    }
+
+    return ( joints < minimum_joints ) ? -1.0f : sum / joints;
+}
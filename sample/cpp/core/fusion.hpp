@@ -0,0 +1,76 @@
+#ifndef __FUSION__
+#define __FUSION__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "skeleton.hpp"
+
+/*
+ This is fusion of skeletons of several devices into common coordinate.
+
+ Skeletons of each device are transformed with extrinsics of device (camera coordinate -> common coordinate),
+ and skeletons of different devices are associated greedily if mean distance of their common valid joints is within threshold.
+ Each joint of fused skeleton is confidence weighted mean of valid joints of associated skeletons.
+ Tracking id and 2D keypoints of fused skeleton are taken from first device that sees person.
+
+ Extrinsics file is YAML (or JSON) of OpenCV FileStorage, and has rotation (row-major 3x3) and translation [m] of each device.
+
+ %YAML:1.0
+ devices:
+   - { rotation: [ 1, 0, 0, 0, 1, 0, 0, 0, 1 ], translation: [ 0, 0, 0 ] }
+   - { rotation: [ 0, 0, -1, 0, 1, 0, 1, 0, 0 ], translation: [ 1.5, 0, 1.5 ] }
+
+ skeleton_fusion fusion( load_extrinsics( "extrinsics.yaml" ) );
+ fusion.fuse( { &keypoints0, &keypoints1 }, { &skeleton0, &skeleton1 }, fused_keypoints, fused_skeleton );
+*/
+
+// Extrinsics (Camera Coordinate of Device -> Common Coordinate)
+struct extrinsics
+{
+    float rotation[9] = { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f }; // row-major 3x3
+    float translation[3] = { 0.0f, 0.0f, 0.0f };                                   // [m]
+};
+
+// Load Extrinsics of Devices from File
+std::vector<extrinsics> load_extrinsics( const std::string& path );
+
+class skeleton_fusion
+{
+private:
+    // Member of Cluster (Skeleton of Device)
+    struct member
+    {
+        size_t device;
+        size_t skeleton;
+    };
+
+    std::vector<extrinsics> transforms;
+    float distance;           // max mean distance of associated skeletons [m]
+    std::vector<skeleton3d> skeletons; // skeletons of each device in common coordinate (recycled)
+    std::vector<std::vector<member>> clusters; // associated skeletons of each person (recycled)
+    size_t cluster_count;
+
+public:
+    // Constructor
+    skeleton_fusion( const std::vector<extrinsics>& transforms, const float distance = 0.3f );
+
+    // Fuse Skeletons of Devices (Ordered by Device)
+    void fuse( const std::vector<const skeleton2d*>& keypoints, const std::vector<const skeleton3d*>& skeletons, skeleton2d& fused_keypoints, skeleton3d& fused_skeleton );
+
+private:
+    // Transform Skeletons of Each Device into Common Coordinate
+    void update_transformation( const std::vector<const skeleton3d*>& skeletons );
+
+    // Associate Skeletons of Devices into Clusters
+    void update_association();
+
+    // Merge Clusters into Fused Skeletons
+    void update_fusion( const std::vector<const skeleton2d*>& keypoints, skeleton2d& fused_keypoints, skeleton3d& fused_skeleton );
+
+    // Mean Distance of Common Valid Joints (Negative if Not Enough Joints)
+    float get_distance( const member& a, const member& b ) const;
+};
+
+#endif // __FUSION__
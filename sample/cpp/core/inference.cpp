@@ -0,0 +1,147 @@
+#include "inference.hpp"
+
+#include <algorithm>
+
+// Constructor
+inference_ring::inference_ring( backend& backend, const size_t depth, const int32_t size, const std::chrono::milliseconds timeout )
+    : inference_backend( backend ),
+      slots( std::max<size_t>( depth, 1 ) ),
+      size( size ),
+      timeout( timeout ),
+      head( 0 ),
+      count( 0 )
+{
+    // Create Async Requests
+    for( slot& slot : slots ){
+        CHECK_SUCCESS( inference_backend.create_async_request( slot.request ) );
+    }
+}
+
+// Destructor
+inference_ring::~inference_ring()
+{
+    // Drain In-Flight Requests
+    while( !empty() ){
+        CM_SKEL_Buffer buffer = CM_SKEL_Buffer();
+        size_t slot;
+        if( retrieve( &buffer, slot ) == CM_ReturnCode::CM_SUCCESS ){
+            inference_backend.release_buffer( &buffer );
+        }
+    }
+
+    // Async Requests are Destroyed with Backend
+}
+
+// Submit Frame (Start Async Inference)
+size_t inference_ring::submit( const cv::Mat& frame )
+{
+    if( full() ){
+        throw std::runtime_error( "failed to submit (all requests are in flight)!" );
+    }
+
+    // Keep Frame until Result is Retrieved
+    const size_t index = ( head + count ) % slots.size();
+    slot& slot = slots[index];
+    slot.frame = frame;
+
+    // Create Image
+    CM_Image image = CM_Image{
+        reinterpret_cast<void*>( slot.frame.data ),
+        CM_Datatype::CM_UINT8,
+        slot.frame.cols,
+        slot.frame.rows,
+        slot.frame.channels(),
+        static_cast<int32_t>( slot.frame.step[0] ),
+        CM_MemoryOrder::CM_HWC
+    };
+
+    // Async Inference
+    CHECK_SUCCESS( inference_backend.estimate_keypoints_start_async( slot.request, image, size ) );
+    count++;
+
+    return index;
+}
+
+// Retrieve Oldest Result (Wait for Keypoints)
+CM_ReturnCode inference_ring::retrieve( CM_SKEL_Buffer* buffer, size_t& slot )
+{
+    if( empty() ){
+        throw std::runtime_error( "failed to retrieve (no request is in flight)!" );
+    }
+
+    // Get Inference Result (Request is Still Running on Timeout, so It is Kept in Flight)
+    const CM_ReturnCode result = inference_backend.wait_for_keypoints( slots[head].request, buffer, static_cast<int32_t>( timeout.count() ) );
+    if( result == CM_ReturnCode::CM_TIMEOUT ){
+        return result;
+    }
+
+    // Advance Ring
+    slot = head;
+    head = ( head + 1 ) % slots.size();
+    count--;
+
+    return result;
+}
+
+// Retrieve Oldest Result if Completed
+bool inference_ring::try_retrieve( CM_SKEL_Buffer* buffer, size_t& slot, CM_ReturnCode& result )
+{
+    if( empty() ){
+        throw std::runtime_error( "failed to retrieve (no request is in flight)!" );
+    }
+
+    // Poll Inference Result
+    result = inference_backend.wait_for_keypoints( slots[head].request, buffer, 0 );
+    if( result == CM_ReturnCode::CM_TIMEOUT ){
+        return false;
+    }
+
+    // Advance Ring
+    slot = head;
+    head = ( head + 1 ) % slots.size();
+    count--;
+
+    return true;
+}
+
+// Frame of Slot (Valid until Next Submit)
+cv::Mat& inference_ring::frame( const size_t slot )
+{
+    return slots[slot].frame;
+}
+
+// Set Network Input Size of Next Submits
+void inference_ring::set_size( const int32_t size )
+{
+    this->size = size;
+}
+
+// Network Input Size
+int32_t inference_ring::get_size() const
+{
+    return size;
+}
+
+// Number of Slots
+size_t inference_ring::depth() const
+{
+    return slots.size();
+}
+
+// Number of In-Flight Slots
+size_t inference_ring::in_flight() const
+{
+    return count;
+}
+
+// Check Empty
+bool inference_ring::empty() const
+{
+    return count == 0;
+}
+
+// Check Full
+bool inference_ring::full() const
+{
+    return count == slots.size();
+}
@@ -0,0 +1,86 @@
+#ifndef __INFERENCE__
+#define __INFERENCE__
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+#include <cubemos/skeleton_tracking.h>
+
+#include "util.hpp"
+#include "backend.hpp"
+
+/*
+ This is ring of async request handles that keeps several inferences in flight.
+
+ While the oldest request is running, following frames can be captured and submitted.
+ Results are always retrieved in the same order as frames were submitted.
+
+ inference_ring ring( backend, 2 );
+ if( ring.full() ){
+     size_t slot;
+     CM_ReturnCode result = ring.retrieve( buffer.get(), slot );
+     if( result == CM_ReturnCode::CM_TIMEOUT ){
+         ... // request is still in flight, retrieve again later
+     }
+     cv::Mat& frame = ring.frame( slot ); // frame that buffer belongs to
+ }
+ ring.submit( frame );
+*/
+class inference_ring
+{
+private:
+    // Slot
+    struct slot
+    {
+        size_t request = 0;
+        cv::Mat frame; // keep input image alive until result is retrieved
+    };
+
+    // Backend
+    backend& inference_backend;
+    std::vector<slot> slots;
+    int32_t size;
+    std::chrono::milliseconds timeout;
+
+    // Ring
+    size_t head;  // oldest in-flight slot
+    size_t count; // number of in-flight slots
+
+public:
+    // Constructor
+    inference_ring( backend& backend, const size_t depth = 2, const int32_t size = MULTIPLE * 12, const std::chrono::milliseconds timeout = std::chrono::milliseconds( 1000 ) );
+
+    // Destructor
+    ~inference_ring();
+
+    inference_ring( const inference_ring& ) = delete;
+    inference_ring& operator=( const inference_ring& ) = delete;
+
+    // Submit Frame (Start Async Inference)
+    size_t submit( const cv::Mat& frame );
+
+    // Retrieve Oldest Result (Wait for Keypoints, Return CM_TIMEOUT and Keep Request in Flight if Oldest Request is Still Running)
+    CM_ReturnCode retrieve( CM_SKEL_Buffer* buffer, size_t& slot );
+
+    // Retrieve Oldest Result if Completed (Never Wait, Return false if Oldest Request is Still Running)
+    bool try_retrieve( CM_SKEL_Buffer* buffer, size_t& slot, CM_ReturnCode& result );
+
+    // Frame of Slot
+    cv::Mat& frame( const size_t slot );
+
+    // Set Network Input Size of Next Submits (In-Flight Requests Keep Previous Size)
+    void set_size( const int32_t size );
+
+    // Network Input Size
+    int32_t get_size() const;
+
+    // Status
+    size_t depth() const;
+    size_t in_flight() const;
+    bool empty() const;
+    bool full() const;
+};
+
+#endif // __INFERENCE__
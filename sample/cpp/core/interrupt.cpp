@@ -0,0 +1,28 @@
+#include "interrupt.hpp"
+
+#include <csignal>
+
+namespace
+{
+    // Flag (Only Lock-Free Atomic Access is Allowed in Signal Handler)
+    volatile std::sig_atomic_t interrupted = 0;
+
+    // Handler
+    extern "C" void handle_interrupt( int signal )
+    {
+        interrupted = 1;
+    }
+}
+
+// Install Handler of SIGINT and SIGTERM
+void install_interrupt_handler()
+{
+    std::signal( SIGINT, handle_interrupt );
+    std::signal( SIGTERM, handle_interrupt );
+}
+
+// Check SIGINT or SIGTERM is Received
+bool is_interrupted()
+{
+    return interrupted != 0;
+}
@@ -0,0 +1,19 @@
+#ifndef __INTERRUPT__
+#define __INTERRUPT__
+
+/*
+ This is handler of SIGINT/SIGTERM to stop main loop cleanly.
+
+ install_interrupt_handler();
+ while( !is_interrupted() ){
+     ...
+ }
+*/
+
+// Install Handler of SIGINT and SIGTERM
+void install_interrupt_handler();
+
+// Check SIGINT or SIGTERM is Received
+bool is_interrupted();
+
+#endif // __INTERRUPT__
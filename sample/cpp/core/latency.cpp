@@ -0,0 +1,129 @@
+#include <algorithm>
+
+#include "latency.hpp"
+
+namespace
+{
+    // Percentile of Sorted Ages (Nearest Rank)
+    std::chrono::nanoseconds percentile( const std::vector<std::chrono::nanoseconds>& ages, const double rank )
+    {
+        const size_t index = std::min( ages.size() - 1, static_cast<size_t>( rank * ages.size() ) );
+        return ages[index];
+    }
+}
+
+// Constructor
+latency_monitor::latency_monitor( const std::chrono::nanoseconds budget, const std::chrono::nanoseconds window, const size_t capacity )
+    : records( std::max<size_t>( capacity, 1 ) ),
+      next( 0 ),
+      count( 0 ),
+      window( window ),
+      budget( budget )
+{
+}
+
+// Record Published Frame
+bool latency_monitor::record( const frame& frame )
+{
+    // Sensor Time Falls Back to Arrival if Source has No Sensor Clock
+    record_entry entry;
+    entry.arrival = frame.timestamp;
+    entry.sensor = ( frame.sensor_timestamp.count() != 0 ) ? frame.sensor_timestamp : frame.timestamp;
+    entry.inference_start = frame.inference_start;
+    entry.inference_end = frame.inference_end;
+    entry.publish = frame.publish_timestamp;
+
+    std::lock_guard<std::mutex> lock( mutex );
+    records[next] = entry;
+    next = ( next + 1 ) % records.size();
+    count = std::min( count + 1, records.size() );
+
+    return 0 < budget.count() && budget < entry.publish - entry.sensor;
+}
+
+// Compute Metrics of Results within Window
+latency_metrics latency_monitor::metrics() const
+{
+    // Collect Recent Results (Window Ends at Latest Publish)
+    std::vector<record_entry> recent;
+    std::chrono::nanoseconds limit;
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        recent.reserve( count );
+        for( size_t i = 0; i < count; i++ ){
+            recent.push_back( records[( next + records.size() - count + i ) % records.size()] );
+        }
+        limit = budget;
+    }
+
+    latency_metrics metrics;
+    if( recent.empty() ){
+        return metrics;
+    }
+
+    // Ages and Breakdown (Propagated Frames of Skipping have No Inference)
+    const std::chrono::nanoseconds end = recent.back().publish;
+    std::vector<std::chrono::nanoseconds> ages;
+    std::chrono::nanoseconds transport( 0 ), queue( 0 ), inference( 0 ), output( 0 );
+    uint64_t inferred = 0;
+    for( const record_entry& entry : recent ){
+        if( entry.publish < end - window ){
+            continue;
+        }
+
+        const std::chrono::nanoseconds age = entry.publish - entry.sensor;
+        ages.push_back( age );
+        transport += entry.arrival - entry.sensor;
+        if( 0 < limit.count() && limit < age ){
+            metrics.violations++;
+        }
+
+        if( entry.inference_start.count() != 0 && entry.inference_end.count() != 0 ){
+            queue += entry.inference_start - entry.arrival;
+            inference += entry.inference_end - entry.inference_start;
+            output += entry.publish - entry.inference_end;
+            inferred++;
+        }
+    }
+
+    // Percentiles of Age
+    std::sort( ages.begin(), ages.end() );
+    metrics.count = ages.size();
+    metrics.p50 = percentile( ages, 0.50 );
+    metrics.p95 = percentile( ages, 0.95 );
+    metrics.p99 = percentile( ages, 0.99 );
+    metrics.max = ages.back();
+    metrics.violated = ( 0 < limit.count() && limit < metrics.p99 );
+
+    // Mean of Breakdown
+    metrics.transport = transport / static_cast<int64_t>( ages.size() );
+    if( inferred != 0 ){
+        metrics.queue = queue / static_cast<int64_t>( inferred );
+        metrics.inference = inference / static_cast<int64_t>( inferred );
+        metrics.output = output / static_cast<int64_t>( inferred );
+    }
+
+    return metrics;
+}
+
+// Set Budget of SLO
+void latency_monitor::set_budget( const std::chrono::nanoseconds budget )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    this->budget = budget;
+}
+
+// Budget of SLO
+std::chrono::nanoseconds latency_monitor::get_budget() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return budget;
+}
+
+// Discard Recorded Results
+void latency_monitor::reset()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    next = 0;
+    count = 0;
+}
@@ -0,0 +1,88 @@
+#ifndef __LATENCY__
+#define __LATENCY__
+
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "source.hpp"
+
+/*
+ This is rolling monitor of age of published results that is used to enforce latency SLO.
+
+ Each published frame carries sensor time (on host clock), arrival time, inference start/end and publish time,
+ so age of result (sensor time to publish) is broken down into transport (sensor to arrival),
+ queue (arrival to inference start), inference (start to end) and output (inference end to publish).
+ Recent results within window are kept in preallocated ring, and metrics are computed on demand from any thread.
+ Results older than budget are counted as violations, and SLO is violated if p99 of age exceeds budget.
+
+ latency_monitor monitor( std::chrono::milliseconds( 100 ) );
+ monitor.record( frame ); // after publish (true if age exceeds budget)
+ const latency_metrics metrics = monitor.metrics();
+ if( metrics.violated ){
+     ...
+ }
+*/
+
+// Metrics of Recent Results (Durations are 0 if No Result)
+struct latency_metrics
+{
+    uint64_t count = 0;                                            // results in window
+    uint64_t violations = 0;                                       // results older than budget in window
+    bool violated = false;                                         // p99 of age exceeds budget
+    std::chrono::nanoseconds p50 = std::chrono::nanoseconds( 0 );  // age of result (sensor time to publish)
+    std::chrono::nanoseconds p95 = std::chrono::nanoseconds( 0 );
+    std::chrono::nanoseconds p99 = std::chrono::nanoseconds( 0 );
+    std::chrono::nanoseconds max = std::chrono::nanoseconds( 0 );
+    std::chrono::nanoseconds transport = std::chrono::nanoseconds( 0 ); // mean of sensor time to arrival
+    std::chrono::nanoseconds queue = std::chrono::nanoseconds( 0 );     // mean of arrival to inference start
+    std::chrono::nanoseconds inference = std::chrono::nanoseconds( 0 ); // mean of inference start to end
+    std::chrono::nanoseconds output = std::chrono::nanoseconds( 0 );    // mean of inference end to publish
+};
+
+class latency_monitor
+{
+private:
+    // Timeline of Result
+    struct record_entry
+    {
+        std::chrono::nanoseconds sensor;
+        std::chrono::nanoseconds arrival;
+        std::chrono::nanoseconds inference_start;
+        std::chrono::nanoseconds inference_end;
+        std::chrono::nanoseconds publish;
+    };
+
+    std::vector<record_entry> records;
+    size_t next;
+    size_t count;
+    std::chrono::nanoseconds window;
+    std::chrono::nanoseconds budget;
+    mutable std::mutex mutex;
+
+public:
+    // Constructor (Budget 0 means No SLO)
+    latency_monitor( const std::chrono::nanoseconds budget = std::chrono::nanoseconds( 0 ), const std::chrono::nanoseconds window = std::chrono::seconds( 5 ), const size_t capacity = 1024 );
+
+    latency_monitor( const latency_monitor& ) = delete;
+    latency_monitor& operator=( const latency_monitor& ) = delete;
+
+    // Record Published Frame (Publish Time is Set, Return true if Age Exceeds Budget)
+    bool record( const frame& frame );
+
+    // Compute Metrics of Results within Window
+    latency_metrics metrics() const;
+
+    // Set Budget of SLO (0 means No SLO)
+    void set_budget( const std::chrono::nanoseconds budget );
+
+    // Budget of SLO
+    std::chrono::nanoseconds get_budget() const;
+
+    // Discard Recorded Results
+    void reset();
+};
+
+#endif // __LATENCY__
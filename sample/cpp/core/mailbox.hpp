@@ -0,0 +1,97 @@
+#ifndef __MAILBOX__
+#define __MAILBOX__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/*
+ This is lock-free single-slot mailbox between one producer thread and one consumer thread.
+
+ It is triple buffer, so producer and consumer never wait for each other.
+ Producer always writes into its own back buffer, and publish swaps it with slot.
+ If consumer doesn't fetch before next publish, stale value in slot is overwritten (dropped).
+ Buffers are recycled, so steady-state operation allocates nothing if T reuses its capacity.
+
+ mailbox<packet> mailbox;
+
+ // Producer
+ packet& back = mailbox.back();
+ back.value = value;
+ mailbox.publish();
+
+ // Consumer
+ if( mailbox.fetch() ){
+     const packet& front = mailbox.front();
+ }
+*/
+template<typename T>
+class mailbox
+{
+private:
+    // Buffers
+    std::array<T, 3> buffers;
+    uint8_t back_index;
+    uint8_t front_index;
+
+    // Slot (Index of Middle Buffer and Fresh Flag)
+    static constexpr uint8_t fresh = 0x80;
+    std::atomic<uint8_t> slot;
+
+    // Drop Counter
+    std::atomic<uint64_t> drop_count;
+
+public:
+    // Constructor
+    mailbox()
+        : back_index( 0 ),
+          front_index( 1 ),
+          slot( 2 ),
+          drop_count( 0 )
+    {
+    }
+
+    mailbox( const mailbox& ) = delete;
+    mailbox& operator=( const mailbox& ) = delete;
+
+    // Back Buffer (Producer Only)
+    T& back()
+    {
+        return buffers[back_index];
+    }
+
+    // Publish Back Buffer (Producer Only)
+    void publish()
+    {
+        const uint8_t previous = slot.exchange( back_index | fresh, std::memory_order_acq_rel );
+        if( previous & fresh ){
+            drop_count.fetch_add( 1, std::memory_order_relaxed );
+        }
+        back_index = static_cast<uint8_t>( previous & ~fresh );
+    }
+
+    // Fetch Latest Published Buffer into Front Buffer (Consumer Only, Return false if Nothing New)
+    bool fetch()
+    {
+        if( !( slot.load( std::memory_order_relaxed ) & fresh ) ){
+            return false;
+        }
+
+        front_index = static_cast<uint8_t>( slot.exchange( front_index, std::memory_order_acq_rel ) & ~fresh );
+        return true;
+    }
+
+    // Front Buffer (Consumer Only)
+    T& front()
+    {
+        return buffers[front_index];
+    }
+
+    // Number of Dropped (Overwritten before Fetch) Values
+    uint64_t drops() const
+    {
+        return drop_count.load( std::memory_order_relaxed );
+    }
+};
+
+#endif // __MAILBOX__
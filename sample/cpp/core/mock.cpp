@@ -0,0 +1,224 @@
+#include "mock.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+namespace
+{
+    // Template Pose of 18 Keypoints (x: -0.5 to 0.5 of width, y: 0.0 to 1.0 of height)
+    constexpr std::array<std::array<float, 2>, mock_backend::keypoints> pose = { {
+        {  0.00f, 0.06f }, // nose
+        {  0.00f, 0.18f }, // neck
+        { -0.18f, 0.18f }, // right shoulder
+        { -0.26f, 0.36f }, // right elbow
+        { -0.30f, 0.52f }, // right wrist
+        {  0.18f, 0.18f }, // left shoulder
+        {  0.26f, 0.36f }, // left elbow
+        {  0.30f, 0.52f }, // left wrist
+        { -0.10f, 0.54f }, // right hip
+        { -0.12f, 0.76f }, // right knee
+        { -0.13f, 0.98f }, // right ankle
+        {  0.10f, 0.54f }, // left hip
+        {  0.12f, 0.76f }, // left knee
+        {  0.13f, 0.98f }, // left ankle
+        { -0.04f, 0.04f }, // right eye
+        {  0.04f, 0.04f }, // left eye
+        { -0.08f, 0.05f }, // right ear
+        {  0.08f, 0.05f }  // left ear
+    } };
+}
+
+// Constructor
+mock_backend::mock_backend( const std::chrono::microseconds latency, const int32_t persons )
+    : latency( latency ),
+      device_free_time( clock::now() ),
+      frame_index( 0 ),
+      persons( persons ),
+      next_id( 0 )
+{
+}
+
+// Destructor
+mock_backend::~mock_backend()
+{
+}
+
+// Create Handle (License is Not Required)
+CM_ReturnCode mock_backend::create_handle( const std::string& license_directory )
+{
+    return CM_ReturnCode::CM_SUCCESS;
+}
+
+// Load Model (Model is Not Required)
+CM_ReturnCode mock_backend::load_model( const CM_TargetComputeDevice target_device, const std::string& model )
+{
+    return CM_ReturnCode::CM_SUCCESS;
+}
+
+// Create Async Request
+CM_ReturnCode mock_backend::create_async_request( size_t& request )
+{
+    request = requests.size();
+    requests.push_back( mock_backend::request() );
+
+    return CM_ReturnCode::CM_SUCCESS;
+}
+
+// Start Async Inference
+CM_ReturnCode mock_backend::estimate_keypoints_start_async( const size_t request, const CM_Image& image, const int32_t size )
+{
+    if( request >= requests.size() || requests[request].busy ){
+        return CM_ReturnCode::CM_INVALID_ARGUMENT;
+    }
+
+    if( image.data == nullptr || image.dataType != CM_Datatype::CM_UINT8 || image.nChannels != 3 ){
+        return CM_ReturnCode::CM_INVALID_ARGUMENT;
+    }
+
+    // Requests are Processed One by One (Latency Scales with Area of Network Input)
+    const double scale = ( 0 < size ) ? static_cast<double>( size ) / ( MULTIPLE * 12 ) : 1.0;
+    const clock::time_point now = clock::now();
+    const clock::time_point start_time = std::max( now, device_free_time );
+    device_free_time = start_time + std::chrono::duration_cast<clock::duration>( latency * ( scale * scale ) );
+
+    mock_backend::request& target = requests[request];
+    target.busy = true;
+    target.completion_time = device_free_time;
+    target.width = image.nWidth;
+    target.height = image.nHeight;
+    target.index = frame_index++;
+
+    return CM_ReturnCode::CM_SUCCESS;
+}
+
+// Wait for Keypoints
+CM_ReturnCode mock_backend::wait_for_keypoints( const size_t request, CM_SKEL_Buffer* buffer, const int32_t timeout )
+{
+    if( request >= requests.size() || !requests[request].busy || buffer == nullptr ){
+        return CM_ReturnCode::CM_INVALID_ARGUMENT;
+    }
+
+    // Wait until Synthetic Inference is Completed (Request Stays Busy at Timeout)
+    mock_backend::request& target = requests[request];
+    if( timeout >= 0 && target.completion_time > clock::now() + std::chrono::milliseconds( timeout ) ){
+        std::this_thread::sleep_for( std::chrono::milliseconds( timeout ) );
+        return CM_ReturnCode::CM_TIMEOUT;
+    }
+    std::this_thread::sleep_until( target.completion_time );
+    target.busy = false;
+
+    // Generate Synthetic Skeletons
+    generate( buffer, target.index, persons, target.width, target.height );
+
+    return CM_ReturnCode::CM_SUCCESS;
+}
+
+// Update Tracking ID
+CM_ReturnCode mock_backend::update_tracking_id( const CM_SKEL_Buffer* previous_buffer, CM_SKEL_Buffer* buffer )
+{
+    if( previous_buffer == nullptr || buffer == nullptr ){
+        return CM_ReturnCode::CM_INVALID_ARGUMENT;
+    }
+
+    // Synthetic Persons Keep Same Order, so Inherit ID by Index
+    for( int32_t i = 0; i < buffer->numSkeletons; i++ ){
+        if( i < previous_buffer->numSkeletons && previous_buffer->skeletons[i].id >= 0 ){
+            buffer->skeletons[i].id = previous_buffer->skeletons[i].id;
+        }
+        else{
+            buffer->skeletons[i].id = next_id++;
+        }
+    }
+
+    return CM_ReturnCode::CM_SUCCESS;
+}
+
+// Release Buffer
+void mock_backend::release_buffer( CM_SKEL_Buffer* buffer )
+{
+    if( buffer == nullptr || buffer->skeletons == nullptr ){
+        return;
+    }
+
+    for( int32_t i = 0; i < buffer->numSkeletons; i++ ){
+        delete[] buffer->skeletons[i].keypoints_coord_x;
+        delete[] buffer->skeletons[i].keypoints_coord_y;
+        delete[] buffer->skeletons[i].confidences;
+    }
+    delete[] buffer->skeletons;
+
+    buffer->skeletons = nullptr;
+    buffer->numSkeletons = 0;
+}
+
+// Generate Synthetic Skeletons
+void mock_backend::generate( CM_SKEL_Buffer* buffer, const uint64_t index, const int32_t persons, const int32_t width, const int32_t height )
+{
+    // Allocate Skeletons (Same as SDK, Released by release_buffer())
+    buffer->numSkeletons = persons;
+    buffer->skeletons = new CM_SKEL_KeypointsBuffer[persons];
+
+    const float person_width = 0.4f * height;
+    const float person_height = 0.8f * height;
+    for( int32_t i = 0; i < persons; i++ ){
+        CM_SKEL_KeypointsBuffer& skeleton = buffer->skeletons[i];
+        skeleton.id = -1;
+        skeleton.numKeyPoints = keypoints;
+        skeleton.keypoints_coord_x = new float[keypoints];
+        skeleton.keypoints_coord_y = new float[keypoints];
+        skeleton.confidences = new float[keypoints];
+
+        // Persons Sway Left and Right Slowly
+        const float phase = 0.05f * static_cast<float>( index ) + static_cast<float>( i );
+        const float center_x = width * ( i + 1.0f ) / ( persons + 1.0f ) + 0.05f * width * std::sin( phase );
+        const float top_y = 0.1f * height;
+
+        for( int32_t j = 0; j < keypoints; j++ ){
+            skeleton.keypoints_coord_x[j] = center_x + pose[j][0] * person_width;
+            skeleton.keypoints_coord_y[j] = top_y + pose[j][1] * person_height;
+            skeleton.confidences[j] = ( ( index + i + j ) % 7 == 0 ) ? 0.3f : 0.9f;
+        }
+    }
+}
+
+// Constructor
+mock_source::mock_source( const int32_t width, const int32_t height, const uint64_t count )
+    : width( width ),
+      height( height ),
+      index( 0 ),
+      count( count )
+{
+}
+
+// Read Frame
+bool mock_source::read( frame& frame )
+{
+    if( count != 0 && index >= count ){
+        return false;
+    }
+
+    // Generate Synthetic Color Image into Recycled Buffer
+    const double value = static_cast<double>( index % 256 );
+    std::shared_ptr<cv::Mat> buffer = pool.acquire( cv::Size( width, height ), CV_8UC3 );
+    buffer->setTo( cv::Scalar( value, 128.0, 255.0 - value ) );
+    frame.color = *buffer;
+    frame.context = buffer;
+    index++;
+
+    return true;
+}
+
+// Name
+std::string mock_source::name() const
+{
+    return "skeleton (mock)";
+}
+
+// Number of Buffer Allocations
+uint64_t mock_source::allocations() const
+{
+    return pool.allocations();
+}
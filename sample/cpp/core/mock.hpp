@@ -0,0 +1,98 @@
+#ifndef __MOCK__
+#define __MOCK__
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+#include <cubemos/skeleton_tracking.h>
+
+#include "backend.hpp"
+#include "source.hpp"
+#include "pool.hpp"
+
+/*
+ This is mock backend that does not require Skeleton Tracking SDK and license.
+
+ It returns deterministic synthetic skeletons after configurable synthetic latency,
+ so pipeline (capture, conversion, tracking and drawing) can be profiled headlessly.
+ Requests are processed one by one like single inference device,
+ so latency of overlapped requests is accumulated.
+ Latency is for network input size of 192 ( MULTIPLE * 12 ), and scales with area of network input.
+
+ std::unique_ptr<backend> backend = std::make_unique<mock_backend>( std::chrono::milliseconds( 30 ), 2 );
+*/
+class mock_backend : public backend
+{
+private:
+    using clock = std::chrono::steady_clock;
+
+    // Request
+    struct request
+    {
+        bool busy = false;
+        clock::time_point completion_time;
+        int32_t width = 0;
+        int32_t height = 0;
+        uint64_t index = 0; // frame index used as seed of synthetic skeletons
+    };
+    std::vector<request> requests;
+
+    // Synthetic Inference
+    std::chrono::microseconds latency;
+    clock::time_point device_free_time;
+    uint64_t frame_index;
+
+    // Synthetic Skeletons
+    int32_t persons;
+    int32_t next_id;
+
+public:
+    // Number of Keypoints
+    static constexpr int32_t keypoints = 18;
+
+    // Constructor
+    mock_backend( const std::chrono::microseconds latency = std::chrono::milliseconds( 30 ), const int32_t persons = 2 );
+
+    // Destructor
+    ~mock_backend();
+
+    CM_ReturnCode create_handle( const std::string& license_directory ) override;
+    CM_ReturnCode load_model( const CM_TargetComputeDevice target_device, const std::string& model ) override;
+    CM_ReturnCode create_async_request( size_t& request ) override;
+    CM_ReturnCode estimate_keypoints_start_async( const size_t request, const CM_Image& image, const int32_t size ) override;
+    CM_ReturnCode wait_for_keypoints( const size_t request, CM_SKEL_Buffer* buffer, const int32_t timeout ) override;
+    CM_ReturnCode update_tracking_id( const CM_SKEL_Buffer* previous_buffer, CM_SKEL_Buffer* buffer ) override;
+    void release_buffer( CM_SKEL_Buffer* buffer ) override;
+
+    // Generate Synthetic Skeletons
+    static void generate( CM_SKEL_Buffer* buffer, const uint64_t index, const int32_t persons, const int32_t width, const int32_t height );
+};
+
+// Frame Source of Synthetic Color Image (No Device)
+class mock_source : public source
+{
+private:
+    // Image
+    int32_t width;
+    int32_t height;
+    uint64_t index;
+    uint64_t count;
+    frame_pool pool;
+
+public:
+    // Constructor (count = 0 means endless)
+    mock_source( const int32_t width = 1280, const int32_t height = 720, const uint64_t count = 0 );
+
+    // Read Frame
+    bool read( frame& frame ) override;
+
+    // Name
+    std::string name() const override;
+
+    // Number of Buffer Allocations
+    uint64_t allocations() const;
+};
+
+#endif // __MOCK__
@@ -0,0 +1,494 @@
+#include "option.hpp"
+#include "mock.hpp"
+#include "stream.hpp"
+#include "profiler.hpp"
+#include "orchestrator.hpp"
+
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+    // Check Path Ends with Extension
+    bool has_extension( const std::string& path, const std::string& extension )
+    {
+        return extension.size() < path.size() && path.compare( path.size() - extension.size(), extension.size(), extension ) == 0;
+    }
+
+    // Parse Number of Option (Whole Value must be Number in Range of Type, and Not Less than Minimum)
+    template<typename T>
+    T parse_number( const std::string& name, const std::string& value, const T minimum = std::numeric_limits<T>::lowest() )
+    {
+        std::istringstream stream( value );
+        T number = T();
+        if( value.empty() || ( std::is_unsigned<T>::value && value.find( '-' ) != std::string::npos ) || !( stream >> number ) || !stream.eof() || number < minimum ){
+            throw std::runtime_error( "failed to parse " + name + " " + value + " (invalid number)!" );
+        }
+        return number;
+    }
+
+    // Open Sink of Path
+    std::unique_ptr<sink> open_sink( const std::string& path )
+    {
+        // Binary Skeleton Stream
+        if( has_extension( path, ".skel" ) ){
+            return std::make_unique<stream_writer>( path );
+        }
+
+        // JSON Lines
+        return std::make_unique<text_sink>( path );
+    }
+
+    // Write Profile (Per-Frame Trace or Percentiles)
+    void write_profile( const options& options )
+    {
+        if( options.profile.empty() ){
+            return;
+        }
+
+        if( has_extension( options.profile, ".csv" ) ){
+            profiler::dump( options.profile );
+        }
+        else{
+            profiler::report( options.profile );
+        }
+    }
+
+    // Configure Orchestrator with Options (Reject Options Supported Only with Single Device)
+    void configure( orchestrator& orchestrator, const options& options )
+    {
+        if( get_skip_interval( options ) != 1 ){
+            throw std::runtime_error( "failed to run (--skip is supported only with single device)!" );
+        }
+        if( options.roi != 0 ){
+            throw std::runtime_error( "failed to run (--roi is supported only with single device)!" );
+        }
+
+        // Enable Profiler
+        profiler::enable( !options.profile.empty() );
+
+        // Adapt Inference Size to Budget
+        const resolution_policy policy = create_resolution_policy( options );
+        if( 0 < policy.budget.count() ){
+            orchestrator.adapt( policy );
+        }
+
+        // Tracking Method and Filter of Joints of Each Device
+        orchestrator.track( get_tracking_method( options ) );
+        orchestrator.smooth( create_filter_policy( options ) );
+
+        // Latency Budget of SLO
+        orchestrator.enforce( options.latency_slo );
+    }
+}
+
+// Parse Command Line Options
+options parse_options( int argc, char* argv[] )
+{
+    options options;
+    for( int32_t i = 1; i < argc; i++ ){
+        const std::string name = argv[i];
+        if( i + 1 >= argc ){
+            throw std::runtime_error( "failed to parse " + name + " (value is missing)!" );
+        }
+
+        const std::string value = argv[++i];
+        if( name == "--backend" ){
+            options.backend = value;
+        }
+        else if( name == "--mock-latency" ){
+            options.mock_latency = std::chrono::milliseconds( parse_number<int32_t>( name, value ) );
+        }
+        else if( name == "--mock-persons" ){
+            options.mock_persons = parse_number<int32_t>( name, value, 0 );
+        }
+        else if( name == "--depth" ){
+            options.depth = parse_number<size_t>( name, value );
+        }
+        else if( name == "--inference-size" ){
+            options.inference_size = parse_number<int32_t>( name, value );
+        }
+        else if( name == "--target-latency" ){
+            options.target_latency = std::chrono::milliseconds( parse_number<int64_t>( name, value ) );
+        }
+        else if( name == "--target-fps" ){
+            options.target_fps = parse_number<double>( name, value );
+        }
+        else if( name == "--latency-slo" ){
+            options.latency_slo = std::chrono::milliseconds( parse_number<int64_t>( name, value ) );
+        }
+        else if( name == "--skip" ){
+            options.skip = value;
+        }
+        else if( name == "--propagation" ){
+            options.propagation = value;
+        }
+        else if( name == "--tracking" ){
+            options.tracking = value;
+        }
+        else if( name == "--filter" ){
+            options.filter = value;
+        }
+        else if( name == "--roi" ){
+            options.roi = parse_number<int32_t>( name, value );
+        }
+        else if( name == "--input" ){
+            options.input = value;
+        }
+        else if( name == "--devices" ){
+            options.devices = parse_number<size_t>( name, value );
+        }
+        else if( name == "--replay" ){
+            options.replay = value;
+        }
+        else if( name == "--capture" ){
+            options.capture = value;
+        }
+        else if( name == "--sync" ){
+            options.sync = value;
+        }
+        else if( name == "--sync-tolerance" ){
+            options.sync_tolerance = std::chrono::microseconds( parse_number<int64_t>( name, value ) );
+        }
+        else if( name == "--extrinsics" ){
+            options.extrinsics = value;
+        }
+        else if( name == "--depth-window" ){
+            options.depth_window = parse_number<int32_t>( name, value );
+        }
+        else if( name == "--transformation" ){
+            options.transformation = value;
+        }
+        else if( name == "--mode" ){
+            options.mode = value;
+        }
+        else if( name == "--output" ){
+            options.output = value;
+        }
+        else if( name == "--frames" ){
+            options.frames = parse_number<uint64_t>( name, value );
+        }
+        else if( name == "--duration" ){
+            options.duration = std::chrono::seconds( parse_number<int64_t>( name, value ) );
+        }
+        else if( name == "--profile" ){
+            options.profile = value;
+        }
+        else{
+            throw std::runtime_error( "failed to parse " + name + " (unknown option)!" );
+        }
+    }
+
+    return options;
+}
+
+// Replay Input File with Recorded Timing
+bool is_realtime( const options& options )
+{
+    if( options.replay == "realtime" ){
+        return true;
+    }
+
+    if( options.replay == "max" ){
+        return false;
+    }
+
+    throw std::runtime_error( "failed to parse --replay " + options.replay + " (realtime or max)!" );
+}
+
+// Read Frames of Single Device on Capture Thread
+bool is_threaded_capture( const options& options )
+{
+    if( options.capture == "thread" ){
+        // Replay as Fast as Possible must not Drop Frames
+        return options.input.empty() || is_realtime( options );
+    }
+
+    if( options.capture == "inline" ){
+        return false;
+    }
+
+    throw std::runtime_error( "failed to parse --capture " + options.capture + " (thread or inline)!" );
+}
+
+// Devices are Wired Sync Rig
+bool is_synchronized( const options& options )
+{
+    if( options.sync == "standalone" ){
+        // Extrinsics are Only Used for Fusion of Wired Sync Rig
+        if( !options.extrinsics.empty() ){
+            throw std::runtime_error( "failed to run (--extrinsics is supported only with --sync wired)!" );
+        }
+        return false;
+    }
+
+    if( options.sync == "wired" ){
+        // Synchronized Frames are Fused Only in Headless Mode
+        if( options.mode != "headless" ){
+            throw std::runtime_error( "failed to run (--sync wired is supported only in headless mode)!" );
+        }
+        return true;
+    }
+
+    throw std::runtime_error( "failed to parse --sync " + options.sync + " (standalone or wired)!" );
+}
+
+// Create Synchronization from Options
+synchronization create_synchronization( const options& options, const std::vector<std::chrono::nanoseconds>& delays )
+{
+    ::synchronization synchronization;
+    synchronization.tolerance = options.sync_tolerance;
+    synchronization.delays = delays;
+    if( !options.extrinsics.empty() ){
+        synchronization.transforms = load_extrinsics( options.extrinsics );
+    }
+    if( !synchronization.transforms.empty() && synchronization.transforms.size() < delays.size() ){
+        throw std::runtime_error( "failed to load extrinsics " + options.extrinsics + " (number of devices is less than " + std::to_string( delays.size() ) + ")!" );
+    }
+
+    // Replay at Max Throughput must not Drop Frames of Slower File
+    synchronization.lossless = !options.input.empty() && !is_realtime( options );
+    return synchronization;
+}
+
+// Create Policy of Adaptive Inference Size from Options
+resolution_policy create_resolution_policy( const options& options )
+{
+    if( options.inference_size <= 0 || options.inference_size % MULTIPLE != 0 ){
+        throw std::runtime_error( "failed to parse --inference-size " + std::to_string( options.inference_size ) + " (multiple of " + std::to_string( MULTIPLE ) + ")!" );
+    }
+    if( 0 < options.target_latency.count() && 0.0 < options.target_fps ){
+        throw std::runtime_error( "failed to parse --target-latency and --target-fps (only one of them)!" );
+    }
+
+    resolution_policy policy;
+    if( 0 < options.target_latency.count() ){
+        policy.metric = budget_metric::latency;
+        policy.budget = options.target_latency;
+    }
+    else if( 0.0 < options.target_fps ){
+        policy.metric = budget_metric::interval;
+        policy.budget = std::chrono::nanoseconds( static_cast<int64_t>( 1000000000.0 / options.target_fps ) );
+    }
+    return policy;
+}
+
+// Interval of Inference
+size_t get_skip_interval( const options& options )
+{
+    if( options.skip == "auto" ){
+        return 0;
+    }
+
+    const int64_t interval = parse_number<int64_t>( "--skip", options.skip );
+    if( interval < 1 ){
+        throw std::runtime_error( "failed to parse --skip " + options.skip + " (positive number or auto)!" );
+    }
+    return static_cast<size_t>( interval );
+}
+
+// Propagation Mode of Keypoints to Skipped Frames
+propagation_mode get_propagation_mode( const options& options )
+{
+    if( options.propagation == "extrapolation" ){
+        return propagation_mode::extrapolation;
+    }
+
+    if( options.propagation == "flow" ){
+        return propagation_mode::flow;
+    }
+
+    throw std::runtime_error( "failed to parse --propagation " + options.propagation + " (extrapolation or flow)!" );
+}
+
+// Tracking Method of Tracking ID
+tracking_method get_tracking_method( const options& options )
+{
+    if( options.tracking == "hungarian" ){
+        return tracking_method::hungarian;
+    }
+
+    if( options.tracking == "greedy" ){
+        return tracking_method::greedy;
+    }
+
+    if( options.tracking == "backend" ){
+        return tracking_method::backend;
+    }
+
+    throw std::runtime_error( "failed to parse --tracking " + options.tracking + " (hungarian, greedy or backend)!" );
+}
+
+// Create Policy of Temporal Filter of Joints from Options
+filter_policy create_filter_policy( const options& options )
+{
+    filter_policy policy;
+    if( options.filter == "none" ){
+        policy.mode = filter_mode::none;
+    }
+    else if( options.filter == "one-euro" ){
+        policy.mode = filter_mode::one_euro;
+    }
+    else if( options.filter == "kalman" ){
+        policy.mode = filter_mode::kalman;
+    }
+    else{
+        throw std::runtime_error( "failed to parse --filter " + options.filter + " (none, one-euro or kalman)!" );
+    }
+    return policy;
+}
+
+// Create Backend from Options
+std::unique_ptr<backend> create_backend( const options& options )
+{
+    if( options.backend == "mock" ){
+        return std::make_unique<mock_backend>( options.mock_latency, options.mock_persons );
+    }
+
+#ifdef HAVE_CUBEMOS
+    if( options.backend == "cubemos" ){
+        return std::make_unique<cubemos_backend>();
+    }
+#endif
+
+    throw std::runtime_error( "failed to create " + options.backend + " backend (not available)!" );
+}
+
+// Split Input Files (Comma Separated)
+std::vector<std::string> get_inputs( const options& options )
+{
+    std::vector<std::string> inputs;
+    std::stringstream stream( options.input );
+    std::string input;
+    while( std::getline( stream, input, ',' ) ){
+        if( !input.empty() ){
+            inputs.push_back( input );
+        }
+    }
+    return inputs;
+}
+
+// Create Sink from Options
+std::unique_ptr<sink> create_sink( const options& options )
+{
+    return open_sink( options.output );
+}
+
+// Create Sink of Each Device from Options
+std::vector<std::unique_ptr<sink>> create_sinks( const options& options, const size_t count )
+{
+    std::vector<std::unique_ptr<sink>> sinks;
+    for( size_t i = 0; i < count; i++ ){
+        // Insert Index of Device before Extension (Standard Output is Shared)
+        std::string path = options.output;
+        const size_t separator = path.find_last_of( "/\\" );
+        const size_t dot = path.find_last_of( '.' );
+        if( 1 < count && path != "-" ){
+            const size_t position = ( dot != std::string::npos && ( separator == std::string::npos || separator < dot ) ) ? dot : path.size();
+            path.insert( position, "." + std::to_string( i ) );
+        }
+        sinks.push_back( open_sink( path ) );
+    }
+    return sinks;
+}
+
+// Create Limit from Options
+limit create_limit( const options& options )
+{
+    ::limit limit;
+    limit.frames = options.frames;
+    limit.duration = options.duration;
+    return limit;
+}
+
+// Run Engine in Mode of Options
+void run( engine& engine, source& source, const options& options )
+{
+    // Enable Profiler
+    profiler::enable( !options.profile.empty() );
+
+    // Adapt Inference Size to Budget
+    const resolution_policy policy = create_resolution_policy( options );
+    if( 0 < policy.budget.count() ){
+        engine.adapt( policy );
+    }
+
+    // Skip Inference of Frames
+    engine.skip( get_skip_interval( options ), get_propagation_mode( options ) );
+
+    // Tracking Method and Filter of Joints
+    engine.track( get_tracking_method( options ) );
+    engine.smooth( create_filter_policy( options ) );
+
+    // Latency Budget of SLO
+    engine.enforce( options.latency_slo );
+
+    // Crop Regions around Tracked People
+    engine.crop( options.roi );
+
+    // Read Frames on Capture Thread (Inference Always Sees Newest Frame)
+    std::unique_ptr<threaded_source> capture;
+    if( is_threaded_capture( options ) ){
+        capture = std::make_unique<threaded_source>( source );
+    }
+    ::source& frame_source = capture ? *capture : source;
+
+    if( options.mode == "window" ){
+        engine.run( frame_source, create_limit( options ) );
+    }
+    else if( options.mode == "headless" ){
+        const std::unique_ptr<sink> sink = create_sink( options );
+        engine.run( frame_source, *sink, create_limit( options ) );
+    }
+    else{
+        throw std::runtime_error( "failed to run in " + options.mode + " mode (window or headless)!" );
+    }
+
+    // Write Profile
+    write_profile( options );
+}
+
+// Run Orchestrator in Mode of Options
+void run( orchestrator& orchestrator, const std::vector<source*>& sources, const options& options )
+{
+    // Configure Orchestrator
+    configure( orchestrator, options );
+
+    if( options.mode == "window" ){
+        orchestrator.run( sources, create_limit( options ) );
+    }
+    else if( options.mode == "headless" ){
+        const std::vector<std::unique_ptr<sink>> sinks = create_sinks( options, sources.size() );
+        std::vector<sink*> pointers;
+        for( const std::unique_ptr<sink>& sink : sinks ){
+            pointers.push_back( sink.get() );
+        }
+        orchestrator.run( sources, pointers, create_limit( options ) );
+    }
+    else{
+        throw std::runtime_error( "failed to run in " + options.mode + " mode (window or headless)!" );
+    }
+
+    // Write Profile
+    write_profile( options );
+}
+
+// Run Orchestrator with Synchronized Sources in Mode of Options
+void run( orchestrator& orchestrator, const std::vector<source*>& sources, const synchronization& synchronization, const options& options )
+{
+    // Synchronized Frames are Fused Only in Headless Mode
+    if( options.mode != "headless" ){
+        throw std::runtime_error( "failed to run (--sync wired is supported only in headless mode)!" );
+    }
+
+    // Configure Orchestrator
+    configure( orchestrator, options );
+
+    const std::unique_ptr<sink> sink = create_sink( options );
+    orchestrator.run( sources, synchronization, *sink, create_limit( options ) );
+
+    // Write Profile
+    write_profile( options );
+}
@@ -0,0 +1,139 @@
+#ifndef __OPTION__
+#define __OPTION__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+#include "backend.hpp"
+#include "engine.hpp"
+#include "orchestrator.hpp"
+#include "source.hpp"
+#include "sink.hpp"
+#include "resolution.hpp"
+#include "propagation.hpp"
+#include "tracker.hpp"
+#include "filter.hpp"
+#include "capture.hpp"
+
+/*
+ This is command line options that are shared by all samples.
+
+ --backend <cubemos|mock> : inference backend (default: cubemos)
+ --mock-latency <ms>      : synthetic latency of mock backend (default: 30)
+ --mock-persons <n>       : number of synthetic persons of mock backend (default: 2)
+ --depth <n>              : number of in-flight inference requests (shared by all devices) (default: 2)
+ --inference-size <n>     : network input height (multiple of 16) (default: 192)
+ --target-latency <ms>    : adapt network input height to keep latency (sensor timestamp to result) within budget (default: 0 (fixed))
+ --target-fps <n>         : adapt network input height to keep FPS (default: 0 (fixed))
+ --latency-slo <ms>       : budget of age of result (sensor timestamp to publish), results older than budget are counted as slo_violations (default: 0 (no SLO))
+ --skip <n|auto>          : inference on every n-th frame, or whenever request is free, and keypoints of other frames are propagated (default: 1 (every frame))
+ --propagation <extrapolation|flow> : propagation of keypoints to skipped frames (default: extrapolation)
+ --tracking <hungarian|greedy|backend> : association of tracking id by native tracker (optimal or greedy), or by backend (default: hungarian)
+ --filter <none|one-euro|kalman> : temporal filter of 2D and 3D joints of each track (default: none)
+ --roi <n>                : infer mosaic of regions around tracked people, and full frame on every n-th inference (default: 0 (full frame))
+ --input <file|mock>      : input file (*.bag (RealSense), *.mkv (Azure Kinect), video, image or image directory), or synthetic frames (default: device)
+                            (comma separated files are replayed as several devices)
+ --devices <n>            : number of devices that share one model (default: 1)
+ --replay <realtime|max>  : replay input file with recorded timing, or as fast as possible (default: realtime)
+ --capture <thread|inline> : read frames on dedicated capture thread (newest frame wins, stale frames are dropped), or inline in processing loop
+                            (single device, replay as fast as possible always reads inline) (default: thread)
+ --sync <standalone|wired> : devices are independent, or wired sync rig (first device is master) that fuses skeletons (wired is headless mode only) (default: standalone)
+ --sync-tolerance <us>    : max difference of device timestamps of synchronized frames (default: 2000)
+ --extrinsics <file>      : extrinsics of each device into common coordinate (YAML or JSON) (--sync wired only) (default: identity)
+ --depth-window <n>       : window size of median filter for depth at keypoints (default: 3)
+ --transformation <sparse|dense> : transformation of depth to color camera (default: sparse)
+ --mode <window|headless> : show skeletons in window, or write skeletons to output without drawing (default: window)
+ --output <file|->        : output of headless mode (*.skel is binary skeleton stream, others are JSON Lines) (default: - (standard output))
+ --frames <n>             : stop after n frames (default: 0 (unlimited))
+ --duration <s>           : stop after s seconds (default: 0 (unlimited))
+ --profile <file|->       : write latency percentiles of each stage at exit (*.csv is per-frame trace) (default: disabled)
+*/
+struct options
+{
+    std::string backend = "cubemos";
+    std::chrono::milliseconds mock_latency = std::chrono::milliseconds( 30 );
+    int32_t mock_persons = 2;
+    size_t depth = 2;
+    int32_t inference_size = MULTIPLE * 12;
+    std::chrono::milliseconds target_latency = std::chrono::milliseconds( 0 );
+    double target_fps = 0.0;
+    std::chrono::milliseconds latency_slo = std::chrono::milliseconds( 0 );
+    std::string skip = "1";
+    std::string propagation = "extrapolation";
+    std::string tracking = "hungarian";
+    std::string filter = "none";
+    int32_t roi = 0;
+    std::string input;
+    size_t devices = 1;
+    std::string replay = "realtime";
+    std::string capture = "thread";
+    std::string sync = "standalone";
+    std::chrono::microseconds sync_tolerance = std::chrono::microseconds( 2000 );
+    std::string extrinsics;
+    int32_t depth_window = 3;
+    std::string transformation = "sparse";
+    std::string mode = "window";
+    std::string output = "-";
+    uint64_t frames = 0;
+    std::chrono::seconds duration = std::chrono::seconds( 0 );
+    std::string profile;
+};
+
+// Parse Command Line Options
+options parse_options( int argc, char* argv[] );
+
+// Replay Input File with Recorded Timing (false means max throughput)
+bool is_realtime( const options& options );
+
+// Read Frames of Single Device on Capture Thread (false means inline in processing loop)
+bool is_threaded_capture( const options& options );
+
+// Devices are Wired Sync Rig (false means standalone devices, Throw if Options of Rig are Not Supported in Mode)
+bool is_synchronized( const options& options );
+
+// Create Synchronization from Options with Sync Delay of Each Device
+synchronization create_synchronization( const options& options, const std::vector<std::chrono::nanoseconds>& delays );
+
+// Create Policy of Adaptive Inference Size from Options (Budget is 0 if Size is Fixed)
+resolution_policy create_resolution_policy( const options& options );
+
+// Interval of Inference (0 means whenever Request is Free, 1 means Every Frame)
+size_t get_skip_interval( const options& options );
+
+// Propagation Mode of Keypoints to Skipped Frames
+propagation_mode get_propagation_mode( const options& options );
+
+// Tracking Method of Tracking ID
+tracking_method get_tracking_method( const options& options );
+
+// Create Policy of Temporal Filter of Joints from Options
+filter_policy create_filter_policy( const options& options );
+
+// Create Backend from Options
+std::unique_ptr<backend> create_backend( const options& options );
+
+// Split Input Files (Comma Separated)
+std::vector<std::string> get_inputs( const options& options );
+
+// Create Sink from Options
+std::unique_ptr<sink> create_sink( const options& options );
+
+// Create Sink of Each Device from Options (Index of Device is Inserted before Extension)
+std::vector<std::unique_ptr<sink>> create_sinks( const options& options, const size_t count );
+
+// Create Limit from Options
+limit create_limit( const options& options );
+
+// Run Engine in Mode of Options (Window or Headless)
+void run( engine& engine, source& source, const options& options );
+
+// Run Orchestrator with Several Sources in Mode of Options (Window or Headless)
+void run( orchestrator& orchestrator, const std::vector<source*>& sources, const options& options );
+
+// Run Orchestrator with Synchronized Sources in Headless Mode (Fused Skeletons)
+void run( orchestrator& orchestrator, const std::vector<source*>& sources, const synchronization& synchronization, const options& options );
+
+#endif // __OPTION__
@@ -0,0 +1,585 @@
+#include "orchestrator.hpp"
+#include "profiler.hpp"
+
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+// Constructor
+orchestrator::orchestrator( std::unique_ptr<backend> backend, const size_t pool_size, const int32_t inference_size )
+    : inference_backend( std::move( backend ) ),
+      pool_size( std::max<size_t>( pool_size, 1 ) ),
+      inference_size( inference_size ),
+      buffer( create_skel_buffer( *inference_backend ) ),
+      tracking( tracking_method::hungarian ),
+      previous_result_time( 0 ),
+      running( false ),
+      next_device( 0 ),
+      quota( 1 ),
+      violations( 0 ),
+      synchronized_drops( 0 )
+{
+    // Initialize
+    initialize();
+}
+
+// Destructor
+orchestrator::~orchestrator()
+{
+    // Finalize
+    finalize();
+}
+
+// Run (Window of Each Device)
+void orchestrator::run( const std::vector<source*>& sources, const limit& limit )
+{
+    // Start Render Thread with Window of Each Device
+    std::vector<std::string> window_names;
+    for( const source* source : sources ){
+        window_names.push_back( source->name() );
+    }
+    renderer renderer( window_names );
+
+    // Schedule (Stop when Window is Closed)
+    start( sources );
+    schedule( limit, [&]( const size_t index ){
+        const device& device = *devices[index];
+        if( !device.result_frame.color.empty() ){
+            renderer.publish( index, device.result_frame, device.keypoints, device.skeleton );
+        }
+        return !renderer.closed();
+    } );
+    stop();
+}
+
+// Run (Headless, Sink of Each Device)
+void orchestrator::run( const std::vector<source*>& sources, const std::vector<sink*>& sinks, const limit& limit )
+{
+    if( sinks.size() != sources.size() ){
+        throw std::runtime_error( "failed to run (number of sinks is not equal to number of sources)!" );
+    }
+
+    // Schedule
+    start( sources );
+    schedule( limit, [&]( const size_t index ){
+        const device& device = *devices[index];
+        if( !device.result_frame.color.empty() ){
+            scoped_timer timer( stage::write, device.result_frame.index );
+            sinks[index]->write( device.result_frame, device.keypoints, device.skeleton );
+        }
+        return true;
+    } );
+    stop();
+
+    for( sink* sink : sinks ){
+        sink->flush();
+    }
+}
+
+// Run (Headless, Fused Skeletons of Frames Aligned by Device Timestamp)
+void orchestrator::run( const std::vector<source*>& sources, const synchronization& synchronization, sink& sink, const limit& limit )
+{
+    if( ring->depth() < sources.size() ){
+        throw std::runtime_error( "failed to run (pool is smaller than number of devices)!" );
+    }
+
+    // Create Aggregator with Sync Delay of Each Device
+    aggregator = std::make_unique<capture_aggregator>( sources.size(), synchronization.tolerance, 4, synchronization.lossless );
+    for( size_t i = 0; i < synchronization.delays.size() && i < sources.size(); i++ ){
+        aggregator->set_delay( i, synchronization.delays[i] );
+    }
+
+    // Schedule (Fuse Skeletons of Each Group)
+    skeleton_fusion fusion( synchronization.transforms );
+    std::vector<const skeleton2d*> keypoints;
+    std::vector<const skeleton3d*> skeletons;
+    skeleton2d fused_keypoints;
+    skeleton3d fused_skeleton;
+    start( sources );
+    for( const std::unique_ptr<device>& device : devices ){
+        keypoints.push_back( &device->keypoints );
+        skeletons.push_back( &device->skeleton );
+    }
+    schedule_synchronized( limit, [&](){
+        const frame& reference = devices.front()->result_frame;
+        {
+            scoped_timer timer( stage::fusion, reference.index );
+            fusion.fuse( keypoints, skeletons, fused_keypoints, fused_skeleton );
+        }
+
+        scoped_timer timer( stage::write, reference.index );
+        sink.write( reference, fused_keypoints, fused_skeleton );
+        return true;
+    } );
+    stop();
+
+    sink.flush();
+
+    // Destroy Aggregator (Capture Threads Publish into Mailbox in Other Modes)
+    synchronized_drops += aggregator->drops();
+    aggregator.reset();
+}
+
+// Adapt Inference Size to Budget of Policy
+void orchestrator::adapt( const resolution_policy& policy )
+{
+    controller = std::make_unique<resolution_controller>( policy, inference_size );
+    ring->set_size( controller->size() );
+}
+
+// Set Tracking Method of Tracking ID
+void orchestrator::track( const tracking_method method )
+{
+    tracking = method;
+}
+
+// Smooth Joints of Each Track of Each Device with Filters of Policy
+void orchestrator::smooth( const filter_policy& policy )
+{
+    smoothing = policy;
+}
+
+// Set Latency Budget of SLO
+void orchestrator::enforce( const std::chrono::nanoseconds budget )
+{
+    monitor.set_budget( budget );
+}
+
+// Get Rolling Metrics of Age of Published Results of All Devices
+latency_metrics orchestrator::get_latency() const
+{
+    return monitor.metrics();
+}
+
+// Number of Frames Dropped by Backpressure
+uint64_t orchestrator::drops() const
+{
+    uint64_t drops = synchronized_drops;
+    for( const std::unique_ptr<device>& device : devices ){
+        drops += device->frames.drops();
+    }
+    return drops;
+}
+
+// Initialize
+void orchestrator::initialize()
+{
+    cv::setUseOptimized( true );
+
+    // Initialize Skeleton
+    initialize_skeleton();
+}
+
+// Initialize Skeleton
+void orchestrator::initialize_skeleton()
+{
+    // Create Handle (Shared by All Devices)
+    CHECK_SUCCESS( inference_backend->create_handle( get_license_directory() ) );
+
+    // Load Model Once
+    const CM_TargetComputeDevice target_device = CM_TargetComputeDevice::CM_CPU;
+    const std::string model = get_model_file(); // FP32 model
+    //const std::string model = get_model_file( true ); // FP16 model
+    CHECK_SUCCESS( inference_backend->load_model( target_device, model ) );
+
+    // Create Pool of Async Requests
+    ring = std::make_unique<inference_ring>( *inference_backend, pool_size, inference_size );
+    frames.resize( ring->depth() );
+    owners.resize( ring->depth() );
+}
+
+// Finalize
+void orchestrator::finalize()
+{
+    // Stop Capture Threads
+    running = false;
+    if( aggregator ){
+        aggregator->stop();
+    }
+    for( const std::unique_ptr<device>& device : devices ){
+        if( device->thread.joinable() ){
+            device->thread.join();
+        }
+    }
+
+    // Drain In-Flight Requests (Handle is Destroyed with Backend)
+    ring.reset();
+    frames.clear();
+    devices.clear();
+    buffer.reset();
+}
+
+// Schedule Frames of Devices until Stopped
+void orchestrator::schedule( const limit& limit, const std::function<bool( const size_t )>& publish )
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t results = 0;
+    while( !is_stopped( limit, results, start ) ){
+        // Check End of Stream before Fetching (Last Frame is Published before Finished Flag)
+        const bool finished = is_finished();
+
+        // Submit Latest Frames in Round-Robin Order
+        bool submitted = false;
+        while( !ring->full() && update_skeleton() ){
+            submitted = true;
+        }
+
+        // Retrieve Oldest Result if Pool is Full or No Frame is Ready
+        if( !ring->empty() && ( ring->full() || !submitted ) ){
+            size_t index;
+            if( !update_result( index ) ){
+                continue;
+            }
+            results++;
+            if( !publish( index ) ){
+                break;
+            }
+            continue;
+        }
+
+        if( finished && !submitted && ring->empty() ){
+            break;
+        }
+
+        // Wait for Next Frame
+        if( !submitted ){
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+    }
+
+    // Retrieve Remaining Results
+    while( !ring->empty() ){
+        size_t index;
+        if( update_result( index ) ){
+            publish( index );
+        }
+    }
+}
+
+// Schedule Groups of Synchronized Frames until Stopped
+void orchestrator::schedule_synchronized( const limit& limit, const std::function<bool()>& publish )
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<frame> group;
+    uint64_t groups = 0;
+    size_t retrieved = 0; // results of oldest group
+    while( !is_stopped( limit, groups, start ) ){
+        // Submit Next Group if Pool has Room for All Devices (Wait for Group only if Pool is Empty)
+        if( ring->in_flight() + devices.size() <= ring->depth() ){
+            const std::chrono::milliseconds timeout( ring->empty() ? 10 : 0 );
+            if( aggregator->pop( group, timeout ) ){
+                update_group( group );
+                continue;
+            }
+        }
+
+        // Retrieve Oldest Result (Results of Group are Contiguous, so Group is Complete after Result of Every Device)
+        if( !ring->empty() ){
+            size_t index;
+            if( !update_result( index ) || ++retrieved < devices.size() ){
+                continue;
+            }
+
+            retrieved = 0;
+            groups++;
+            if( !publish() ){
+                break;
+            }
+            continue;
+        }
+
+        // Check Any Device Reached End of Stream (Group can not be Completed)
+        if( aggregator->finished() ){
+            break;
+        }
+    }
+
+    // Retrieve Remaining Results
+    while( !ring->empty() ){
+        size_t index;
+        if( update_result( index ) && ++retrieved == devices.size() ){
+            retrieved = 0;
+            publish();
+        }
+    }
+}
+
+// Start Capture Threads
+void orchestrator::start( const std::vector<source*>& sources )
+{
+    if( sources.empty() ){
+        throw std::runtime_error( "failed to start (no source)!" );
+    }
+
+    // Create Devices
+    devices.clear();
+    for( source* source : sources ){
+        devices.push_back( std::make_unique<device>() );
+        devices.back()->frame_source = source;
+        devices.back()->index = devices.size() - 1;
+        devices.back()->previous_buffer = arena.acquire();
+        if( tracking != tracking_method::backend ){
+            devices.back()->tracker = std::make_unique<skeleton_tracker>( tracking );
+        }
+        if( smoothing.mode != filter_mode::none ){
+            devices.back()->filter = std::make_unique<joint_filter>( smoothing );
+        }
+    }
+    next_device = 0;
+    quota = ( ring->depth() + devices.size() - 1 ) / devices.size();
+
+    // Start Capture Thread of Each Device
+    running = true;
+    for( const std::unique_ptr<device>& device : devices ){
+        device->thread = std::thread( &orchestrator::capture, this, std::ref( *device ) );
+    }
+}
+
+// Stop Capture Threads
+void orchestrator::stop()
+{
+    // Join Capture Threads (Wake Up Threads Waiting for Space of Aggregator)
+    running = false;
+    if( aggregator ){
+        aggregator->stop();
+    }
+    for( const std::unique_ptr<device>& device : devices ){
+        if( device->thread.joinable() ){
+            device->thread.join();
+        }
+    }
+
+    // Rethrow Error of Capture Thread
+    for( const std::unique_ptr<device>& device : devices ){
+        if( device->error ){
+            std::rethrow_exception( device->error );
+        }
+    }
+}
+
+// Capture (Capture Thread)
+void orchestrator::capture( device& device )
+{
+    try{
+        while( running ){
+            // Read Frame into Back Buffer
+            frame& frame = device.frames.back();
+            frame = ::frame();
+            {
+                scoped_timer timer( stage::capture, device.frame_index );
+                if( !device.frame_source->read( frame ) ){
+                    break;
+                }
+            }
+
+            // Stamp Frame (Sensor Time is Mapped to Steady Clock)
+            if( frame.timestamp.count() == 0 ){
+                frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+            }
+            frame.sensor_timestamp = device.clock.map( frame.device_timestamp, frame.timestamp );
+            frame.index = device.frame_index++;
+
+            // Push Frame into Aggregator (Synchronized Mode)
+            if( aggregator ){
+                aggregator->push( device.index, std::move( frame ) );
+                continue;
+            }
+
+            // Publish Latest Frame (Stale Frame is Dropped if Scheduler doesn't Fetch)
+            device.frames.publish();
+        }
+    }
+    catch( ... ){
+        device.error = std::current_exception();
+    }
+
+    if( aggregator ){
+        aggregator->close( device.index );
+    }
+
+    device.finished = true;
+}
+
+// Check All Devices Reached End of Stream (or Any Device Failed)
+bool orchestrator::is_finished() const
+{
+    bool finished = true;
+    for( const std::unique_ptr<device>& device : devices ){
+        if( !device->finished ){
+            finished = false;
+        }
+        else if( device->error ){
+            return true;
+        }
+    }
+    return finished;
+}
+
+// Update Skeleton
+bool orchestrator::update_skeleton()
+{
+    for( size_t i = 0; i < devices.size(); i++ ){
+        const size_t index = ( next_device + i ) % devices.size();
+        device& device = *devices[index];
+
+        // Backpressure (Frames of Device are Dropped in Mailbox while Quota is Used)
+        if( quota <= device.in_flight ){
+            continue;
+        }
+
+        // Fetch Latest Frame
+        if( !device.frames.fetch() ){
+            continue;
+        }
+
+        frame& frame = device.frames.front();
+        if( frame.color.empty() ){
+            frame = ::frame();
+            continue;
+        }
+
+        // Async Inference
+        scoped_timer timer( stage::submit, frame.index );
+        frame.inference_start = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+        const size_t slot = ring->submit( frame.color );
+        frames[slot] = std::move( frame );
+        frame = ::frame();
+        owners[slot] = index;
+        device.in_flight++;
+
+        // Next Device Has Priority
+        next_device = ( index + 1 ) % devices.size();
+        return true;
+    }
+
+    return false;
+}
+
+// Update Group
+void orchestrator::update_group( std::vector<frame>& group )
+{
+    // Skip Group if Any Frame has No Color Image (Results of Group must be Complete)
+    for( const frame& frame : group ){
+        if( frame.color.empty() ){
+            return;
+        }
+    }
+
+    // Async Inference of Each Device (Ordered by Device)
+    for( size_t index = 0; index < group.size(); index++ ){
+        frame& frame = group[index];
+        scoped_timer timer( stage::submit, frame.index );
+        frame.inference_start = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+        const size_t slot = ring->submit( frame.color );
+        frames[slot] = std::move( frame );
+        owners[slot] = index;
+        devices[index]->in_flight++;
+    }
+    group.clear();
+}
+
+// Update Result
+bool orchestrator::update_result( size_t& index )
+{
+    // Retrieve Oldest Result (Request is Kept in Flight on Timeout)
+    size_t slot;
+    const std::chrono::steady_clock::time_point wait_start = std::chrono::steady_clock::now();
+    const CM_ReturnCode result = ring->retrieve( buffer.get(), slot );
+    if( result == CM_ReturnCode::CM_TIMEOUT ){
+        return false;
+    }
+    index = owners[slot];
+    device& device = *devices[index];
+    device.in_flight--;
+    const std::chrono::steady_clock::time_point wait_end = std::chrono::steady_clock::now();
+    device.result_frame = std::move( frames[slot] );
+    device.result_frame.inference_end = std::chrono::duration_cast<std::chrono::nanoseconds>( wait_end.time_since_epoch() );
+    frames[slot] = frame();
+    profiler::record( stage::inference, device.result_frame.index, wait_end - wait_start );
+
+    // Update Resolution
+    update_resolution( device.result_frame );
+
+    if( result != CM_ReturnCode::CM_SUCCESS ){
+        device.keypoints.clear();
+        device.skeleton.clear();
+        return true;
+    }
+
+    // Copy Result into Arena and Release Buffer of Backend
+    CUBEMOS_SKEL_Buffer_Ptr latest_buffer = arena.acquire();
+    arena.store( *inference_backend, buffer.get(), latest_buffer.get() );
+
+    // Update Tracking ID of Device
+    {
+        scoped_timer timer( stage::tracking, device.result_frame.index );
+        if( device.tracker ){
+            device.tracker->update( latest_buffer.get() );
+        }
+        else{
+            CHECK_SUCCESS( inference_backend->update_tracking_id( device.previous_buffer.get(), latest_buffer.get() ) );
+        }
+
+        // Replace Previous Buffer (Previous Buffer Returns to Free List of Arena)
+        device.previous_buffer = std::move( latest_buffer );
+    }
+
+    // Deproject All Keypoints in Batch
+    {
+        scoped_timer timer( stage::deprojection, device.result_frame.index );
+        device.keypoints.assign( device.previous_buffer.get() );
+        if( !device.frame_source->deproject( device.result_frame, device.keypoints, device.skeleton ) ){
+            device.skeleton.clear();
+        }
+    }
+
+    // Smooth 2D and 3D Joints of Each Track of Device
+    if( device.filter ){
+        scoped_timer timer( stage::filter, device.result_frame.index );
+        device.filter->apply( device.result_frame.timestamp, device.keypoints, device.skeleton );
+    }
+
+    // Record Latency
+    update_latency( device.result_frame );
+
+    return true;
+}
+
+// Update Resolution
+inline void orchestrator::update_resolution( const frame& frame )
+{
+    if( !controller ){
+        return;
+    }
+
+    // Duration of Result in Metric of Policy (Interval of Results of All Devices is Scaled to Interval of Each Device)
+    const std::chrono::nanoseconds now = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+    const std::chrono::nanoseconds duration = ( controller->metric() == budget_metric::latency ) ? now - frame.sensor_timestamp : ( now - previous_result_time ) * static_cast<int64_t>( devices.size() );
+    const bool first = ( previous_result_time.count() == 0 );
+    previous_result_time = now;
+    if( first && controller->metric() == budget_metric::interval ){
+        return;
+    }
+
+    // Change Inference Size of Next Submits
+    if( controller->update( duration ) ){
+        ring->set_size( controller->size() );
+    }
+}
+
+// Update Latency
+inline void orchestrator::update_latency( frame& frame )
+{
+    // Record Age of Result (Violations of SLO are Counted as Gauge)
+    frame.publish_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+    if( monitor.record( frame ) ){
+        profiler::set_gauge( "slo_violations", static_cast<int64_t>( ++violations ) );
+    }
+
+    if( !profiler::is_enabled() ){
+        return;
+    }
+
+    profiler::record( stage::transport, frame.index, frame.timestamp - frame.sensor_timestamp );
+    profiler::record( stage::latency, frame.index, frame.publish_timestamp - frame.sensor_timestamp );
+}
@@ -0,0 +1,203 @@
+#ifndef __ORCHESTRATOR__
+#define __ORCHESTRATOR__
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+
+#include <opencv2/opencv.hpp>
+#include <cubemos/skeleton_tracking.h>
+
+#include "util.hpp"
+#include "backend.hpp"
+#include "inference.hpp"
+#include "source.hpp"
+#include "skeleton.hpp"
+#include "mailbox.hpp"
+#include "renderer.hpp"
+#include "sink.hpp"
+#include "engine.hpp"
+#include "aggregator.hpp"
+#include "fusion.hpp"
+#include "resolution.hpp"
+#include "tracker.hpp"
+#include "filter.hpp"
+#include "arena.hpp"
+#include "clock.hpp"
+#include "latency.hpp"
+
+/*
+ This is multi-source orchestrator that serves several devices with one model.
+
+ Model is loaded once, and all devices share bounded pool of async requests.
+ Each device is read on its own capture thread into lock-free mailbox,
+ so only latest frame of each device waits for inference (stale frames are dropped).
+ Scheduler submits frames in round-robin order, and each device can occupy at most
+ ceil( pool / devices ) requests (per-device backpressure), so fast device never starves others.
+ Tracking id and deprojection are kept per device.
+ In synchronized mode (e.g. wired sync rig), frames of devices are grouped by device timestamp,
+ each group is submitted together (pool must be at least number of devices),
+ and skeletons of group are fused into common coordinate with extrinsics of each device.
+ (source::deproject() is called on scheduler thread while source::read() runs on capture thread,
+ so deproject() must only use calibration and frame context.)
+
+ kinect kinect0( 0 ), kinect1( 1 );
+ orchestrator orchestrator( std::make_unique<cubemos_backend>(), 4 );
+ orchestrator.run( { &kinect0, &kinect1 } );        // window of each device
+ orchestrator.run( { &kinect0, &kinect1 }, sinks ); // headless (sink of each device)
+ orchestrator.run( { &kinect0, &kinect1 }, synchronization, sink ); // headless (fused skeletons of synchronized devices)
+*/
+
+// Synchronization of Devices
+struct synchronization
+{
+    std::chrono::nanoseconds tolerance = std::chrono::microseconds( 2000 ); // max difference of aligned device timestamps in group
+    std::vector<std::chrono::nanoseconds> delays; // sync delay of each device (empty means no delay)
+    std::vector<extrinsics> transforms;           // extrinsics of each device (empty means identity)
+    bool lossless = false;                        // capture threads wait instead of dropping frames (replay at max throughput)
+};
+
+class orchestrator
+{
+private:
+    // Device
+    struct device
+    {
+        // Capture Thread
+        source* frame_source = nullptr;
+        size_t index = 0;
+        std::thread thread;
+        std::atomic<bool> finished{ false };
+        std::exception_ptr error;
+        mailbox<frame> frames; // latest frame (capture thread -> scheduler)
+        uint64_t frame_index = 0;
+        clock_mapper clock;    // sensor time to steady clock
+
+        // Scheduler
+        size_t in_flight = 0;
+        CUBEMOS_SKEL_Buffer_Ptr previous_buffer; // latest result (buffer of arena)
+        std::unique_ptr<skeleton_tracker> tracker; // native tracker (empty means backend)
+        std::unique_ptr<joint_filter> filter;      // temporal filter (empty means raw joints)
+        frame result_frame;
+        skeleton2d keypoints;
+        skeleton3d skeleton;
+    };
+
+    // Cubemos
+    std::unique_ptr<backend> inference_backend;
+    std::unique_ptr<inference_ring> ring;
+    size_t pool_size;
+    int32_t inference_size;
+    std::vector<frame> frames;    // frame of each in-flight request
+    std::vector<size_t> owners;   // device of each in-flight request
+    CUBEMOS_SKEL_Buffer_Ptr buffer; // filled by backend (released right after copy into arena)
+    skeleton_arena arena;           // recycled buffers of results (latest result of each device and one in process)
+
+    // Tracking Method and Filter Policy of Each Device
+    tracking_method tracking;
+    filter_policy smoothing;
+
+    // Adaptive Inference Size (Shared by All Devices)
+    std::unique_ptr<resolution_controller> controller;
+    std::chrono::nanoseconds previous_result_time;
+
+    // Devices
+    std::vector<std::unique_ptr<device>> devices;
+    std::atomic<bool> running;
+    size_t next_device; // round-robin cursor
+    size_t quota;       // max in-flight requests of each device
+
+    // Age of Results of All Devices
+    latency_monitor monitor;
+    uint64_t violations; // results older than budget of SLO
+
+    // Synchronized Mode (Capture Threads Push into Aggregator instead of Mailbox)
+    std::unique_ptr<capture_aggregator> aggregator;
+    uint64_t synchronized_drops;
+
+public:
+    // Constructor
+    orchestrator( std::unique_ptr<backend> backend, const size_t pool_size = 4, const int32_t inference_size = MULTIPLE * 12 );
+
+    // Destructor
+    ~orchestrator();
+
+    orchestrator( const orchestrator& ) = delete;
+    orchestrator& operator=( const orchestrator& ) = delete;
+
+    // Run (Window of Each Device)
+    void run( const std::vector<source*>& sources, const limit& limit = ::limit() );
+
+    // Run (Headless, Sink of Each Device)
+    void run( const std::vector<source*>& sources, const std::vector<sink*>& sinks, const limit& limit = ::limit() );
+
+    // Run (Headless, Fused Skeletons of Frames Aligned by Device Timestamp)
+    void run( const std::vector<source*>& sources, const synchronization& synchronization, sink& sink, const limit& limit = ::limit() );
+
+    // Adapt Inference Size to Budget of Policy
+    void adapt( const resolution_policy& policy );
+
+    // Set Tracking Method of Tracking ID (Native Hungarian by Default)
+    void track( const tracking_method method );
+
+    // Smooth Joints of Each Track of Each Device with Filters of Policy
+    void smooth( const filter_policy& policy );
+
+    // Set Latency Budget of SLO (Age of Result from Sensor Time to Publish, 0 means No SLO)
+    void enforce( const std::chrono::nanoseconds budget );
+
+    // Get Rolling Metrics of Age of Published Results of All Devices
+    latency_metrics get_latency() const;
+
+    // Number of Frames Dropped by Backpressure (or Unmatched in Synchronized Mode)
+    uint64_t drops() const;
+
+private:
+    // Initialize
+    void initialize();
+
+    // Initialize Skeleton
+    void initialize_skeleton();
+
+    // Finalize
+    void finalize();
+
+    // Schedule Frames of Devices until Stopped
+    void schedule( const limit& limit, const std::function<bool( const size_t )>& publish );
+
+    // Schedule Groups of Synchronized Frames until Stopped
+    void schedule_synchronized( const limit& limit, const std::function<bool()>& publish );
+
+    // Start Capture Threads
+    void start( const std::vector<source*>& sources );
+
+    // Stop Capture Threads (Rethrow Error of Capture Thread)
+    void stop();
+
+    // Capture (Capture Thread)
+    void capture( device& device );
+
+    // Check All Devices Reached End of Stream (or Any Device Failed)
+    bool is_finished() const;
+
+    // Update Skeleton (Submit Latest Frame of Next Eligible Device, Return false if No Frame is Submitted)
+    bool update_skeleton();
+
+    // Update Group (Submit Synchronized Frames of All Devices)
+    void update_group( std::vector<frame>& group );
+
+    // Update Result (Retrieve Oldest Result into Device of Result, Return false if Oldest Request is Not Completed within Timeout)
+    bool update_result( size_t& index );
+
+    // Update Resolution (Feed Duration of Result to Controller)
+    void update_resolution( const frame& frame );
+
+    // Update Latency (Result is Published as soon as it is Retrieved)
+    void update_latency( frame& frame );
+};
+
+#endif // __ORCHESTRATOR__
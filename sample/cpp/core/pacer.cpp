@@ -0,0 +1,42 @@
+#include "pacer.hpp"
+
+#include <thread>
+
+// Constructor
+pacer::pacer( const bool realtime )
+    : realtime( realtime ),
+      started( false ),
+      start_timestamp( 0 )
+{
+}
+
+// Wait until Recorded Time of Frame
+void pacer::wait( const std::chrono::nanoseconds timestamp )
+{
+    if( !realtime ){
+        return;
+    }
+
+    // Anchor First Frame
+    if( !started || timestamp < start_timestamp ){
+        started = true;
+        start_time = clock::now();
+        start_timestamp = timestamp;
+        return;
+    }
+
+    // Sleep until Recorded Time
+    std::this_thread::sleep_until( start_time + std::chrono::duration_cast<clock::duration>( timestamp - start_timestamp ) );
+}
+
+// Reset Anchor
+void pacer::reset()
+{
+    started = false;
+}
+
+// Realtime
+bool pacer::is_realtime() const
+{
+    return realtime;
+}
@@ -0,0 +1,40 @@
+#ifndef __PACER__
+#define __PACER__
+
+#include <chrono>
+
+/*
+ This is pacer that replays recorded frames with recorded timing.
+
+ First frame is anchored to current time, and each following frame waits until
+ ( current time - anchor ) reaches ( recorded timestamp - first recorded timestamp ).
+ If realtime is false (max throughput), it never waits.
+
+ pacer pacer( realtime );
+ pacer.wait( recorded_timestamp );
+*/
+class pacer
+{
+private:
+    using clock = std::chrono::steady_clock;
+
+    bool realtime;
+    bool started;
+    clock::time_point start_time;
+    std::chrono::nanoseconds start_timestamp;
+
+public:
+    // Constructor
+    pacer( const bool realtime = true );
+
+    // Wait until Recorded Time of Frame
+    void wait( const std::chrono::nanoseconds timestamp );
+
+    // Reset Anchor
+    void reset();
+
+    // Realtime (false means max throughput)
+    bool is_realtime() const;
+};
+
+#endif // __PACER__
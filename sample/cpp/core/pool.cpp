@@ -0,0 +1,83 @@
+#include "pool.hpp"
+
+std::atomic<uint64_t> frame_pool::total_allocation_count( 0 );
+
+namespace
+{
+    // Check Data of Buffer is Still Shared with Other Headers (e.g. frame.color)
+    bool is_shared( const cv::Mat& buffer )
+    {
+        return buffer.u != nullptr && CV_XADD( &buffer.u->refcount, 0 ) != 1;
+    }
+}
+
+// Constructor
+frame_pool::frame_pool( const size_t capacity )
+    : free_buffers( std::make_shared<free_list>() ),
+      allocation_count( 0 )
+{
+    free_buffers->capacity = capacity;
+}
+
+// Acquire Buffer
+std::shared_ptr<cv::Mat> frame_pool::acquire( const cv::Size& size, const int32_t type )
+{
+    // Take Free Buffer that No Header Points into
+    std::unique_ptr<cv::Mat> buffer;
+    {
+        std::lock_guard<std::mutex> lock( free_buffers->mutex );
+        std::vector<std::unique_ptr<cv::Mat>>& candidates = free_buffers->buffers[key( size.width, size.height, type )];
+        for( size_t i = 0; i < candidates.size(); i++ ){
+            if( is_shared( *candidates[i] ) ){
+                continue;
+            }
+
+            buffer = std::move( candidates[i] );
+            candidates.erase( candidates.begin() + i );
+            break;
+        }
+    }
+
+    // Allocate New Buffer
+    if( !buffer ){
+        buffer = std::make_unique<cv::Mat>( size, type );
+        allocation_count++;
+        total_allocation_count++;
+    }
+
+    // Buffer may be Reallocated by Writer (e.g. cv::VideoCapture)
+    else if( buffer->size() != size || buffer->type() != type ){
+        buffer->create( size, type );
+        allocation_count++;
+        total_allocation_count++;
+    }
+
+    // Hand Buffer Back to Free List when Last Reference is Released
+    const std::shared_ptr<free_list> owner = free_buffers;
+    return std::shared_ptr<cv::Mat>( buffer.release(), [owner]( cv::Mat* released ){ release( owner, released ); } );
+}
+
+// Number of Allocations of This Pool
+uint64_t frame_pool::allocations() const
+{
+    return allocation_count;
+}
+
+// Number of Allocations of All Pools
+uint64_t frame_pool::total_allocations()
+{
+    return total_allocation_count;
+}
+
+// Return Buffer to Free List
+void frame_pool::release( const std::shared_ptr<free_list>& free_buffers, cv::Mat* buffer )
+{
+    std::unique_ptr<cv::Mat> released( buffer );
+
+    // Keep Buffer up to Capacity (Otherwise Buffer is Released)
+    std::lock_guard<std::mutex> lock( free_buffers->mutex );
+    std::vector<std::unique_ptr<cv::Mat>>& candidates = free_buffers->buffers[key( released->cols, released->rows, released->type() )];
+    if( candidates.size() < free_buffers->capacity ){
+        candidates.push_back( std::move( released ) );
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef __POOL__
+#define __POOL__
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+
+/*
+ This is pool of recycled frame buffers that are keyed by resolution and type.
+
+ Buffer is handed back to free list of pool (under lock) by deleter when last reference (shared_ptr) is released,
+ so steady-state operation allocates no frame buffer once pool holds enough buffers for in-flight frames.
+ Headers of cv::Mat (e.g. frame.color) share data of buffer by reference count of OpenCV,
+ so buffer in free list is reused only after all headers are released, and is never overwritten while frame still points into it.
+ Free lists are shared with deleter, so buffer that outlives pool is simply released.
+
+ frame_pool pool;
+ std::shared_ptr<cv::Mat> buffer = pool.acquire( cv::Size( 1280, 720 ), CV_8UC3 );
+ cv::cvtColor( bgra, *buffer, cv::COLOR_BGRA2BGR );
+ frame.color = *buffer;
+ frame.context = buffer; // buffer returns to pool when frame is released
+*/
+class frame_pool
+{
+private:
+    // Free Buffers
+    using key = std::tuple<int32_t, int32_t, int32_t>; // width, height, type
+    struct free_list
+    {
+        std::map<key, std::vector<std::unique_ptr<cv::Mat>>> buffers;
+        size_t capacity;
+        std::mutex mutex;
+    };
+    std::shared_ptr<free_list> free_buffers;
+
+    // Allocation Counter
+    std::atomic<uint64_t> allocation_count;
+    static std::atomic<uint64_t> total_allocation_count;
+
+public:
+    // Constructor (capacity is maximum number of free buffers per key)
+    frame_pool( const size_t capacity = 8 );
+
+    frame_pool( const frame_pool& ) = delete;
+    frame_pool& operator=( const frame_pool& ) = delete;
+
+    // Acquire Buffer (Buffer Returns to Pool when Released)
+    std::shared_ptr<cv::Mat> acquire( const cv::Size& size, const int32_t type );
+
+    // Number of Allocations of This Pool
+    uint64_t allocations() const;
+
+    // Number of Allocations of All Pools
+    static uint64_t total_allocations();
+
+private:
+    // Return Buffer to Free List (Deleter of Buffer)
+    static void release( const std::shared_ptr<free_list>& free_buffers, cv::Mat* buffer );
+};
+
+#endif // __POOL__
@@ -0,0 +1,362 @@
+#include "profiler.hpp"
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    // Ring Buffer of Records (Single Writer Thread)
+    // Record is packed into two words ( stage << 56 | duration, frame ).
+    // Writer claims slot before writing, so reader can discard slots that were overwritten while copying.
+    struct record_ring
+    {
+        std::array<std::atomic<uint64_t>, profiler::capacity> durations;
+        std::array<std::atomic<uint64_t>, profiler::capacity> frames;
+        std::atomic<uint64_t> claimed{ 0 };   // number of records that writer started to write
+        std::atomic<uint64_t> published{ 0 }; // number of records that writer finished to write
+        std::atomic<uint64_t> discarded{ 0 }; // number of records that are discarded by reset
+        std::atomic<bool> owned{ false };     // ring is used by alive thread
+    };
+
+    // Recording Flag
+    std::atomic<bool> enabled{ false };
+
+    // Rings of All Threads (Rings of Exited Threads are Reused)
+    std::mutex registry_mutex;
+    std::vector<std::shared_ptr<record_ring>> registry;
+
+    // Owner of Ring of Calling Thread
+    struct ring_owner
+    {
+        std::shared_ptr<record_ring> ring;
+
+        ring_owner()
+        {
+            std::lock_guard<std::mutex> lock( registry_mutex );
+            for( const std::shared_ptr<record_ring>& candidate : registry ){
+                if( !candidate->owned ){
+                    ring = candidate;
+                    break;
+                }
+            }
+
+            if( !ring ){
+                ring = std::make_shared<record_ring>();
+                registry.push_back( ring );
+            }
+            ring->owned = true;
+        }
+
+        ~ring_owner()
+        {
+            std::lock_guard<std::mutex> lock( registry_mutex );
+            ring->owned = false;
+        }
+    };
+
+    // Get Ring of Calling Thread
+    record_ring& get_ring()
+    {
+        thread_local ring_owner owner;
+        return *owner.ring;
+    }
+
+    // Gauges (Updated Rarely, so Guarded by Lock)
+    std::mutex gauge_mutex;
+    std::vector<gauge_statistics> gauge_registry;
+
+    constexpr uint64_t duration_mask = ( uint64_t( 1 ) << 56 ) - 1;
+
+    // Visit Recent Records of All Threads ( thread, stage, frame, duration )
+    template<typename visitor>
+    void collect( visitor visit )
+    {
+        // Snapshot Registry
+        std::vector<std::shared_ptr<record_ring>> rings;
+        {
+            std::lock_guard<std::mutex> lock( registry_mutex );
+            rings = registry;
+        }
+
+        std::vector<std::pair<uint64_t, uint64_t>> records;
+        for( size_t thread = 0; thread < rings.size(); thread++ ){
+            const record_ring& ring = *rings[thread];
+
+            // Copy Published Records
+            const uint64_t end = ring.published.load( std::memory_order_acquire );
+            const uint64_t begin = std::max( ring.discarded.load( std::memory_order_relaxed ), ( profiler::capacity < end ) ? end - profiler::capacity : 0 );
+            records.clear();
+            for( uint64_t i = begin; i < end; i++ ){
+                const size_t slot = static_cast<size_t>( i % profiler::capacity );
+                records.emplace_back( ring.durations[slot].load( std::memory_order_relaxed ), ring.frames[slot].load( std::memory_order_relaxed ) );
+            }
+
+            // Discard Records that may be Overwritten while Copying
+            std::atomic_thread_fence( std::memory_order_acquire );
+            const uint64_t claimed = ring.claimed.load( std::memory_order_relaxed );
+            const uint64_t valid = ( profiler::capacity < claimed ) ? claimed - profiler::capacity : 0;
+            for( uint64_t i = std::max( begin, valid ); i < end; i++ ){
+                const std::pair<uint64_t, uint64_t>& record = records[i - begin];
+                const uint64_t index = record.first >> 56;
+                if( index < static_cast<uint64_t>( stage::count ) ){
+                    visit( thread, static_cast<stage>( index ), record.second, static_cast<int64_t>( record.first & duration_mask ) );
+                }
+            }
+        }
+    }
+
+    // Percentile of Sorted Durations (Nearest Rank)
+    std::chrono::nanoseconds percentile( const std::vector<int64_t>& durations, const double rank )
+    {
+        const size_t index = std::min( durations.size() - 1, static_cast<size_t>( rank * durations.size() ) );
+        return std::chrono::nanoseconds( durations[index] );
+    }
+}
+
+// Name of Stage
+const char* get_stage_name( const stage stage )
+{
+    switch( stage ){
+        case stage::capture:
+            return "capture";
+        case stage::acquire:
+            return "acquire";
+        case stage::conversion:
+            return "conversion";
+        case stage::depth:
+            return "depth";
+        case stage::transformation:
+            return "transformation";
+        case stage::crop:
+            return "crop";
+        case stage::submit:
+            return "submit";
+        case stage::inference:
+            return "inference";
+        case stage::tracking:
+            return "tracking";
+        case stage::propagation:
+            return "propagation";
+        case stage::deprojection:
+            return "deprojection";
+        case stage::filter:
+            return "filter";
+        case stage::fusion:
+            return "fusion";
+        case stage::draw:
+            return "draw";
+        case stage::show:
+            return "show";
+        case stage::write:
+            return "write";
+        case stage::transport:
+            return "transport";
+        case stage::latency:
+            return "latency";
+        default:
+            return "unknown";
+    }
+}
+
+// Enable/Disable Recording
+void profiler::enable( const bool enabled )
+{
+    ::enabled.store( enabled, std::memory_order_relaxed );
+}
+
+// Check Recording is Enabled
+bool profiler::is_enabled()
+{
+    return ::enabled.load( std::memory_order_relaxed );
+}
+
+// Record Duration of Stage
+void profiler::record( const stage stage, const uint64_t frame, const std::chrono::nanoseconds duration )
+{
+    if( !is_enabled() ){
+        return;
+    }
+
+    // Claim Slot (Oldest Record is Overwritten)
+    record_ring& ring = get_ring();
+    const uint64_t index = ring.published.load( std::memory_order_relaxed );
+    ring.claimed.store( index + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    // Write Record
+    const uint64_t nanoseconds = static_cast<uint64_t>( std::max<int64_t>( duration.count(), 0 ) );
+    const size_t slot = static_cast<size_t>( index % capacity );
+    ring.durations[slot].store( ( static_cast<uint64_t>( stage ) << 56 ) | std::min( nanoseconds, duration_mask ), std::memory_order_relaxed );
+    ring.frames[slot].store( frame, std::memory_order_relaxed );
+
+    // Publish Record
+    ring.published.store( index + 1, std::memory_order_release );
+}
+
+// Set Value of Gauge
+void profiler::set_gauge( const std::string& name, const int64_t value )
+{
+    std::lock_guard<std::mutex> lock( gauge_mutex );
+    for( gauge_statistics& gauge : gauge_registry ){
+        if( gauge.name != name ){
+            continue;
+        }
+
+        // Update Range
+        if( gauge.value != value ){
+            gauge.changes++;
+        }
+        gauge.value = value;
+        gauge.min = std::min( gauge.min, value );
+        gauge.max = std::max( gauge.max, value );
+        return;
+    }
+
+    // Register New Gauge
+    gauge_statistics gauge;
+    gauge.name = name;
+    gauge.value = gauge.min = gauge.max = value;
+    gauge_registry.push_back( gauge );
+}
+
+// Aggregate Percentiles of Recent Records of All Threads
+std::vector<stage_statistics> profiler::aggregate()
+{
+    // Collect Durations of Each Stage
+    std::array<std::vector<int64_t>, static_cast<size_t>( stage::count )> durations;
+    collect( [&]( const size_t, const stage stage, const uint64_t, const int64_t duration ){
+        durations[static_cast<size_t>( stage )].push_back( duration );
+    } );
+
+    // Compute Statistics of Each Stage
+    std::vector<stage_statistics> statistics;
+    for( size_t i = 0; i < durations.size(); i++ ){
+        std::vector<int64_t>& values = durations[i];
+        if( values.empty() ){
+            continue;
+        }
+
+        std::sort( values.begin(), values.end() );
+        int64_t sum = 0;
+        for( const int64_t value : values ){
+            sum += value;
+        }
+
+        stage_statistics statistic;
+        statistic.stage = static_cast<stage>( i );
+        statistic.count = values.size();
+        statistic.mean = std::chrono::nanoseconds( sum / static_cast<int64_t>( values.size() ) );
+        statistic.p50 = percentile( values, 0.50 );
+        statistic.p95 = percentile( values, 0.95 );
+        statistic.p99 = percentile( values, 0.99 );
+        statistic.max = std::chrono::nanoseconds( values.back() );
+        statistics.push_back( statistic );
+    }
+
+    return statistics;
+}
+
+// Get Statistics of Gauges
+std::vector<gauge_statistics> profiler::gauges()
+{
+    std::lock_guard<std::mutex> lock( gauge_mutex );
+    return gauge_registry;
+}
+
+// Write Table of Percentiles
+void profiler::report( const std::string& path )
+{
+    // Open File
+    std::FILE* file = ( path == "-" ) ? stderr : std::fopen( path.c_str(), "w" );
+    if( file == nullptr ){
+        throw std::runtime_error( "failed to open " + path + "!" );
+    }
+
+    // Write Table [ms]
+    const auto milliseconds = []( const std::chrono::nanoseconds duration ){ return duration.count() / 1000000.0; };
+    std::fprintf( file, "%-16s %8s %10s %10s %10s %10s %10s\n", "stage", "count", "mean[ms]", "p50[ms]", "p95[ms]", "p99[ms]", "max[ms]" );
+    for( const stage_statistics& statistic : aggregate() ){
+        std::fprintf( file, "%-16s %8llu %10.3f %10.3f %10.3f %10.3f %10.3f\n", get_stage_name( statistic.stage ), static_cast<unsigned long long>( statistic.count ), milliseconds( statistic.mean ), milliseconds( statistic.p50 ), milliseconds( statistic.p95 ), milliseconds( statistic.p99 ), milliseconds( statistic.max ) );
+    }
+
+    // Write Gauges
+    const std::vector<gauge_statistics> gauges = profiler::gauges();
+    if( !gauges.empty() ){
+        std::fprintf( file, "%-16s %8s %10s %10s %10s\n", "gauge", "changes", "value", "min", "max" );
+    }
+    for( const gauge_statistics& gauge : gauges ){
+        std::fprintf( file, "%-16s %8llu %10lld %10lld %10lld\n", gauge.name.c_str(), static_cast<unsigned long long>( gauge.changes ), static_cast<long long>( gauge.value ), static_cast<long long>( gauge.min ), static_cast<long long>( gauge.max ) );
+    }
+
+    // Close File
+    std::fflush( file );
+    if( file != stderr ){
+        std::fclose( file );
+    }
+}
+
+// Write Recent Records as CSV ( thread, frame, stage, duration )
+void profiler::dump( const std::string& path )
+{
+    // Open File
+    std::FILE* file = std::fopen( path.c_str(), "w" );
+    if( file == nullptr ){
+        throw std::runtime_error( "failed to open " + path + "!" );
+    }
+
+    // Write Records [ns] (Frame is Empty if Record doesn't Belong to Specific Frame)
+    std::fputs( "thread,frame,stage,duration\n", file );
+    collect( [&]( const size_t thread, const stage stage, const uint64_t frame, const int64_t duration ){
+        if( frame == unknown_frame ){
+            std::fprintf( file, "%zu,,%s,%lld\n", thread, get_stage_name( stage ), static_cast<long long>( duration ) );
+        }
+        else{
+            std::fprintf( file, "%zu,%llu,%s,%lld\n", thread, static_cast<unsigned long long>( frame ), get_stage_name( stage ), static_cast<long long>( duration ) );
+        }
+    } );
+
+    // Close File
+    std::fclose( file );
+}
+
+// Discard Recorded Durations
+void profiler::reset()
+{
+    {
+        std::lock_guard<std::mutex> lock( registry_mutex );
+        for( const std::shared_ptr<record_ring>& ring : registry ){
+            ring->discarded.store( ring->published.load( std::memory_order_acquire ), std::memory_order_relaxed );
+        }
+    }
+
+    // Restart Range of Gauges from Current Value
+    std::lock_guard<std::mutex> lock( gauge_mutex );
+    for( gauge_statistics& gauge : gauge_registry ){
+        gauge.min = gauge.max = gauge.value;
+        gauge.changes = 0;
+    }
+}
+
+// Constructor
+scoped_timer::scoped_timer( const stage stage, const uint64_t frame )
+    : timer_stage( stage ),
+      frame( frame ),
+      enabled( profiler::is_enabled() )
+{
+    if( enabled ){
+        start = clock::now();
+    }
+}
+
+// Destructor
+scoped_timer::~scoped_timer()
+{
+    if( enabled ){
+        profiler::record( timer_stage, frame, clock::now() - start );
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef __PROFILER__
+#define __PROFILER__
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+/*
+ This is low-overhead latency profiler of pipeline stages.
+
+ Each thread records ( stage, frame, duration ) into its own fixed-size ring buffer without lock,
+ so recording never blocks capture, inference or render thread.
+ Percentiles are aggregated on demand from recent records of all threads.
+ If profiler is disabled (default), timers don't read clock.
+ Gauges keep value that changes rarely (e.g. inference size chosen by controller) and are reported with percentiles.
+
+ profiler::enable( true );
+ {
+     scoped_timer timer( stage::inference, frame.index );
+     ...
+ }
+ profiler::record( stage::latency, frame.index, now - frame.timestamp );
+ profiler::set_gauge( "inference_size", 176 );
+ profiler::report( "-" );
+*/
+
+// Stage
+enum class stage : uint8_t
+{
+    capture,        // read frame from source (total)
+    acquire,        // wait for sensor frame
+    conversion,     // convert color image to BGR
+    depth,          // retrieve depth image
+    transformation, // transform depth image to color camera
+    crop,           // crop regions around tracked people into mosaic
+    submit,         // start async inference
+    inference,      // wait for inference result
+    tracking,       // update tracking id
+    propagation,    // propagate keypoints to skipped frame
+    deprojection,   // map keypoints to 3D positions
+    filter,         // smooth joints of tracks
+    fusion,         // fuse skeletons of synchronized devices
+    draw,           // draw color and skeletons
+    show,           // show image in window
+    write,          // write skeletons to sink
+    transport,      // sensor timestamp to arrival on host
+    latency,        // sensor timestamp to result (end-to-end)
+    count
+};
+
+// Name of Stage
+const char* get_stage_name( const stage stage );
+
+// Statistics of Stage
+struct stage_statistics
+{
+    ::stage stage = stage::count;
+    uint64_t count = 0;
+    std::chrono::nanoseconds mean = std::chrono::nanoseconds( 0 );
+    std::chrono::nanoseconds p50 = std::chrono::nanoseconds( 0 );
+    std::chrono::nanoseconds p95 = std::chrono::nanoseconds( 0 );
+    std::chrono::nanoseconds p99 = std::chrono::nanoseconds( 0 );
+    std::chrono::nanoseconds max = std::chrono::nanoseconds( 0 );
+};
+
+// Statistics of Gauge
+struct gauge_statistics
+{
+    std::string name;
+    int64_t value = 0;
+    int64_t min = 0;
+    int64_t max = 0;
+    uint64_t changes = 0;
+};
+
+class profiler
+{
+public:
+    // Number of Records Kept per Thread
+    static constexpr size_t capacity = 16384;
+
+    // Frame Index of Records that doesn't Belong to Specific Frame
+    static constexpr uint64_t unknown_frame = ~uint64_t( 0 );
+
+    // Enable/Disable Recording
+    static void enable( const bool enabled );
+
+    // Check Recording is Enabled
+    static bool is_enabled();
+
+    // Record Duration of Stage (Lock-Free, Only Touches Ring Buffer of Calling Thread)
+    static void record( const stage stage, const uint64_t frame, const std::chrono::nanoseconds duration );
+
+    // Set Value of Gauge (Locked, Call Only when Value Changes)
+    static void set_gauge( const std::string& name, const int64_t value );
+
+    // Aggregate Percentiles of Recent Records of All Threads
+    static std::vector<stage_statistics> aggregate();
+
+    // Get Statistics of Gauges
+    static std::vector<gauge_statistics> gauges();
+
+    // Write Table of Percentiles (- means Standard Error)
+    static void report( const std::string& path );
+
+    // Write Recent Records of All Threads as CSV (Per-Frame Trace)
+    static void dump( const std::string& path );
+
+    // Discard Recorded Durations (Range of Gauges is Restarted from Current Value)
+    static void reset();
+};
+
+// Timer that Records Duration of Scope
+class scoped_timer
+{
+private:
+    using clock = std::chrono::steady_clock;
+
+    stage timer_stage;
+    uint64_t frame;
+    bool enabled;
+    clock::time_point start;
+
+public:
+    // Constructor
+    scoped_timer( const stage stage, const uint64_t frame = profiler::unknown_frame );
+
+    // Destructor
+    ~scoped_timer();
+
+    scoped_timer( const scoped_timer& ) = delete;
+    scoped_timer& operator=( const scoped_timer& ) = delete;
+};
+
+#endif // __PROFILER__
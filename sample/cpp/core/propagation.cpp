@@ -0,0 +1,187 @@
+#include "propagation.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // Check Joint is Detected (Missing Joint has Negative Position)
+    bool is_valid( const skeleton2d& keypoints, const size_t index )
+    {
+        return 0.0f < keypoints.confidences[index] && 0.0f <= keypoints.x[index] && 0.0f <= keypoints.y[index];
+    }
+}
+
+// Constructor
+keypoint_propagator::keypoint_propagator( const propagation_mode mode, const std::chrono::nanoseconds horizon, const int32_t window, const int32_t levels )
+    : mode( mode ),
+      horizon( horizon ),
+      window( window ),
+      levels( levels ),
+      latest_time( 0 ),
+      previous_time( 0 ),
+      corrected( false )
+{
+}
+
+// Correct with Inference Result of Frame
+void keypoint_propagator::correct( const frame& frame, const skeleton2d& keypoints )
+{
+    // Extrapolation (Keep Last Two Results)
+    if( mode == propagation_mode::extrapolation ){
+        std::swap( previous, latest );
+        previous_time = latest_time;
+        latest = keypoints;
+        latest_time = frame.timestamp;
+    }
+    // Flow (Track from Frame of Result)
+    else{
+        previous_frame = frame;
+        tracked = keypoints;
+    }
+
+    corrected = true;
+}
+
+// Predict Keypoints on Frame
+bool keypoint_propagator::predict( const frame& frame, skeleton2d& keypoints )
+{
+    if( !corrected ){
+        keypoints.clear();
+        return false;
+    }
+
+    if( mode == propagation_mode::extrapolation ){
+        update_extrapolation( frame, keypoints );
+    }
+    else{
+        update_flow( frame, keypoints );
+    }
+
+    return true;
+}
+
+// Reset
+void keypoint_propagator::reset()
+{
+    latest.clear();
+    previous.clear();
+    latest_time = previous_time = std::chrono::nanoseconds( 0 );
+    previous_frame = frame();
+    tracked.clear();
+    corrected = false;
+}
+
+// Mode
+propagation_mode keypoint_propagator::get_mode() const
+{
+    return mode;
+}
+
+// Predict by Extrapolation
+inline void keypoint_propagator::update_extrapolation( const frame& frame, skeleton2d& keypoints )
+{
+    keypoints = latest;
+    if( previous.skeletons() == 0 || latest_time <= previous_time ){
+        return;
+    }
+
+    // Elapsed Time from Latest Result (Clamped to Horizon) per Interval of Results
+    const std::chrono::nanoseconds elapsed = std::min( std::max( frame.timestamp - latest_time, std::chrono::nanoseconds( 0 ) ), horizon );
+    const float ratio = static_cast<float>( elapsed.count() ) / static_cast<float>( ( latest_time - previous_time ).count() );
+
+    for( size_t i = 0; i < latest.skeletons(); i++ ){
+        // Find Same Track in Previous Result
+        const std::vector<int64_t>::const_iterator iterator = std::find( previous.ids.begin(), previous.ids.end(), latest.ids[i] );
+        if( latest.ids[i] < 0 || iterator == previous.ids.end() ){
+            continue;
+        }
+        const size_t k = static_cast<size_t>( iterator - previous.ids.begin() );
+
+        // Move Each Joint with Constant Velocity
+        const int32_t count = std::min( latest.offsets[i + 1] - latest.offsets[i], previous.offsets[k + 1] - previous.offsets[k] );
+        for( int32_t joint = 0; joint < count; joint++ ){
+            const size_t index = static_cast<size_t>( latest.offsets[i] + joint );
+            const size_t previous_index = static_cast<size_t>( previous.offsets[k] + joint );
+            if( !is_valid( latest, index ) || !is_valid( previous, previous_index ) ){
+                continue;
+            }
+
+            keypoints.x[index] = latest.x[index] + ( latest.x[index] - previous.x[previous_index] ) * ratio;
+            keypoints.y[index] = latest.y[index] + ( latest.y[index] - previous.y[previous_index] ) * ratio;
+        }
+    }
+}
+
+// Predict by Optical Flow
+inline void keypoint_propagator::update_flow( const frame& frame, skeleton2d& keypoints )
+{
+    keypoints = tracked;
+
+    // Region around Joints (Same Region of Previous and Current Frame)
+    const cv::Rect region = get_region( tracked, frame.color.size() );
+    if( previous_frame.color.empty() || frame.color.empty() || previous_frame.color.size() != frame.color.size() || region.area() == 0 ){
+        previous_frame = frame;
+        return;
+    }
+
+    // Convert Only Region to Gray
+    cv::cvtColor( previous_frame.color( region ), previous_gray, cv::COLOR_BGR2GRAY );
+    cv::cvtColor( frame.color( region ), current_gray, cv::COLOR_BGR2GRAY );
+
+    // Track Valid Joints
+    points.clear();
+    for( size_t i = 0; i < tracked.size(); i++ ){
+        if( is_valid( tracked, i ) ){
+            points.emplace_back( tracked.x[i] - region.x, tracked.y[i] - region.y );
+        }
+    }
+    cv::calcOpticalFlowPyrLK( previous_gray, current_gray, points, next_points, status, errors, cv::Size( window, window ), levels );
+
+    // Update Tracked Joints (Lost Joint Keeps Position with Halved Confidence)
+    size_t point = 0;
+    for( size_t i = 0; i < tracked.size(); i++ ){
+        if( !is_valid( tracked, i ) ){
+            continue;
+        }
+
+        if( status[point] ){
+            keypoints.x[i] = next_points[point].x + region.x;
+            keypoints.y[i] = next_points[point].y + region.y;
+        }
+        else{
+            keypoints.confidences[i] *= 0.5f;
+        }
+        point++;
+    }
+
+    // Current Frame is Previous Frame of Next Prediction
+    previous_frame = frame;
+    tracked = keypoints;
+}
+
+// Region around Valid Joints
+inline cv::Rect keypoint_propagator::get_region( const skeleton2d& keypoints, const cv::Size& size ) const
+{
+    float left = static_cast<float>( size.width ), top = static_cast<float>( size.height ), right = 0.0f, bottom = 0.0f;
+    for( size_t i = 0; i < keypoints.size(); i++ ){
+        if( !is_valid( keypoints, i ) ){
+            continue;
+        }
+
+        left = std::min( left, keypoints.x[i] );
+        top = std::min( top, keypoints.y[i] );
+        right = std::max( right, keypoints.x[i] );
+        bottom = std::max( bottom, keypoints.y[i] );
+    }
+
+    if( right < left || bottom < top ){
+        return cv::Rect();
+    }
+
+    // Margin Covers Window at Top Level of Pyramid
+    const int32_t margin = window << levels;
+    const int32_t x = static_cast<int32_t>( left ) - margin;
+    const int32_t y = static_cast<int32_t>( top ) - margin;
+    const cv::Rect region( x, y, static_cast<int32_t>( right ) + margin + 1 - x, static_cast<int32_t>( bottom ) + margin + 1 - y );
+    return region & cv::Rect( 0, 0, size.width, size.height );
+}
@@ -0,0 +1,87 @@
+#ifndef __PROPAGATION__
+#define __PROPAGATION__
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+
+#include "source.hpp"
+#include "skeleton.hpp"
+
+/*
+ This is propagator of keypoints to frames that are not inferred (frame skipping).
+
+ Each inference result corrects keypoints, and each captured frame gets keypoints predicted from latest result.
+ Extrapolation moves each joint of each track (tracking id) with constant velocity of last two results
+ (up to horizon, so lost person doesn't fly away).
+ Flow tracks each joint from previous frame to current frame with pyramidal Lucas-Kanade optical flow.
+ Only region around joints is converted to gray and tracked, so cost is small patches, not full image.
+ Joints that are lost by flow keep previous position with halved confidence.
+
+ keypoint_propagator propagator( propagation_mode::flow );
+ propagator.correct( inferred_frame, keypoints ); // inference result (older frame)
+ propagator.predict( current_frame, keypoints );  // keypoints on current frame
+*/
+
+// Propagation Mode
+enum class propagation_mode
+{
+    extrapolation, // constant velocity of each track
+    flow           // optical flow of patch around each joint
+};
+
+class keypoint_propagator
+{
+private:
+    propagation_mode mode;
+    std::chrono::nanoseconds horizon; // max duration of extrapolation
+    int32_t window;                   // window size of optical flow
+    int32_t levels;                   // pyramid levels of optical flow
+
+    // Extrapolation (Last Two Results)
+    skeleton2d latest;
+    skeleton2d previous;
+    std::chrono::nanoseconds latest_time;
+    std::chrono::nanoseconds previous_time;
+    bool corrected;
+
+    // Flow (Keypoints on Previous Frame, Recycled Buffers)
+    frame previous_frame;
+    skeleton2d tracked;
+    cv::Mat previous_gray;
+    cv::Mat current_gray;
+    std::vector<cv::Point2f> points;
+    std::vector<cv::Point2f> next_points;
+    std::vector<uint8_t> status;
+    std::vector<float> errors;
+
+public:
+    // Constructor
+    keypoint_propagator( const propagation_mode mode = propagation_mode::extrapolation, const std::chrono::nanoseconds horizon = std::chrono::milliseconds( 200 ), const int32_t window = 21, const int32_t levels = 2 );
+
+    // Correct with Inference Result of Frame
+    void correct( const frame& frame, const skeleton2d& keypoints );
+
+    // Predict Keypoints on Frame (Return false if No Result is Corrected Yet)
+    bool predict( const frame& frame, skeleton2d& keypoints );
+
+    // Reset
+    void reset();
+
+    // Mode
+    propagation_mode get_mode() const;
+
+private:
+    // Predict by Extrapolation
+    void update_extrapolation( const frame& frame, skeleton2d& keypoints );
+
+    // Predict by Optical Flow
+    void update_flow( const frame& frame, skeleton2d& keypoints );
+
+    // Region around Valid Joints (Empty if No Joint is Valid)
+    cv::Rect get_region( const skeleton2d& keypoints, const cv::Size& size ) const;
+};
+
+#endif // __PROPAGATION__
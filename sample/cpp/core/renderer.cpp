@@ -0,0 +1,197 @@
+#include "renderer.hpp"
+#include "profiler.hpp"
+
+#include <chrono>
+
+// Constructor
+renderer::renderer( const std::string& window_name )
+    : renderer( std::vector<std::string>{ window_name } )
+{
+}
+
+// Constructor
+renderer::renderer( const std::vector<std::string>& window_names )
+    : running( true ),
+      quit( false )
+{
+    // Create Channels
+    for( const std::string& window_name : window_names ){
+        channels.push_back( std::make_unique<channel>() );
+        channels.back()->window_name = window_name;
+    }
+
+    // Initialize
+    initialize();
+}
+
+// Destructor
+renderer::~renderer()
+{
+    // Finalize
+    finalize();
+}
+
+// Initialize
+void renderer::initialize()
+{
+    // Create Color Table
+    colors.push_back( cv::Scalar( 255,   0,   0 ) );
+    colors.push_back( cv::Scalar(   0, 255,   0 ) );
+    colors.push_back( cv::Scalar(   0,   0, 255 ) );
+    colors.push_back( cv::Scalar( 255, 255,   0 ) );
+    colors.push_back( cv::Scalar(   0, 255, 255 ) );
+    colors.push_back( cv::Scalar( 255,   0, 255 ) );
+
+    // Start Render Thread
+    thread = std::thread( &renderer::run, this );
+}
+
+// Finalize
+void renderer::finalize()
+{
+    // Stop Render Thread
+    running = false;
+    if( thread.joinable() ){
+        thread.join();
+    }
+}
+
+// Publish Frame and Skeletons
+void renderer::publish( const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton )
+{
+    publish( 0, frame, keypoints, skeleton );
+}
+
+// Publish Frame and Skeletons to Window of Channel
+void renderer::publish( const size_t channel, const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton )
+{
+    // Copy into Back Buffer (Capacity of Vectors is Reused)
+    mailbox<render_packet>& packets = channels.at( channel )->packets;
+    render_packet& packet = packets.back();
+    packet.frame = frame;
+    packet.keypoints = keypoints;
+    packet.skeleton = skeleton;
+
+    // Publish (Overwrite Stale Packet if Render Thread is Busy)
+    packets.publish();
+}
+
+// Check Window is Closed
+bool renderer::closed() const
+{
+    return quit;
+}
+
+// Wait until Window is Closed
+void renderer::wait() const
+{
+    while( !quit && running ){
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+}
+
+// Number of Dropped Frames
+uint64_t renderer::drops() const
+{
+    uint64_t drops = 0;
+    for( const std::unique_ptr<channel>& channel : channels ){
+        drops += channel->packets.drops();
+    }
+    return drops;
+}
+
+// Run
+void renderer::run()
+{
+    // Render Loop
+    while( running ){
+        for( const std::unique_ptr<channel>& channel : channels ){
+            // Fetch Latest Packet
+            if( !channel->packets.fetch() ){
+                continue;
+            }
+            render_packet& packet = channel->packets.front();
+
+            // Draw Color and Skeleton
+            {
+                scoped_timer timer( stage::draw, packet.frame.index );
+                draw_color( *channel );
+                draw_skeleton( *channel );
+            }
+
+            // Show Skeleton
+            {
+                scoped_timer timer( stage::show, packet.frame.index );
+                show_skeleton( *channel );
+            }
+
+            // Release Frame (Return Buffer to Pool)
+            packet.frame = frame();
+        }
+
+        // Wait Key (Only Render Thread Waits)
+        constexpr int32_t delay = 1;
+        const int32_t key = cv::waitKey( delay );
+        if( key == 'q' ){
+            quit = true;
+        }
+    }
+
+    // Close Windows
+    cv::destroyAllWindows();
+}
+
+// Draw Color
+inline void renderer::draw_color( channel& channel )
+{
+    // Copy Frame to Recycled Buffer
+    // (Frame may wrap sensor memory, so it is never drawn in place)
+    channel.packets.front().frame.color.copyTo( channel.color );
+}
+
+// Draw Skeleton
+inline void renderer::draw_skeleton( channel& channel )
+{
+    // Draw Skeleton on Recycled Buffer
+    const render_packet& packet = channel.packets.front();
+    ::draw_skeleton( channel.color, packet.keypoints, packet.skeleton, colors );
+}
+
+// Show Skeleton
+inline void renderer::show_skeleton( const channel& channel )
+{
+    // Show Image
+    cv::imshow( channel.window_name, channel.color );
+}
+
+// Draw Joints of Skeletons on Image
+void draw_skeleton( cv::Mat& image, const skeleton2d& keypoints, const skeleton3d& skeleton, const std::vector<cv::Scalar>& colors )
+{
+    const bool deprojected = ( skeleton.size() == keypoints.size() );
+
+    // Draw Skeleton
+    for( size_t i = 0; i < keypoints.skeletons(); i++ ){
+        const cv::Scalar color = colors[keypoints.ids[i] % colors.size()];
+        for( int32_t j = keypoints.offsets[i]; j < keypoints.offsets[i + 1]; j++ ){
+            constexpr float threshold = 0.5f;
+            if( keypoints.confidences[j] < threshold ){
+                continue;
+            }
+
+            // Draw Joint
+            constexpr int32_t radius = 5;
+            const cv::Point point = cv::Point( keypoints.x[j], keypoints.y[j] );
+            cv::circle( image, point, radius, color, -1, cv::LineTypes::LINE_AA );
+
+            // Draw 3D Position
+            if( !deprojected || !skeleton.valid[j] ){
+                continue;
+            }
+
+            constexpr int32_t offcet = 20;
+            constexpr double scale = 0.5;
+            const std::string label = cv::format( "( %6.3f, %6.3f, %6.3f )", skeleton.x[j], skeleton.y[j], skeleton.z[j] );
+            cv::putText( image, label, cv::Point( point.x - offcet, point.y - offcet ), cv::FONT_HERSHEY_COMPLEX, scale, color );
+        }
+    }
+}
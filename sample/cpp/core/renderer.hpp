@@ -0,0 +1,112 @@
+#ifndef __RENDERER__
+#define __RENDERER__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+
+#include <opencv2/opencv.hpp>
+
+#include "source.hpp"
+#include "skeleton.hpp"
+#include "mailbox.hpp"
+
+// Render Packet (Frame and Skeletons of Retrieved Result)
+struct render_packet
+{
+    ::frame frame;
+    skeleton2d keypoints;
+    skeleton3d skeleton; // empty if not deprojected
+};
+
+/*
+ This is render stage that draws/shows skeletons on its own thread.
+
+ Engine publishes latest frame and skeletons into lock-free single-slot mailbox,
+ and render thread draws/shows only latest one (stale one is dropped),
+ so capture and inference never wait for HighGUI.
+ Several windows (e.g. one per device) can be served by one render thread.
+
+ renderer renderer( source.name() );
+ renderer.publish( frame, keypoints, skeleton );
+
+ renderer renderer( { "kinect 0", "kinect 1" } );
+ renderer.publish( 1, frame, keypoints, skeleton ); // window of kinect 1
+ if( renderer.closed() ){
+     // 'q' key is pressed
+ }
+*/
+class renderer
+{
+private:
+    // Thread
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> quit;
+
+    // Channel (Mailbox and Window)
+    struct channel
+    {
+        mailbox<render_packet> packets;
+        std::string window_name;
+        cv::Mat color; // recycled buffer for drawing
+    };
+    std::vector<std::unique_ptr<channel>> channels;
+
+    // Visualize
+    std::vector<cv::Scalar> colors;
+
+public:
+    // Constructor
+    renderer( const std::string& window_name );
+
+    // Constructor (Window of Each Channel)
+    renderer( const std::vector<std::string>& window_names );
+
+    // Destructor
+    ~renderer();
+
+    renderer( const renderer& ) = delete;
+    renderer& operator=( const renderer& ) = delete;
+
+    // Publish Frame and Skeletons (Producer)
+    void publish( const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton );
+
+    // Publish Frame and Skeletons to Window of Channel (Producer)
+    void publish( const size_t channel, const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton );
+
+    // Check Window is Closed ('q' Key is Pressed)
+    bool closed() const;
+
+    // Wait until Window is Closed
+    void wait() const;
+
+    // Number of Dropped Frames
+    uint64_t drops() const;
+
+private:
+    // Initialize
+    void initialize();
+
+    // Finalize
+    void finalize();
+
+    // Run (Render Thread)
+    void run();
+
+    // Draw Color
+    void draw_color( channel& channel );
+
+    // Draw Skeleton
+    void draw_skeleton( channel& channel );
+
+    // Show Skeleton
+    void show_skeleton( const channel& channel );
+};
+
+// Draw Joints (and 3D Positions if Deprojected) of Skeletons on Image
+void draw_skeleton( cv::Mat& image, const skeleton2d& keypoints, const skeleton3d& skeleton, const std::vector<cv::Scalar>& colors );
+
+#endif // __RENDERER__
@@ -0,0 +1,105 @@
+#include "resolution.hpp"
+#include "profiler.hpp"
+
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+// Constructor
+resolution_controller::resolution_controller( const resolution_policy& policy, const int32_t initial_size )
+    : policy( policy ),
+      index( 0 ),
+      average( 0.0 ),
+      samples( 0 ),
+      over( 0 ),
+      under( 0 ),
+      skip( 0 )
+{
+    // Sort Candidates
+    std::vector<int32_t>& sizes = this->policy.sizes;
+    std::sort( sizes.begin(), sizes.end() );
+    sizes.erase( std::unique( sizes.begin(), sizes.end() ), sizes.end() );
+    if( sizes.empty() ){
+        throw std::runtime_error( "failed to create resolution controller (no size)!" );
+    }
+    for( const int32_t size : sizes ){
+        if( size <= 0 || size % MULTIPLE != 0 ){
+            throw std::runtime_error( "failed to create resolution controller (size " + std::to_string( size ) + " is not multiple of " + std::to_string( MULTIPLE ) + ")!" );
+        }
+    }
+
+    // Nearest Candidate of Initial Size
+    for( size_t i = 1; i < sizes.size(); i++ ){
+        if( std::abs( sizes[i] - initial_size ) < std::abs( sizes[index] - initial_size ) ){
+            index = i;
+        }
+    }
+
+    profiler::set_gauge( "inference_size", size() );
+}
+
+// Update with Duration of Frame
+bool resolution_controller::update( const std::chrono::nanoseconds duration )
+{
+    // Fixed Size
+    if( policy.budget.count() <= 0 ){
+        return false;
+    }
+
+    // Ignore Results of Previous Size
+    if( 0 < skip ){
+        skip--;
+        return false;
+    }
+
+    // Moving Average
+    const double value = static_cast<double>( duration.count() );
+    average = ( samples == 0 ) ? value : average + policy.smoothing * ( value - average );
+    samples++;
+
+    // Step Down if Average is Over Budget for Several Frames
+    const double budget = static_cast<double>( policy.budget.count() );
+    over = ( budget < average ) ? over + 1 : 0;
+    if( policy.down_patience <= over && 0 < index ){
+        change( index - 1 );
+        return true;
+    }
+
+    // Step Up if Predicted Average at Next Size is Under Budget with Headroom for Many Frames
+    if( index + 1 < policy.sizes.size() ){
+        const double ratio = static_cast<double>( policy.sizes[index + 1] ) / policy.sizes[index];
+        under = ( average * ratio * ratio < budget * policy.headroom ) ? under + 1 : 0;
+        if( policy.up_patience <= under ){
+            change( index + 1 );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Current Size
+int32_t resolution_controller::size() const
+{
+    return policy.sizes[index];
+}
+
+// Metric
+budget_metric resolution_controller::metric() const
+{
+    return policy.metric;
+}
+
+// Change Size to Candidate
+inline void resolution_controller::change( const size_t index )
+{
+    this->index = index;
+    average = 0.0;
+    samples = 0;
+    over = 0;
+    under = 0;
+    skip = policy.settle;
+
+    profiler::set_gauge( "inference_size", size() );
+}
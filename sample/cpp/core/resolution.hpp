@@ -0,0 +1,78 @@
+#ifndef __RESOLUTION__
+#define __RESOLUTION__
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include "util.hpp"
+
+/*
+ This is controller of network input size (height) that keeps per-frame duration within budget.
+
+ Duration is end-to-end latency (sensor timestamp to result) or interval of results (inverse of FPS).
+ Moving average of durations is compared with budget.
+ If it exceeds budget for several frames, size steps down to next smaller candidate.
+ If predicted duration at next larger candidate (inference cost scales with area) is under budget with headroom
+ for many frames, size steps up. Different thresholds and patience give hysteresis, so size doesn't oscillate.
+ Results of requests that were submitted with previous size are ignored after change.
+ Chosen size is reported as "inference_size" gauge of profiler.
+
+ resolution_policy policy;
+ policy.budget = std::chrono::milliseconds( 50 );
+ resolution_controller controller( policy, MULTIPLE * 12 );
+ if( controller.update( now - frame.timestamp ) ){
+     ring.set_size( controller.size() );
+ }
+*/
+
+// Metric that is Kept within Budget
+enum class budget_metric
+{
+    latency, // sensor timestamp to result
+    interval // interval of results (1 / FPS)
+};
+
+// Policy of Controller
+struct resolution_policy
+{
+    std::vector<int32_t> sizes = { MULTIPLE * 8, MULTIPLE * 10, MULTIPLE * 12, MULTIPLE * 14, MULTIPLE * 16 }; // candidate sizes (multiples of 16)
+    budget_metric metric = budget_metric::latency;
+    std::chrono::nanoseconds budget = std::chrono::nanoseconds( 0 ); // 0 means fixed size
+    double headroom = 0.8;      // step up only if predicted duration is under budget x headroom
+    double smoothing = 0.1;     // weight of new duration in moving average
+    uint32_t down_patience = 5; // frames over budget before stepping down
+    uint32_t up_patience = 60;  // frames with headroom before stepping up
+    uint32_t settle = 8;        // results ignored after change (submitted with previous size)
+};
+
+class resolution_controller
+{
+private:
+    resolution_policy policy;
+    size_t index;     // index of current size in candidates
+    double average;   // moving average of durations [ns]
+    uint32_t samples; // samples in moving average since change
+    uint32_t over;    // consecutive frames over budget
+    uint32_t under;   // consecutive frames with headroom
+    uint32_t skip;    // results to ignore
+
+public:
+    // Constructor (Initial Size is Rounded to Nearest Candidate)
+    resolution_controller( const resolution_policy& policy, const int32_t initial_size );
+
+    // Update with Duration of Frame (Return true if Size is Changed)
+    bool update( const std::chrono::nanoseconds duration );
+
+    // Current Size
+    int32_t size() const;
+
+    // Metric
+    budget_metric metric() const;
+
+private:
+    // Change Size to Candidate
+    void change( const size_t index );
+};
+
+#endif // __RESOLUTION__
@@ -0,0 +1,179 @@
+#include "roi.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    // Round Up to Multiple (Limits Number of Pooled Buffer Sizes)
+    int32_t round_up( const int32_t value, const int32_t multiple )
+    {
+        return ( value + multiple - 1 ) / multiple * multiple;
+    }
+}
+
+// Constructor
+roi_cropper::roi_cropper( const int32_t interval, const float margin, const size_t max_regions, const double max_coverage )
+    : interval( interval ),
+      margin( margin ),
+      max_regions( max_regions ),
+      max_coverage( max_coverage ),
+      count( 0 ),
+      pool( 4 )
+{
+    if( interval <= 0 || margin < 0.0f || max_regions == 0 ){
+        throw std::runtime_error( "failed to create roi cropper (invalid parameter)!" );
+    }
+}
+
+// Crop Regions of Frame into Mosaic
+cv::Mat roi_cropper::crop( const cv::Mat& frame, roi_layout& layout )
+{
+    layout.tiles.clear();
+    layout.canvas.reset();
+
+    // Full Frame (Periodic Pass to Pick Up New People, or No Person is Tracked)
+    const bool periodic = ( count++ % static_cast<uint64_t>( interval ) ) == 0;
+    if( periodic || frame.empty() ){
+        return frame;
+    }
+    merge( cv::Size( frame.cols, frame.rows ) );
+    if( regions.empty() || max_regions < regions.size() ){
+        return frame;
+    }
+
+    // Pack Regions Side by Side (Tallest First)
+    std::sort( regions.begin(), regions.end(), []( const cv::Rect& a, const cv::Rect& b ){ return a.height > b.height; } );
+    int32_t width = 0, height = 0;
+    for( const cv::Rect& region : regions ){
+        if( !layout.tiles.empty() ){
+            width += gap;
+        }
+        layout.tiles.push_back( { region, cv::Point( width, 0 ) } );
+        width += region.width;
+        height = std::max( height, region.height );
+    }
+
+    // Full Frame if Mosaic doesn't Save Cost
+    if( max_coverage * frame.cols * frame.rows < static_cast<double>( width ) * height ){
+        layout.tiles.clear();
+        return frame;
+    }
+
+    // Copy Regions into Recycled Buffer (Gap and Unused Area are Black)
+    layout.canvas = pool.acquire( cv::Size( round_up( width, 64 ), round_up( height, 64 ) ), frame.type() );
+    cv::Mat mosaic = ( *layout.canvas )( cv::Rect( 0, 0, width, height ) );
+    mosaic.setTo( cv::Scalar::all( 0 ) );
+    for( const roi_tile& tile : layout.tiles ){
+        cv::Mat destination = mosaic( cv::Rect( tile.position.x, tile.position.y, tile.region.width, tile.region.height ) );
+        frame( tile.region ).copyTo( destination );
+    }
+
+    return mosaic;
+}
+
+// Update Regions from Skeletons of Latest Result
+void roi_cropper::update( const CM_SKEL_Buffer* buffer )
+{
+    boxes.clear();
+    if( buffer == nullptr ){
+        return;
+    }
+
+    // Bounding Box of Detected Joints of Each Skeleton
+    for( int32_t i = 0; i < buffer->numSkeletons; i++ ){
+        const CM_SKEL_KeypointsBuffer& skeleton = buffer->skeletons[i];
+        float left = 0.0f, top = 0.0f, right = -1.0f, bottom = -1.0f;
+        for( int32_t joint = 0; joint < skeleton.numKeyPoints; joint++ ){
+            const float x = skeleton.keypoints_coord_x[joint];
+            const float y = skeleton.keypoints_coord_y[joint];
+            if( skeleton.confidences[joint] <= 0.0f || x < 0.0f || y < 0.0f ){
+                continue;
+            }
+
+            if( right < left ){
+                left = right = x;
+                top = bottom = y;
+                continue;
+            }
+            left = std::min( left, x );
+            top = std::min( top, y );
+            right = std::max( right, x );
+            bottom = std::max( bottom, y );
+        }
+        if( right < left ){
+            continue;
+        }
+
+        // Expand by Motion Margin (Joints don't Cover Head and Hands, so Margin has Minimum)
+        const float size = std::max( right - left, bottom - top );
+        const float expand = std::max( size * margin, 32.0f );
+        const int32_t x = static_cast<int32_t>( left - expand );
+        const int32_t y = static_cast<int32_t>( top - expand );
+        boxes.emplace_back( x, y, static_cast<int32_t>( right + expand ) + 1 - x, static_cast<int32_t>( bottom + expand ) + 1 - y );
+    }
+}
+
+// Map Keypoints of Result from Mosaic to Full Frame
+void roi_cropper::map( const roi_layout& layout, CM_SKEL_Buffer* buffer )
+{
+    if( layout.tiles.empty() || buffer == nullptr ){
+        return;
+    }
+
+    for( int32_t i = 0; i < buffer->numSkeletons; i++ ){
+        CM_SKEL_KeypointsBuffer& skeleton = buffer->skeletons[i];
+        for( int32_t joint = 0; joint < skeleton.numKeyPoints; joint++ ){
+            float& x = skeleton.keypoints_coord_x[joint];
+            float& y = skeleton.keypoints_coord_y[joint];
+            if( x < 0.0f || y < 0.0f ){
+                continue;
+            }
+
+            // Find Tile that Contains Keypoint
+            const std::vector<roi_tile>::const_iterator tile = std::find_if( layout.tiles.begin(), layout.tiles.end(), [&]( const roi_tile& tile ){
+                return tile.position.x <= x && x < tile.position.x + tile.region.width && tile.position.y <= y && y < tile.position.y + tile.region.height;
+            } );
+
+            // Keypoint in Gap or Unused Area is Missing
+            if( tile == layout.tiles.end() ){
+                x = y = -1.0f;
+                skeleton.confidences[joint] = 0.0f;
+                continue;
+            }
+
+            x += static_cast<float>( tile->region.x - tile->position.x );
+            y += static_cast<float>( tile->region.y - tile->position.y );
+        }
+    }
+}
+
+// Merge Overlapping Boxes into Regions
+inline void roi_cropper::merge( const cv::Size& size )
+{
+    // Clip Boxes to Frame
+    regions.clear();
+    const cv::Rect bounds( 0, 0, size.width, size.height );
+    for( const cv::Rect& box : boxes ){
+        const cv::Rect region = box & bounds;
+        if( 0 < region.area() ){
+            regions.push_back( region );
+        }
+    }
+
+    // Union Overlapping Regions until No Region Overlaps (Few People, so Quadratic is Fine)
+    bool merged = true;
+    while( merged ){
+        merged = false;
+        for( size_t i = 0; i < regions.size() && !merged; i++ ){
+            for( size_t j = i + 1; j < regions.size(); j++ ){
+                if( 0 < ( regions[i] & regions[j] ).area() ){
+                    regions[i] = regions[i] | regions[j];
+                    regions.erase( regions.begin() + static_cast<std::ptrdiff_t>( j ) );
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
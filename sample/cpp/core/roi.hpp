@@ -0,0 +1,78 @@
+#ifndef __ROI__
+#define __ROI__
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+#include <cubemos/skeleton_tracking.h>
+
+#include "pool.hpp"
+
+/*
+ This is region of interest cropper that shrinks inference input to regions around tracked people.
+
+ Bounding box of each skeleton of latest result is expanded by motion margin, and overlapping boxes are merged.
+ Regions are packed side by side (with gap) into one mosaic image, so one request infers all regions
+ at same network size, and each person is inferred at higher effective resolution than in full frame.
+ Keypoints of result are mapped from mosaic back to full frame before tracking.
+ Full frame is inferred periodically (to pick up new people), if no person is tracked,
+ or if regions are too large to save cost.
+
+ roi_cropper cropper( 30 );
+ roi_layout layout;
+ const cv::Mat input = cropper.crop( frame.color, layout ); // mosaic (or full frame)
+ ...
+ roi_cropper::map( layout, buffer );                         // keypoints in full frame
+ cropper.update( buffer );                                   // regions of next frame
+*/
+
+// Tile of Mosaic
+struct roi_tile
+{
+    cv::Rect region;    // region in full frame
+    cv::Point position; // top-left of tile in mosaic
+};
+
+// Layout of Mosaic (Empty Tiles means Full Frame)
+struct roi_layout
+{
+    std::vector<roi_tile> tiles;
+    std::shared_ptr<cv::Mat> canvas; // keep mosaic alive until result is retrieved
+};
+
+class roi_cropper
+{
+private:
+    int32_t interval;        // full frame on every n-th inference
+    float margin;            // margin of bounding box (ratio of box size)
+    size_t max_regions;      // full frame if more regions remain after merge
+    double max_coverage;     // full frame if mosaic is larger than this ratio of frame
+    std::vector<cv::Rect> boxes;   // bounding boxes of latest result (recycled)
+    std::vector<cv::Rect> regions; // merged regions (recycled)
+    uint64_t count;          // number of crops
+    frame_pool pool;         // recycled mosaic buffers
+
+public:
+    // Gap between Tiles (Keeps Limbs of Different Tiles Apart)
+    static constexpr int32_t gap = 16;
+
+    // Constructor
+    roi_cropper( const int32_t interval = 30, const float margin = 0.25f, const size_t max_regions = 4, const double max_coverage = 0.6 );
+
+    // Crop Regions of Frame into Mosaic (Return Frame if Full Frame is Inferred)
+    cv::Mat crop( const cv::Mat& frame, roi_layout& layout );
+
+    // Update Regions from Skeletons of Latest Result (Full Frame Coordinate)
+    void update( const CM_SKEL_Buffer* buffer );
+
+    // Map Keypoints of Result from Mosaic to Full Frame (Keypoints in Gap are Missing)
+    static void map( const roi_layout& layout, CM_SKEL_Buffer* buffer );
+
+private:
+    // Merge Overlapping Boxes into Regions
+    void merge( const cv::Size& size );
+};
+
+#endif // __ROI__
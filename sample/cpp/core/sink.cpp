@@ -0,0 +1,81 @@
+#include "sink.hpp"
+
+#include <stdexcept>
+
+// Flush
+void sink::flush()
+{
+}
+
+// Constructor
+text_sink::text_sink( const std::string& path )
+    : file( nullptr ),
+      owned( false ),
+      index( 0 )
+{
+    // Open File
+    if( path == "-" ){
+        file = stdout;
+    }
+    else{
+        file = std::fopen( path.c_str(), "w" );
+        owned = true;
+    }
+
+    if( file == nullptr ){
+        throw std::runtime_error( "failed to open " + path + "!" );
+    }
+}
+
+// Destructor
+text_sink::~text_sink()
+{
+    // Close File
+    flush();
+    if( owned ){
+        std::fclose( file );
+    }
+}
+
+// Write Skeletons of Frame
+void text_sink::write( const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton )
+{
+    const bool deprojected = ( skeleton.size() == keypoints.size() );
+
+    std::fprintf( file, "{\"frame\":%llu,", static_cast<unsigned long long>( index++ ) );
+
+    // Timeline of Result (Steady Clock [ns], Inference is 0 if Keypoints are Propagated)
+    std::fprintf( file, "\"timestamps\":{\"sensor\":%lld,\"arrival\":%lld,\"inference_start\":%lld,\"inference_end\":%lld,\"publish\":%lld},", static_cast<long long>( frame.sensor_timestamp.count() ), static_cast<long long>( frame.timestamp.count() ), static_cast<long long>( frame.inference_start.count() ), static_cast<long long>( frame.inference_end.count() ), static_cast<long long>( frame.publish_timestamp.count() ) );
+
+    std::fputs( "\"skeletons\":[", file );
+    for( size_t i = 0; i < keypoints.skeletons(); i++ ){
+        std::fprintf( file, "%s{\"id\":%lld,\"keypoints\":[", ( i == 0 ) ? "" : ",", static_cast<long long>( keypoints.ids[i] ) );
+        for( int32_t j = keypoints.offsets[i]; j < keypoints.offsets[i + 1]; j++ ){
+            std::fprintf( file, "%s[%.1f,%.1f,%.3f]", ( j == keypoints.offsets[i] ) ? "" : ",", keypoints.x[j], keypoints.y[j], keypoints.confidences[j] );
+        }
+        std::fputs( "]", file );
+
+        // 3D Positions (null if depth is not available)
+        if( deprojected ){
+            std::fputs( ",\"positions\":[", file );
+            for( int32_t j = keypoints.offsets[i]; j < keypoints.offsets[i + 1]; j++ ){
+                const char* separator = ( j == keypoints.offsets[i] ) ? "" : ",";
+                if( skeleton.valid[j] ){
+                    std::fprintf( file, "%s[%.4f,%.4f,%.4f]", separator, skeleton.x[j], skeleton.y[j], skeleton.z[j] );
+                }
+                else{
+                    std::fprintf( file, "%snull", separator );
+                }
+            }
+            std::fputs( "]", file );
+        }
+        std::fputs( "}", file );
+    }
+    std::fputs( "]}\n", file );
+}
+
+// Flush
+void text_sink::flush()
+{
+    std::fflush( file );
+}
@@ -0,0 +1,65 @@
+#ifndef __SINK__
+#define __SINK__
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+#include "source.hpp"
+#include "skeleton.hpp"
+
+/*
+ This is interface of sink that receives skeletons of retrieved results in headless mode.
+
+ class file_sink : public sink
+ {
+     void write( const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton ) override;
+ };
+*/
+class sink
+{
+public:
+    // Destructor
+    virtual ~sink() = default;
+
+    // Write Skeletons of Frame (skeleton is empty if not deprojected)
+    virtual void write( const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton ) = 0;
+
+    // Flush
+    virtual void flush();
+};
+
+/*
+ This is sink that writes skeletons as JSON Lines (one line per frame) to standard output or file.
+
+ {"frame":0,"timestamps":{"sensor":t,"arrival":t,"inference_start":t,"inference_end":t,"publish":t},"skeletons":[{"id":0,"keypoints":[[x,y,confidence],...],"positions":[[x,y,z],null,...]}]}
+ Timestamps are steady clock [ns] (sensor time is mapped from sensor clock, inference is 0 if keypoints are propagated).
+*/
+class text_sink : public sink
+{
+private:
+    // File
+    std::FILE* file;
+    bool owned;
+
+    // Frame Counter
+    uint64_t index;
+
+public:
+    // Constructor ("-" means standard output)
+    text_sink( const std::string& path = "-" );
+
+    // Destructor
+    ~text_sink();
+
+    text_sink( const text_sink& ) = delete;
+    text_sink& operator=( const text_sink& ) = delete;
+
+    // Write Skeletons of Frame
+    void write( const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton ) override;
+
+    // Flush
+    void flush() override;
+};
+
+#endif // __SINK__
@@ -0,0 +1,196 @@
+#include "skeleton.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+// Gather Keypoints from Buffer
+void skeleton2d::assign( const CM_SKEL_Buffer* buffer )
+{
+    clear();
+    if( buffer == nullptr ){
+        return;
+    }
+
+    // Gather into Flat Arrays
+    offsets.push_back( 0 );
+    for( int32_t i = 0; i < buffer->numSkeletons; i++ ){
+        const CM_SKEL_KeypointsBuffer& skeleton = buffer->skeletons[i];
+        ids.push_back( skeleton.id );
+        x.insert( x.end(), skeleton.keypoints_coord_x, skeleton.keypoints_coord_x + skeleton.numKeyPoints );
+        y.insert( y.end(), skeleton.keypoints_coord_y, skeleton.keypoints_coord_y + skeleton.numKeyPoints );
+        confidences.insert( confidences.end(), skeleton.confidences, skeleton.confidences + skeleton.numKeyPoints );
+        offsets.push_back( static_cast<int32_t>( x.size() ) );
+    }
+}
+
+// Clear
+void skeleton2d::clear()
+{
+    ids.clear();
+    offsets.clear();
+    x.clear();
+    y.clear();
+    confidences.clear();
+}
+
+// Number of Skeletons
+size_t skeleton2d::skeletons() const
+{
+    return ids.size();
+}
+
+// Number of Keypoints
+size_t skeleton2d::size() const
+{
+    return x.size();
+}
+
+// Reset Layout to Same as 2D Skeletons
+void skeleton3d::reset( const skeleton2d& keypoints )
+{
+    ids = keypoints.ids;
+    offsets = keypoints.offsets;
+    x.resize( keypoints.size() );
+    y.resize( keypoints.size() );
+    z.resize( keypoints.size() );
+    valid.resize( keypoints.size() );
+}
+
+// Clear
+void skeleton3d::clear()
+{
+    ids.clear();
+    offsets.clear();
+    x.clear();
+    y.clear();
+    z.clear();
+    valid.clear();
+}
+
+// Number of Skeletons
+size_t skeleton3d::skeletons() const
+{
+    return ids.size();
+}
+
+// Number of Keypoints
+size_t skeleton3d::size() const
+{
+    return x.size();
+}
+
+// Lookup Rays of Keypoints from Table
+void lookup_rays( const cv::Mat& table, const skeleton2d& keypoints, skeleton3d& skeleton )
+{
+    CV_Assert( table.type() == CV_32FC2 );
+
+    constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+    const size_t size = keypoints.size();
+    for( size_t i = 0; i < size; i++ ){
+        // Bounds Check
+        const int32_t u = static_cast<int32_t>( std::lround( keypoints.x[i] ) );
+        const int32_t v = static_cast<int32_t>( std::lround( keypoints.y[i] ) );
+        if( u < 0 || table.cols <= u || v < 0 || table.rows <= v ){
+            skeleton.x[i] = nan;
+            skeleton.y[i] = nan;
+            continue;
+        }
+
+        const cv::Vec2f& ray = table.at<cv::Vec2f>( v, u );
+        skeleton.x[i] = ray[0];
+        skeleton.y[i] = ray[1];
+    }
+}
+
+// Compute Rays of Keypoints with Pinhole Intrinsics
+void compute_rays( const float fx, const float fy, const float cx, const float cy, const skeleton2d& keypoints, skeleton3d& skeleton )
+{
+    // Single Pass over SoA (Vectorized by Compiler)
+    const size_t size = keypoints.size();
+    const float* u = keypoints.x.data();
+    const float* v = keypoints.y.data();
+    float* x = skeleton.x.data();
+    float* y = skeleton.y.data();
+    const float inverse_fx = 1.0f / fx;
+    const float inverse_fy = 1.0f / fy;
+    for( size_t i = 0; i < size; i++ ){
+        x[i] = ( u[i] - cx ) * inverse_fx;
+        y[i] = ( v[i] - cy ) * inverse_fy;
+    }
+}
+
+// Sample Depth at Keypoints from Depth Image
+void sample_depth( const cv::Mat& depth, const float scale, const skeleton2d& keypoints, const int32_t window, skeleton3d& skeleton )
+{
+    CV_Assert( depth.type() == CV_16UC1 );
+
+    // Window is Clamped to 7 x 7
+    constexpr int32_t max_window = 7;
+    const int32_t radius = std::min( std::max( window, 1 ), max_window ) / 2;
+
+    const size_t size = keypoints.size();
+    for( size_t i = 0; i < size; i++ ){
+        skeleton.z[i] = 0.0f;
+
+        // Bounds Check
+        const int32_t u = static_cast<int32_t>( std::lround( keypoints.x[i] ) );
+        const int32_t v = static_cast<int32_t>( std::lround( keypoints.y[i] ) );
+        if( u < 0 || depth.cols <= u || v < 0 || depth.rows <= v ){
+            continue;
+        }
+
+        // Collect Non-Zero Depth in Window (Rows are Accessed with Stride)
+        uint16_t samples[max_window * max_window];
+        int32_t count = 0;
+        for( int32_t y = std::max( v - radius, 0 ); y <= std::min( v + radius, depth.rows - 1 ); y++ ){
+            const uint16_t* row = depth.ptr<uint16_t>( y );
+            for( int32_t x = std::max( u - radius, 0 ); x <= std::min( u + radius, depth.cols - 1 ); x++ ){
+                if( row[x] != 0 ){
+                    samples[count++] = row[x];
+                }
+            }
+        }
+        if( count == 0 ){
+            continue;
+        }
+
+        // Median
+        std::nth_element( samples, samples + count / 2, samples + count );
+        skeleton.z[i] = samples[count / 2] * scale;
+    }
+}
+
+// Deproject Rays with Depth into 3D Positions
+void deproject_skeleton( skeleton3d& skeleton )
+{
+    // Single Pass over SoA (Vectorized by Compiler)
+    const size_t size = skeleton.size();
+    float* x = skeleton.x.data();
+    float* y = skeleton.y.data();
+    const float* z = skeleton.z.data();
+    uint8_t* valid = skeleton.valid.data();
+    for( size_t i = 0; i < size; i++ ){
+        x[i] *= z[i];
+        y[i] *= z[i];
+        valid[i] = ( z[i] > 0.0f ) & ( x[i] == x[i] ); // NaN if ray is not available
+    }
+}
+
+// Transform 3D Positions with Rotation and Translation
+void transform_skeleton( const float rotation[9], const float translation[3], skeleton3d& skeleton )
+{
+    // Single Pass over SoA (Vectorized by Compiler)
+    const size_t size = skeleton.size();
+    float* x = skeleton.x.data();
+    float* y = skeleton.y.data();
+    float* z = skeleton.z.data();
+    for( size_t i = 0; i < size; i++ ){
+        const float px = x[i];
+        const float py = y[i];
+        const float pz = z[i];
+        x[i] = rotation[0] * px + rotation[1] * py + rotation[2] * pz + translation[0];
+        y[i] = rotation[3] * px + rotation[4] * py + rotation[5] * pz + translation[1];
+        z[i] = rotation[6] * px + rotation[7] * py + rotation[8] * pz + translation[2];
+    }
+}
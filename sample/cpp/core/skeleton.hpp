@@ -0,0 +1,89 @@
+#ifndef __SKELETON__
+#define __SKELETON__
+
+#include <vector>
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+#include <cubemos/skeleton_tracking.h>
+
+/*
+ This is skeletons in SoA (structure of arrays) layout that are independent of drawing.
+
+ Keypoints of all skeletons are stored in flat arrays,
+ and keypoints of i-th skeleton are in range [offsets[i], offsets[i + 1]).
+
+ skeleton2d keypoints;
+ keypoints.assign( buffer );
+
+ skeleton3d skeleton;
+ skeleton.reset( keypoints );
+ lookup_rays( table, keypoints, skeleton );                    // x, y <- ray of each keypoint
+ sample_depth( depth, 0.001f, keypoints, 3, skeleton );        // z <- median depth [m]
+ deproject_skeleton( skeleton );                               // x, y, z <- 3D position [m]
+*/
+
+// 2D Skeletons (Keypoints in Color Image)
+struct skeleton2d
+{
+    std::vector<int64_t> ids;        // tracking id of each skeleton
+    std::vector<int32_t> offsets;    // index of first keypoint of each skeleton (size = skeletons + 1)
+    std::vector<float> x;            // position of each keypoint [pixel]
+    std::vector<float> y;
+    std::vector<float> confidences;
+
+    // Gather Keypoints from Buffer
+    void assign( const CM_SKEL_Buffer* buffer );
+
+    // Clear
+    void clear();
+
+    // Number of Skeletons
+    size_t skeletons() const;
+
+    // Number of Keypoints
+    size_t size() const;
+};
+
+// 3D Skeletons (Same Layout as 2D Skeletons)
+struct skeleton3d
+{
+    std::vector<int64_t> ids;
+    std::vector<int32_t> offsets;
+    std::vector<float> x;            // position of each keypoint in color camera coordinate [m]
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<uint8_t> valid;      // 0 if depth is not available
+
+    // Reset Layout to Same as 2D Skeletons (Buffers are Recycled)
+    void reset( const skeleton2d& keypoints );
+
+    // Clear
+    void clear();
+
+    // Number of Skeletons
+    size_t skeletons() const;
+
+    // Number of Keypoints
+    size_t size() const;
+};
+
+// Lookup Rays (Normalized Coordinate at z = 1) of Keypoints from Table (CV_32FC2, Same Size as Color Image)
+// (x, y of skeleton are overwritten with ray, and NaN if keypoint is out of image)
+void lookup_rays( const cv::Mat& table, const skeleton2d& keypoints, skeleton3d& skeleton );
+
+// Compute Rays (Normalized Coordinate at z = 1) of Keypoints with Pinhole Intrinsics
+// (x, y of skeleton are overwritten with ray)
+void compute_rays( const float fx, const float fy, const float cx, const float cy, const skeleton2d& keypoints, skeleton3d& skeleton );
+
+// Sample Depth at Keypoints from Depth Image (CV_16UC1, Aligned to Color Image)
+// (z of skeleton is overwritten with median of non-zero depth in window x window [m], and 0 if not available)
+void sample_depth( const cv::Mat& depth, const float scale, const skeleton2d& keypoints, const int32_t window, skeleton3d& skeleton );
+
+// Deproject Rays with Depth into 3D Positions
+void deproject_skeleton( skeleton3d& skeleton );
+
+// Transform 3D Positions with Rotation (Row-Major 3x3) and Translation [m]
+void transform_skeleton( const float rotation[9], const float translation[3], skeleton3d& skeleton );
+
+#endif // __SKELETON__
@@ -0,0 +1,191 @@
+#include "source.hpp"
+#include "profiler.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+// Deproject 2D Keypoints to 3D Positions in Batch
+bool source::deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const
+{
+    // 2D Only Source
+    return false;
+}
+
+// Constructor (Web Camera)
+camera_source::camera_source( const int32_t index, const int32_t width, const int32_t height )
+    : capture( index ),
+      source_name( "skeleton" ),
+      capture_type( CV_8UC3 ),
+      replay_pacer( false ),
+      replay( false )
+{
+    // Open Capture
+    if( !capture.isOpened() ){
+        throw std::runtime_error( "failed to open!" );
+    }
+
+    // Set Capture Frame Resolution
+    capture.set( cv::CAP_PROP_FRAME_WIDTH, width );
+    capture.set( cv::CAP_PROP_FRAME_HEIGHT, height );
+    capture_size = cv::Size( static_cast<int32_t>( capture.get( cv::CAP_PROP_FRAME_WIDTH ) ), static_cast<int32_t>( capture.get( cv::CAP_PROP_FRAME_HEIGHT ) ) );
+}
+
+// Constructor (Video File or Image File)
+camera_source::camera_source( const std::string& file, const bool realtime )
+    : capture( file ),
+      source_name( "skeleton" ),
+      capture_type( CV_8UC3 ),
+      replay_pacer( realtime ),
+      replay( true )
+{
+    // Open Capture
+    if( !capture.isOpened() ){
+        throw std::runtime_error( "failed to open " + file + "!" );
+    }
+
+    capture_size = cv::Size( static_cast<int32_t>( capture.get( cv::CAP_PROP_FRAME_WIDTH ) ), static_cast<int32_t>( capture.get( cv::CAP_PROP_FRAME_HEIGHT ) ) );
+}
+
+// Destructor
+camera_source::~camera_source()
+{
+    // Release Capture
+    capture.release();
+}
+
+// Read Frame
+bool camera_source::read( frame& frame )
+{
+    // Retrieve Frame into Recycled Buffer
+    std::shared_ptr<cv::Mat> buffer = pool.acquire( capture_size, capture_type );
+    {
+        scoped_timer timer( stage::acquire );
+        capture >> *buffer;
+    }
+    if( buffer->empty() ){
+        return false;
+    }
+    capture_size = buffer->size();
+    capture_type = buffer->type();
+
+    // Wait until Recorded Time of Frame
+    if( replay ){
+        const double position = capture.get( cv::CAP_PROP_POS_MSEC ); // [ms]
+        replay_pacer.wait( std::chrono::nanoseconds( static_cast<int64_t>( position * 1000000.0 ) ) );
+    }
+
+    // Stamp Arrival after Replay Wait (Web Camera has No Sensor Clock)
+    frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
+
+    // Only Support 3-channels Image
+    if( buffer->channels() == 4 ){
+        scoped_timer timer( stage::conversion );
+        std::shared_ptr<cv::Mat> converted = pool.acquire( capture_size, CV_8UC3 );
+        cv::cvtColor( *buffer, *converted, cv::COLOR_BGRA2BGR );
+        buffer = converted;
+    }
+
+    // Keep Buffer until Frame is Released
+    frame.color = *buffer;
+    frame.context = buffer;
+
+    return true;
+}
+
+// Name
+std::string camera_source::name() const
+{
+    return source_name;
+}
+
+// Number of Buffer Allocations
+uint64_t camera_source::allocations() const
+{
+    return pool.allocations();
+}
+
+// Constructor
+image_source::image_source( const std::string& directory, const double fps, const bool realtime )
+    : index( 0 ),
+      source_name( "skeleton" ),
+      replay_pacer( realtime ),
+      fps( fps )
+{
+    // Collect Image Files
+    const std::vector<std::string> extensions = { ".png", ".jpg", ".jpeg", ".bmp", ".tif", ".tiff" };
+    for( const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator( directory ) ){
+        std::string extension = entry.path().extension().string();
+        std::transform( extension.begin(), extension.end(), extension.begin(), []( const char c ){ return static_cast<char>( std::tolower( c ) ); } );
+        if( entry.is_regular_file() && std::find( extensions.begin(), extensions.end(), extension ) != extensions.end() ){
+            files.push_back( entry.path().string() );
+        }
+    }
+
+    if( files.empty() ){
+        throw std::runtime_error( "failed to open " + directory + " (no image files)!" );
+    }
+
+    std::sort( files.begin(), files.end() );
+}
+
+// Read Frame
+bool image_source::read( frame& frame )
+{
+    if( files.size() <= index ){
+        return false;
+    }
+
+    // Read Encoded Image into Recycled Buffer
+    {
+        scoped_timer timer( stage::acquire );
+        std::ifstream stream( files[index], std::ios::binary | std::ios::ate );
+        if( !stream ){
+            throw std::runtime_error( "failed to open " + files[index] + "!" );
+        }
+        encoded.resize( static_cast<size_t>( stream.tellg() ) );
+        stream.seekg( 0 );
+        stream.read( reinterpret_cast<char*>( encoded.data() ), encoded.size() );
+    }
+
+    // Decode into Recycled Buffer (3-channels Image)
+    std::shared_ptr<cv::Mat> buffer = pool.acquire( image_size, CV_8UC3 );
+    {
+        scoped_timer timer( stage::conversion );
+        cv::imdecode( cv::Mat( 1, static_cast<int32_t>( encoded.size() ), CV_8UC1, encoded.data() ), cv::IMREAD_COLOR, buffer.get() );
+    }
+    if( buffer->empty() ){
+        throw std::runtime_error( "failed to decode " + files[index] + "!" );
+    }
+    image_size = buffer->size();
+
+    // Wait until Time of Frame
+    replay_pacer.wait( std::chrono::nanoseconds( static_cast<int64_t>( index * 1000000000.0 / fps ) ) );
+    index++;
+
+    // Keep Buffer until Frame is Released
+    frame.color = *buffer;
+    frame.context = buffer;
+
+    return true;
+}
+
+// Name
+std::string image_source::name() const
+{
+    return source_name;
+}
+
+// Number of Buffer Allocations
+uint64_t image_source::allocations() const
+{
+    return pool.allocations();
+}
+
+// Check Path is Directory
+bool is_directory( const std::string& path )
+{
+    std::error_code error;
+    return std::filesystem::is_directory( path, error );
+}
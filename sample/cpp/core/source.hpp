@@ -0,0 +1,128 @@
+#ifndef __SOURCE__
+#define __SOURCE__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+
+#include "pool.hpp"
+#include "skeleton.hpp"
+#include "pacer.hpp"
+
+// Frame
+struct frame
+{
+    cv::Mat color;                  // 3-channels BGR image that is passed to inference (read only, may wrap memory owned by context)
+    std::shared_ptr<void> context;  // source specific data (e.g. depth, sensor frame) that belongs to this frame
+    std::chrono::nanoseconds timestamp = std::chrono::nanoseconds( 0 ); // host arrival time (steady clock, stamped by engine if source doesn't set)
+    std::chrono::nanoseconds device_timestamp = std::chrono::nanoseconds( 0 ); // timestamp of sensor clock (0 if not available)
+    std::chrono::nanoseconds sensor_timestamp = std::chrono::nanoseconds( 0 ); // sensor time mapped to steady clock (arrival time if sensor clock is not available)
+    std::chrono::nanoseconds inference_start = std::chrono::nanoseconds( 0 ); // submit of inference (steady clock, 0 if keypoints are propagated)
+    std::chrono::nanoseconds inference_end = std::chrono::nanoseconds( 0 );   // retrieve of inference result (steady clock)
+    std::chrono::nanoseconds publish_timestamp = std::chrono::nanoseconds( 0 ); // publish of result to renderer or sink (steady clock)
+    uint64_t index = 0;             // sequence number of frame (set by engine)
+};
+
+/*
+ This is interface of frame source that provides color image (and depth data) to engine.
+
+ class sensor : public source
+ {
+     bool read( frame& frame ) override;
+     bool deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const override;
+     std::string name() const override;
+ };
+*/
+class source
+{
+public:
+    // Destructor
+    virtual ~source() = default;
+
+    // Read Frame (Return false at End of Stream)
+    virtual bool read( frame& frame ) = 0;
+
+    // Deproject 2D Keypoints to 3D Positions in Batch (Return false if Not Supported)
+    virtual bool deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const;
+
+    // Name (Used as Window Title)
+    virtual std::string name() const = 0;
+};
+
+// Frame Source of Web Camera, Video File or Image File (cv::VideoCapture)
+class camera_source : public source
+{
+private:
+    // Capture
+    cv::VideoCapture capture;
+    std::string source_name;
+
+    // Buffer
+    frame_pool pool;
+    cv::Size capture_size;
+    int32_t capture_type;
+
+    // Replay
+    pacer replay_pacer;
+    bool replay;
+
+public:
+    // Constructor (Web Camera)
+    camera_source( const int32_t index = 0, const int32_t width = 1280, const int32_t height = 720 );
+
+    // Constructor (Video File or Image File, realtime = false means max throughput)
+    camera_source( const std::string& file, const bool realtime = true );
+
+    // Destructor
+    ~camera_source();
+
+    // Read Frame
+    bool read( frame& frame ) override;
+
+    // Name
+    std::string name() const override;
+
+    // Number of Buffer Allocations
+    uint64_t allocations() const;
+};
+
+// Frame Source of Image Sequence in Directory (Sorted by File Name)
+class image_source : public source
+{
+private:
+    // Files
+    std::vector<std::string> files;
+    size_t index;
+    std::string source_name;
+
+    // Buffer
+    frame_pool pool;
+    std::vector<uint8_t> encoded; // recycled buffer for encoded image
+    cv::Size image_size;
+
+    // Replay
+    pacer replay_pacer;
+    double fps;
+
+public:
+    // Constructor (realtime = false means max throughput)
+    image_source( const std::string& directory, const double fps = 30.0, const bool realtime = true );
+
+    // Read Frame
+    bool read( frame& frame ) override;
+
+    // Name
+    std::string name() const override;
+
+    // Number of Buffer Allocations
+    uint64_t allocations() const;
+};
+
+// Check Path is Directory
+bool is_directory( const std::string& path );
+
+#endif // __SOURCE__
@@ -0,0 +1,499 @@
+#include "stream.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    // File Header
+    struct file_header
+    {
+        char magic[8];          // "SKLSTRM"
+        uint32_t version;
+        uint32_t keypoints;
+        uint32_t records;
+        uint32_t flags;
+        uint64_t chunk_size;
+        uint64_t header_size;
+    };
+
+    // Chunk Header
+    struct chunk_header
+    {
+        uint32_t magic;         // "SKCH"
+        uint32_t count;
+        uint64_t reserved;
+    };
+
+    constexpr char file_magic[8] = { 'S', 'K', 'L', 'S', 'T', 'R', 'M', '\0' };
+    constexpr uint32_t chunk_magic = 0x48434B53; // "SKCH"
+    constexpr uint32_t current_version = 2;
+    constexpr uint32_t flag_positions = 0x1;
+
+    // Align Offset
+    uint64_t align( const uint64_t offset, const uint64_t alignment )
+    {
+        return ( offset + alignment - 1 ) / alignment * alignment;
+    }
+
+#ifdef _WIN32
+    // Open File
+    intptr_t open_file( const std::string& path, const bool writable )
+    {
+        const HANDLE file = CreateFileA( path.c_str(), writable ? ( GENERIC_READ | GENERIC_WRITE ) : GENERIC_READ, FILE_SHARE_READ, nullptr, writable ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+        if( file == INVALID_HANDLE_VALUE ){
+            throw std::runtime_error( "failed to open " + path + "!" );
+        }
+        return reinterpret_cast<intptr_t>( file );
+    }
+
+    // Close File
+    void close_file( const intptr_t file )
+    {
+        CloseHandle( reinterpret_cast<HANDLE>( file ) );
+    }
+
+    // Get File Size
+    uint64_t get_file_size( const intptr_t file )
+    {
+        LARGE_INTEGER size;
+        if( !GetFileSizeEx( reinterpret_cast<HANDLE>( file ), &size ) ){
+            throw std::runtime_error( "failed to get file size!" );
+        }
+        return static_cast<uint64_t>( size.QuadPart );
+    }
+
+    // Resize File
+    void resize_file( const intptr_t file, const uint64_t size )
+    {
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>( size );
+        if( !SetFilePointerEx( reinterpret_cast<HANDLE>( file ), position, nullptr, FILE_BEGIN ) || !SetEndOfFile( reinterpret_cast<HANDLE>( file ) ) ){
+            throw std::runtime_error( "failed to resize file!" );
+        }
+    }
+
+    // Map File
+    void* map_file( const intptr_t file, const uint64_t offset, const uint64_t size, const bool writable, intptr_t& mapping )
+    {
+        const uint64_t end = offset + size;
+        const HANDLE handle = CreateFileMappingA( reinterpret_cast<HANDLE>( file ), nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, static_cast<DWORD>( end >> 32 ), static_cast<DWORD>( end ), nullptr );
+        if( handle == nullptr ){
+            throw std::runtime_error( "failed to map file!" );
+        }
+
+        void* data = MapViewOfFile( handle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, static_cast<DWORD>( offset >> 32 ), static_cast<DWORD>( offset ), static_cast<SIZE_T>( size ) );
+        if( data == nullptr ){
+            CloseHandle( handle );
+            throw std::runtime_error( "failed to map file!" );
+        }
+
+        mapping = reinterpret_cast<intptr_t>( handle );
+        return data;
+    }
+
+    // Unmap File
+    void unmap_file( void* data, const uint64_t size, const intptr_t mapping )
+    {
+        UnmapViewOfFile( data );
+        CloseHandle( reinterpret_cast<HANDLE>( mapping ) );
+    }
+
+    // Flush Mapped Memory
+    void flush_file( void* data, const uint64_t size )
+    {
+        FlushViewOfFile( data, static_cast<SIZE_T>( size ) );
+    }
+#else
+    // Open File
+    intptr_t open_file( const std::string& path, const bool writable )
+    {
+        const int32_t file = writable ? open( path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 ) : open( path.c_str(), O_RDONLY );
+        if( file < 0 ){
+            throw std::runtime_error( "failed to open " + path + "!" );
+        }
+        return file;
+    }
+
+    // Close File
+    void close_file( const intptr_t file )
+    {
+        close( static_cast<int32_t>( file ) );
+    }
+
+    // Get File Size
+    uint64_t get_file_size( const intptr_t file )
+    {
+        struct stat status;
+        if( fstat( static_cast<int32_t>( file ), &status ) != 0 ){
+            throw std::runtime_error( "failed to get file size!" );
+        }
+        return static_cast<uint64_t>( status.st_size );
+    }
+
+    // Resize File
+    void resize_file( const intptr_t file, const uint64_t size )
+    {
+        if( ftruncate( static_cast<int32_t>( file ), static_cast<off_t>( size ) ) != 0 ){
+            throw std::runtime_error( "failed to resize file!" );
+        }
+    }
+
+    // Map File
+    void* map_file( const intptr_t file, const uint64_t offset, const uint64_t size, const bool writable, intptr_t& mapping )
+    {
+        void* data = mmap( nullptr, static_cast<size_t>( size ), writable ? ( PROT_READ | PROT_WRITE ) : PROT_READ, MAP_SHARED, static_cast<int32_t>( file ), static_cast<off_t>( offset ) );
+        if( data == MAP_FAILED ){
+            throw std::runtime_error( "failed to map file!" );
+        }
+
+        mapping = -1;
+        return data;
+    }
+
+    // Unmap File
+    void unmap_file( void* data, const uint64_t size, const intptr_t mapping )
+    {
+        munmap( data, static_cast<size_t>( size ) );
+    }
+
+    // Flush Mapped Memory
+    void flush_file( void* data, const uint64_t size )
+    {
+        msync( data, static_cast<size_t>( size ), MS_SYNC );
+    }
+#endif
+}
+
+// Create Layout
+stream_layout stream_layout::create( const uint32_t keypoints, const uint32_t records, const bool positions )
+{
+    if( keypoints == 0 || records == 0 ){
+        throw std::runtime_error( "failed to create stream layout (keypoints and records must be positive)!" );
+    }
+
+    // Each Array is Aligned to Cache Line
+    constexpr uint64_t line = 64;
+    const uint64_t values = static_cast<uint64_t>( records ) * keypoints;
+
+    stream_layout layout;
+    layout.keypoints = keypoints;
+    layout.records = records;
+    layout.positions = positions;
+
+    uint64_t offset = align( sizeof( chunk_header ), line );
+    layout.timestamps = offset;         offset = align( offset + records * sizeof( int64_t ), line );
+    layout.sensor_timestamps = offset;  offset = align( offset + records * sizeof( int64_t ), line );
+    layout.inference_starts = offset;   offset = align( offset + records * sizeof( int64_t ), line );
+    layout.inference_ends = offset;     offset = align( offset + records * sizeof( int64_t ), line );
+    layout.publish_timestamps = offset; offset = align( offset + records * sizeof( int64_t ), line );
+    layout.frames = offset;             offset = align( offset + records * sizeof( uint64_t ), line );
+    layout.ids = offset;                offset = align( offset + records * sizeof( int64_t ), line );
+    layout.x = offset;                  offset = align( offset + values * sizeof( float ), line );
+    layout.y = offset;                  offset = align( offset + values * sizeof( float ), line );
+    layout.confidences = offset;        offset = align( offset + values * sizeof( float ), line );
+    if( positions ){
+        layout.position_x = offset; offset = align( offset + values * sizeof( float ), line );
+        layout.position_y = offset; offset = align( offset + values * sizeof( float ), line );
+        layout.position_z = offset; offset = align( offset + values * sizeof( float ), line );
+        layout.valid = offset;      offset = align( offset + values * sizeof( uint8_t ), line );
+    }
+    layout.size = align( offset, alignment );
+
+    return layout;
+}
+
+// Constructor
+stream_writer::stream_writer( const std::string& path, const uint32_t keypoints, const bool positions, const uint32_t chunk_records, const uint32_t segment_chunks )
+    : path( path ),
+      file( -1 ),
+      layout( stream_layout::create( keypoints, chunk_records, positions ) ),
+      segment_chunks( std::max( segment_chunks, 1u ) ),
+      segment( nullptr ),
+      segment_mapping( -1 ),
+      segment_index( 0 ),
+      chunk( nullptr ),
+      chunk_index( 0 ),
+      count( 0 )
+{
+    // Initialize
+    initialize();
+}
+
+// Destructor
+stream_writer::~stream_writer()
+{
+    // Finalize
+    finalize();
+}
+
+// Initialize
+void stream_writer::initialize()
+{
+    // Create File
+    file = open_file( path, true );
+
+    // Write File Header
+    resize_file( file, stream_layout::alignment );
+    intptr_t mapping;
+    void* data = map_file( file, 0, stream_layout::alignment, true, mapping );
+    file_header header = {};
+    std::memcpy( header.magic, file_magic, sizeof( file_magic ) );
+    header.version = current_version;
+    header.keypoints = layout.keypoints;
+    header.records = layout.records;
+    header.flags = layout.positions ? flag_positions : 0;
+    header.chunk_size = layout.size;
+    header.header_size = stream_layout::alignment;
+    std::memcpy( data, &header, sizeof( header ) );
+    unmap_file( data, stream_layout::alignment, mapping );
+
+    // Map First Segment
+    map_segment( 0 );
+    chunk_index = 0;
+    chunk = segment;
+    *reinterpret_cast<chunk_header*>( chunk ) = chunk_header{ chunk_magic, 0, 0 };
+}
+
+// Finalize
+void stream_writer::finalize()
+{
+    if( file < 0 ){
+        return;
+    }
+
+    // Truncate Preallocated Chunks that are Not Used
+    const uint64_t chunks = chunk_index + ( ( 0 < count ) ? 1 : 0 );
+    unmap_segment();
+    resize_file( file, stream_layout::alignment + chunks * layout.size );
+
+    // Close File
+    close_file( file );
+    file = -1;
+}
+
+// Write Skeletons of Frame
+void stream_writer::write( const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton )
+{
+    const bool deprojected = layout.positions && ( skeleton.size() == keypoints.size() );
+    for( size_t i = 0; i < keypoints.skeletons(); i++ ){
+        if( count == layout.records ){
+            next_chunk();
+        }
+
+        // Record
+        const uint64_t record = count;
+        reinterpret_cast<int64_t*>( chunk + layout.timestamps )[record] = frame.timestamp.count();
+        reinterpret_cast<int64_t*>( chunk + layout.sensor_timestamps )[record] = ( frame.sensor_timestamp.count() != 0 ) ? frame.sensor_timestamp.count() : frame.timestamp.count();
+        reinterpret_cast<int64_t*>( chunk + layout.inference_starts )[record] = frame.inference_start.count();
+        reinterpret_cast<int64_t*>( chunk + layout.inference_ends )[record] = frame.inference_end.count();
+        reinterpret_cast<int64_t*>( chunk + layout.publish_timestamps )[record] = frame.publish_timestamp.count();
+        reinterpret_cast<uint64_t*>( chunk + layout.frames )[record] = frame.index;
+        reinterpret_cast<int64_t*>( chunk + layout.ids )[record] = keypoints.ids[i];
+
+        // Keypoints (Padded if Skeleton has Fewer Keypoints)
+        const size_t begin = keypoints.offsets[i];
+        const size_t size = std::min<size_t>( keypoints.offsets[i + 1] - keypoints.offsets[i], layout.keypoints );
+        const size_t padding = layout.keypoints - size;
+        const uint64_t offset = record * layout.keypoints;
+        float* x = reinterpret_cast<float*>( chunk + layout.x ) + offset;
+        float* y = reinterpret_cast<float*>( chunk + layout.y ) + offset;
+        float* confidences = reinterpret_cast<float*>( chunk + layout.confidences ) + offset;
+        std::copy_n( keypoints.x.data() + begin, size, x );
+        std::copy_n( keypoints.y.data() + begin, size, y );
+        std::copy_n( keypoints.confidences.data() + begin, size, confidences );
+        std::fill_n( x + size, padding, -1.0f );
+        std::fill_n( y + size, padding, -1.0f );
+        std::fill_n( confidences + size, padding, 0.0f );
+
+        // 3D Positions (Invalid if Not Deprojected)
+        if( layout.positions ){
+            float* position_x = reinterpret_cast<float*>( chunk + layout.position_x ) + offset;
+            float* position_y = reinterpret_cast<float*>( chunk + layout.position_y ) + offset;
+            float* position_z = reinterpret_cast<float*>( chunk + layout.position_z ) + offset;
+            uint8_t* valid = reinterpret_cast<uint8_t*>( chunk + layout.valid ) + offset;
+            const size_t copied = deprojected ? size : 0;
+            if( deprojected ){
+                std::copy_n( skeleton.x.data() + begin, size, position_x );
+                std::copy_n( skeleton.y.data() + begin, size, position_y );
+                std::copy_n( skeleton.z.data() + begin, size, position_z );
+                std::copy_n( skeleton.valid.data() + begin, size, valid );
+            }
+            std::fill_n( position_x + copied, layout.keypoints - copied, 0.0f );
+            std::fill_n( position_y + copied, layout.keypoints - copied, 0.0f );
+            std::fill_n( position_z + copied, layout.keypoints - copied, 0.0f );
+            std::fill_n( valid + copied, layout.keypoints - copied, static_cast<uint8_t>( 0 ) );
+        }
+
+        // Commit Record
+        count++;
+        reinterpret_cast<chunk_header*>( chunk )->count = count;
+    }
+}
+
+// Flush
+void stream_writer::flush()
+{
+    if( segment != nullptr ){
+        flush_file( segment, segment_chunks * layout.size );
+    }
+}
+
+// Map Segment
+void stream_writer::map_segment( const uint64_t index )
+{
+    unmap_segment();
+
+    // Extend File by Segment, and Map It
+    const uint64_t segment_size = segment_chunks * layout.size;
+    const uint64_t offset = stream_layout::alignment + index * segment_size;
+    resize_file( file, offset + segment_size );
+    segment = static_cast<uint8_t*>( map_file( file, offset, segment_size, true, segment_mapping ) );
+    segment_index = index;
+}
+
+// Unmap Segment
+void stream_writer::unmap_segment()
+{
+    if( segment == nullptr ){
+        return;
+    }
+
+    unmap_file( segment, segment_chunks * layout.size, segment_mapping );
+    segment = nullptr;
+    segment_mapping = -1;
+}
+
+// Next Chunk
+void stream_writer::next_chunk()
+{
+    // Map Next Segment if Current Segment is Full
+    chunk_index++;
+    if( chunk_index / segment_chunks != segment_index ){
+        map_segment( chunk_index / segment_chunks );
+    }
+
+    chunk = segment + ( chunk_index % segment_chunks ) * layout.size;
+    *reinterpret_cast<chunk_header*>( chunk ) = chunk_header{ chunk_magic, 0, 0 };
+    count = 0;
+}
+
+// Constructor
+stream_reader::stream_reader( const std::string& path )
+    : file( -1 ),
+      mapping( -1 ),
+      data( nullptr ),
+      size( 0 ),
+      version_number( 0 )
+{
+    // Open and Map Whole File
+    file = open_file( path, false );
+    size = get_file_size( file );
+    if( size < sizeof( file_header ) ){
+        close_file( file );
+        throw std::runtime_error( "failed to read " + path + " (not skeleton stream)!" );
+    }
+    data = static_cast<const uint8_t*>( map_file( file, 0, size, false, mapping ) );
+
+    // Validate File Header
+    file_header header;
+    std::memcpy( &header, data, sizeof( header ) );
+    if( std::memcmp( header.magic, file_magic, sizeof( file_magic ) ) != 0 || header.version != current_version ){
+        unmap_file( const_cast<uint8_t*>( data ), size, mapping );
+        close_file( file );
+        throw std::runtime_error( "failed to read " + path + " (not skeleton stream or unsupported version)!" );
+    }
+
+    layout = stream_layout::create( header.keypoints, header.records, ( header.flags & flag_positions ) != 0 );
+    version_number = header.version;
+    if( layout.size != header.chunk_size || header.header_size != stream_layout::alignment || size < header.header_size ){
+        unmap_file( const_cast<uint8_t*>( data ), size, mapping );
+        close_file( file );
+        throw std::runtime_error( "failed to read " + path + " (broken layout)!" );
+    }
+}
+
+// Destructor
+stream_reader::~stream_reader()
+{
+    // Unmap and Close File
+    unmap_file( const_cast<uint8_t*>( data ), size, mapping );
+    close_file( file );
+}
+
+// Version of Format
+uint32_t stream_reader::version() const
+{
+    return version_number;
+}
+
+// Number of Keypoints per Record
+uint32_t stream_reader::keypoints() const
+{
+    return layout.keypoints;
+}
+
+// 3D Positions are Stored
+bool stream_reader::positions() const
+{
+    return layout.positions;
+}
+
+// Number of Chunks
+size_t stream_reader::chunks() const
+{
+    return static_cast<size_t>( ( size - stream_layout::alignment ) / layout.size );
+}
+
+// Get Chunk
+stream_chunk stream_reader::chunk( const size_t index ) const
+{
+    if( chunks() <= index ){
+        throw std::out_of_range( "failed to get chunk (out of range)!" );
+    }
+
+    const uint8_t* base = data + stream_layout::alignment + index * layout.size;
+    const chunk_header& header = *reinterpret_cast<const chunk_header*>( base );
+
+    stream_chunk chunk;
+    chunk.count = ( header.magic == chunk_magic ) ? std::min( header.count, layout.records ) : 0;
+    chunk.timestamps = reinterpret_cast<const int64_t*>( base + layout.timestamps );
+    chunk.sensor_timestamps = reinterpret_cast<const int64_t*>( base + layout.sensor_timestamps );
+    chunk.inference_starts = reinterpret_cast<const int64_t*>( base + layout.inference_starts );
+    chunk.inference_ends = reinterpret_cast<const int64_t*>( base + layout.inference_ends );
+    chunk.publish_timestamps = reinterpret_cast<const int64_t*>( base + layout.publish_timestamps );
+    chunk.frames = reinterpret_cast<const uint64_t*>( base + layout.frames );
+    chunk.ids = reinterpret_cast<const int64_t*>( base + layout.ids );
+    chunk.x = reinterpret_cast<const float*>( base + layout.x );
+    chunk.y = reinterpret_cast<const float*>( base + layout.y );
+    chunk.confidences = reinterpret_cast<const float*>( base + layout.confidences );
+    if( layout.positions ){
+        chunk.position_x = reinterpret_cast<const float*>( base + layout.position_x );
+        chunk.position_y = reinterpret_cast<const float*>( base + layout.position_y );
+        chunk.position_z = reinterpret_cast<const float*>( base + layout.position_z );
+        chunk.valid = base + layout.valid;
+    }
+
+    return chunk;
+}
+
+// Number of Records
+uint64_t stream_reader::records() const
+{
+    uint64_t records = 0;
+    for( size_t i = 0; i < chunks(); i++ ){
+        records += chunk( i ).count;
+    }
+    return records;
+}
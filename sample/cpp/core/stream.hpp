@@ -0,0 +1,188 @@
+#ifndef __STREAM__
+#define __STREAM__
+
+#include <string>
+#include <cstdint>
+
+#include "sink.hpp"
+#include "source.hpp"
+#include "skeleton.hpp"
+
+/*
+ This is compact binary skeleton stream (version 2) with memory-mapped writer and reader.
+
+ Each record is one skeleton of one frame (sensor, arrival, inference start/end and publish timestamps,
+ frame index, tracking id, 2D keypoints, confidences and optional 3D positions) with fixed number of keypoints.
+ Timestamps are on host steady clock, so age of each result is publish - sensor timestamp.
+ Records are stored in fixed-size chunks, and each field is stored in SoA layout per chunk.
+ Writer appends records into preallocated memory-mapped segments,
+ so logging allocates nothing and formats nothing per frame.
+ Reader maps whole file, and returns pointers into mapped memory without copy.
+
+ [file header (aligned)][chunk 0][chunk 1]...
+ chunk: [chunk header][timestamps][sensor timestamps][inference starts][inference ends][publish timestamps][frames][ids][x][y][confidences]([position x][position y][position z][valid])
+
+ stream_writer writer( "skeleton.skel" );
+ writer.write( frame, keypoints, skeleton );
+
+ stream_reader reader( "skeleton.skel" );
+ for( size_t i = 0; i < reader.chunks(); i++ ){
+     const stream_chunk chunk = reader.chunk( i );
+     float x = chunk.x[record * reader.keypoints() + keypoint];
+ }
+
+ NOTE: Byte order is native (little endian on supported platforms).
+*/
+
+// Layout of Stream
+struct stream_layout
+{
+    uint32_t keypoints = 0;     // number of keypoints per record
+    uint32_t records = 0;       // number of records per chunk
+    bool positions = false;     // 3D positions are stored
+
+    // Offsets in Chunk [byte]
+    uint64_t timestamps = 0;
+    uint64_t sensor_timestamps = 0;
+    uint64_t inference_starts = 0;
+    uint64_t inference_ends = 0;
+    uint64_t publish_timestamps = 0;
+    uint64_t frames = 0;
+    uint64_t ids = 0;
+    uint64_t x = 0;
+    uint64_t y = 0;
+    uint64_t confidences = 0;
+    uint64_t position_x = 0;
+    uint64_t position_y = 0;
+    uint64_t position_z = 0;
+    uint64_t valid = 0;
+
+    // Size of Chunk [byte] (Multiple of Alignment)
+    uint64_t size = 0;
+
+    // Alignment of File Header and Chunks (Allocation Granularity of Memory Mapping)
+    static constexpr uint64_t alignment = 65536;
+
+    // Create Layout
+    static stream_layout create( const uint32_t keypoints, const uint32_t records, const bool positions );
+};
+
+// Chunk (View of Mapped Memory)
+struct stream_chunk
+{
+    uint32_t count = 0;                          // number of records in chunk
+    const int64_t* timestamps = nullptr;         // arrival [ns] (steady clock)
+    const int64_t* sensor_timestamps = nullptr;  // sensor time mapped to host [ns] (steady clock, arrival if source has no sensor clock)
+    const int64_t* inference_starts = nullptr;   // [ns] (steady clock, 0 if frame is not inferred)
+    const int64_t* inference_ends = nullptr;     // [ns] (steady clock, 0 if frame is not inferred)
+    const int64_t* publish_timestamps = nullptr; // [ns] (steady clock)
+    const uint64_t* frames = nullptr;            // frame index
+    const int64_t* ids = nullptr;                // tracking id
+    const float* x = nullptr;                    // [records * keypoints] [pixel]
+    const float* y = nullptr;
+    const float* confidences = nullptr;
+    const float* position_x = nullptr;           // [records * keypoints] [m] (nullptr if positions are not stored)
+    const float* position_y = nullptr;
+    const float* position_z = nullptr;
+    const uint8_t* valid = nullptr;
+};
+
+// Writer of Skeleton Stream (Append Only)
+class stream_writer : public sink
+{
+private:
+    // File
+    std::string path;
+    intptr_t file;
+
+    // Layout
+    stream_layout layout;
+    uint32_t segment_chunks;
+
+    // Mapped Segment
+    uint8_t* segment;
+    intptr_t segment_mapping;
+    uint64_t segment_index;
+
+    // Current Chunk
+    uint8_t* chunk;
+    uint64_t chunk_index; // index of chunk in file
+    uint32_t count;
+
+public:
+    // Constructor
+    stream_writer( const std::string& path, const uint32_t keypoints = 18, const bool positions = true, const uint32_t chunk_records = 256, const uint32_t segment_chunks = 16 );
+
+    // Destructor
+    ~stream_writer();
+
+    stream_writer( const stream_writer& ) = delete;
+    stream_writer& operator=( const stream_writer& ) = delete;
+
+    // Write Skeletons of Frame
+    void write( const frame& frame, const skeleton2d& keypoints, const skeleton3d& skeleton ) override;
+
+    // Flush (Write Mapped Memory Back to File)
+    void flush() override;
+
+private:
+    // Initialize
+    void initialize();
+
+    // Finalize
+    void finalize();
+
+    // Map Segment
+    void map_segment( const uint64_t index );
+
+    // Unmap Segment
+    void unmap_segment();
+
+    // Next Chunk
+    void next_chunk();
+};
+
+// Reader of Skeleton Stream (Zero Copy)
+class stream_reader
+{
+private:
+    // File
+    intptr_t file;
+    intptr_t mapping;
+    const uint8_t* data;
+    uint64_t size;
+
+    // Layout
+    stream_layout layout;
+    uint32_t version_number;
+
+public:
+    // Constructor
+    stream_reader( const std::string& path );
+
+    // Destructor
+    ~stream_reader();
+
+    stream_reader( const stream_reader& ) = delete;
+    stream_reader& operator=( const stream_reader& ) = delete;
+
+    // Version of Format
+    uint32_t version() const;
+
+    // Number of Keypoints per Record
+    uint32_t keypoints() const;
+
+    // 3D Positions are Stored
+    bool positions() const;
+
+    // Number of Chunks
+    size_t chunks() const;
+
+    // Get Chunk
+    stream_chunk chunk( const size_t index ) const;
+
+    // Number of Records
+    uint64_t records() const;
+};
+
+#endif // __STREAM__
@@ -0,0 +1,416 @@
+#include "tracker.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    // Falloff of Each Joint (Sigmas of COCO Keypoints in Order of 18 Keypoints, Neck is Same as Shoulder)
+    constexpr float sigmas[] = { 0.026f, 0.079f, 0.079f, 0.072f, 0.062f, 0.079f, 0.072f, 0.062f, 0.107f, 0.087f, 0.089f, 0.107f, 0.087f, 0.089f, 0.025f, 0.025f, 0.035f, 0.035f };
+
+    // Weight of Previous Velocity in Smoothed Velocity
+    constexpr float velocity_smoothing = 0.5f;
+
+    // Decay of Velocity of Coasting Track (Lost Person doesn't Fly Away)
+    constexpr float velocity_decay = 0.8f;
+
+    // Min Scale of Track (Area of Small Person doesn't Make Similarity Too Strict)
+    constexpr float min_scale = 32.0f * 32.0f;
+
+    // Gate of Association (Pairs with Centers Farther than Ratio of Size are Dissimilar without Computing OKS)
+    constexpr float gate = 2.0f;
+
+    // Check Joint is Detected (Missing Joint has Negative Position)
+    bool is_valid( const CM_SKEL_KeypointsBuffer& skeleton, const int32_t joint )
+    {
+        return 0.0f < skeleton.confidences[joint] && 0.0f <= skeleton.keypoints_coord_x[joint] && 0.0f <= skeleton.keypoints_coord_y[joint];
+    }
+}
+
+// Constructor
+skeleton_tracker::skeleton_tracker( const tracking_method method, const size_t capacity, const float min_similarity, const uint32_t max_missed )
+    : method( method ),
+      capacity( capacity ),
+      min_similarity( min_similarity ),
+      max_missed( max_missed ),
+      next_id( 0 )
+{
+    if( method == tracking_method::backend ){
+        throw std::runtime_error( "failed to create skeleton tracker (backend tracking is done by backend)!" );
+    }
+    if( capacity == 0 ){
+        throw std::runtime_error( "failed to create skeleton tracker (capacity is 0)!" );
+    }
+
+    // Allocate Tracks
+    x.resize( capacity * joints );
+    y.resize( capacity * joints );
+    vx.resize( capacity * joints );
+    vy.resize( capacity * joints );
+    confidences.resize( capacity * joints );
+    scales.resize( capacity );
+    centers_x.resize( capacity );
+    centers_y.resize( capacity );
+    ids.resize( capacity, -1 );
+    ages.resize( capacity );
+    missed.resize( capacity );
+    active.resize( capacity );
+    tracks.reserve( capacity );
+
+    // Reserve Association Buffers (Number of Detections Rarely Exceeds Capacity)
+    similarities.reserve( capacity * capacity );
+    matches.reserve( capacity );
+    matched.resize( capacity );
+    costs.reserve( capacity * capacity );
+    u.reserve( capacity + 1 );
+    v.reserve( capacity + 1 );
+    minimums.reserve( capacity + 1 );
+    assignment.reserve( capacity + 1 );
+    way.reserve( capacity + 1 );
+    used.reserve( capacity + 1 );
+    pairs.reserve( capacity * capacity );
+}
+
+// Update Tracking ID of Skeletons in Buffer
+void skeleton_tracker::update( CM_SKEL_Buffer* buffer )
+{
+    if( buffer == nullptr ){
+        return;
+    }
+
+    // Predict Tracks
+    predict();
+
+    // Associate Detections with Tracks
+    const size_t detections = static_cast<size_t>( std::max( buffer->numSkeletons, 0 ) );
+    matches.assign( detections, -1 );
+    if( 0 < detections && !tracks.empty() ){
+        compute_similarities( buffer );
+        if( method == tracking_method::hungarian ){
+            associate_hungarian( detections );
+        }
+        else{
+            associate_greedy( detections );
+        }
+    }
+
+    // Update Tracks
+    update_tracks( buffer );
+}
+
+// Reset All Tracks
+void skeleton_tracker::reset()
+{
+    std::fill( active.begin(), active.end(), 0 );
+    std::fill( ids.begin(), ids.end(), -1 );
+    tracks.clear();
+}
+
+// Number of Active Tracks
+size_t skeleton_tracker::size() const
+{
+    return tracks.size();
+}
+
+// Predict Tracks with Constant Velocity
+inline void skeleton_tracker::predict()
+{
+    for( const size_t track : tracks ){
+        float sum_x = 0.0f, sum_y = 0.0f, count = 0.0f;
+        for( size_t joint = track * joints; joint < ( track + 1 ) * joints; joint++ ){
+            x[joint] += vx[joint];
+            y[joint] += vy[joint];
+            if( 0.0f < confidences[joint] ){
+                sum_x += x[joint];
+                sum_y += y[joint];
+                count += 1.0f;
+            }
+        }
+
+        // Center of Predicted Joints
+        centers_x[track] = ( 0.0f < count ) ? sum_x / count : 0.0f;
+        centers_y[track] = ( 0.0f < count ) ? sum_y / count : 0.0f;
+    }
+}
+
+// Compute Similarity of Each Detection and Each Track
+inline void skeleton_tracker::compute_similarities( const CM_SKEL_Buffer* buffer )
+{
+    const size_t count = tracks.size();
+    similarities.assign( static_cast<size_t>( buffer->numSkeletons ) * count, 0.0f );
+
+    for( int32_t detection = 0; detection < buffer->numSkeletons; detection++ ){
+        const CM_SKEL_KeypointsBuffer& skeleton = buffer->skeletons[detection];
+        const int32_t size = std::min( skeleton.numKeyPoints, static_cast<int32_t>( joints ) );
+
+        // Center of Detected Joints
+        float center_x = 0.0f, center_y = 0.0f, valid = 0.0f;
+        for( int32_t joint = 0; joint < size; joint++ ){
+            if( is_valid( skeleton, joint ) ){
+                center_x += skeleton.keypoints_coord_x[joint];
+                center_y += skeleton.keypoints_coord_y[joint];
+                valid += 1.0f;
+            }
+        }
+        if( valid <= 0.0f ){
+            continue;
+        }
+        center_x /= valid;
+        center_y /= valid;
+
+        for( size_t k = 0; k < count; k++ ){
+            // Gate by Distance of Centers (Size of Person is Square Root of Scale)
+            const float distance_x = center_x - centers_x[tracks[k]];
+            const float distance_y = center_y - centers_y[tracks[k]];
+            if( gate * gate * scales[tracks[k]] < distance_x * distance_x + distance_y * distance_y ){
+                continue;
+            }
+
+            // Confidence-Weighted OKS (exp( -d^2 / ( 2 * s^2 * k^2 ) ), k = 2 * sigma)
+            const size_t offset = tracks[k] * joints;
+            float weights = 0.0f, sum = 0.0f;
+            for( int32_t joint = 0; joint < size; joint++ ){
+                const size_t index = offset + static_cast<size_t>( joint );
+                if( !is_valid( skeleton, joint ) || confidences[index] <= 0.0f ){
+                    continue;
+                }
+
+                const float dx = skeleton.keypoints_coord_x[joint] - x[index];
+                const float dy = skeleton.keypoints_coord_y[joint] - y[index];
+                const float kappa = 2.0f * sigmas[joint];
+                const float weight = std::min( skeleton.confidences[joint], confidences[index] );
+                sum += weight * std::exp( -( dx * dx + dy * dy ) / ( 2.0f * scales[tracks[k]] * kappa * kappa ) );
+                weights += weight;
+            }
+
+            similarities[static_cast<size_t>( detection ) * count + k] = ( 0.0f < weights ) ? sum / weights : 0.0f;
+        }
+    }
+}
+
+// Associate Detections with Tracks by Hungarian Algorithm
+inline void skeleton_tracker::associate_hungarian( const size_t detections )
+{
+    // Square Cost Matrix (Rows are Detections, Columns are Tracks, Dummy and Dissimilar Pairs Cost 1)
+    const size_t count = tracks.size();
+    const size_t n = std::max( detections, count );
+    costs.assign( n * n, 1.0f );
+    for( size_t detection = 0; detection < detections; detection++ ){
+        for( size_t k = 0; k < count; k++ ){
+            const float similarity = similarities[detection * count + k];
+            if( min_similarity <= similarity ){
+                costs[detection * n + k] = 1.0f - similarity;
+            }
+        }
+    }
+
+    // Minimum Cost Assignment with Potentials (O(n^3), 1-based Indices, assignment[column] is Row)
+    const float infinity = std::numeric_limits<float>::max();
+    u.assign( n + 1, 0.0f );
+    v.assign( n + 1, 0.0f );
+    assignment.assign( n + 1, 0 );
+    way.assign( n + 1, 0 );
+    for( size_t row = 1; row <= n; row++ ){
+        assignment[0] = static_cast<int32_t>( row );
+        size_t column = 0;
+        minimums.assign( n + 1, infinity );
+        used.assign( n + 1, 0 );
+        do{
+            used[column] = 1;
+            const size_t current = static_cast<size_t>( assignment[column] );
+            float delta = infinity;
+            size_t next = 0;
+            for( size_t j = 1; j <= n; j++ ){
+                if( used[j] ){
+                    continue;
+                }
+
+                const float cost = costs[( current - 1 ) * n + ( j - 1 )] - u[current] - v[j];
+                if( cost < minimums[j] ){
+                    minimums[j] = cost;
+                    way[j] = static_cast<int32_t>( column );
+                }
+                if( minimums[j] < delta ){
+                    delta = minimums[j];
+                    next = j;
+                }
+            }
+
+            for( size_t j = 0; j <= n; j++ ){
+                if( used[j] ){
+                    u[static_cast<size_t>( assignment[j] )] += delta;
+                    v[j] -= delta;
+                }
+                else{
+                    minimums[j] -= delta;
+                }
+            }
+            column = next;
+        } while( assignment[column] != 0 );
+
+        // Augment Path
+        do{
+            const size_t previous = static_cast<size_t>( way[column] );
+            assignment[column] = assignment[previous];
+            column = previous;
+        } while( column != 0 );
+    }
+
+    // Matches of Real Pairs with Enough Similarity
+    for( size_t k = 0; k < count; k++ ){
+        const size_t detection = static_cast<size_t>( assignment[k + 1] - 1 );
+        if( detection < detections && min_similarity <= similarities[detection * count + k] ){
+            matches[detection] = static_cast<int32_t>( k );
+        }
+    }
+}
+
+// Associate Detections with Tracks by Greedy Matching
+inline void skeleton_tracker::associate_greedy( const size_t detections )
+{
+    // Candidate Pairs with Enough Similarity
+    const size_t count = tracks.size();
+    pairs.clear();
+    for( size_t detection = 0; detection < detections; detection++ ){
+        for( size_t k = 0; k < count; k++ ){
+            const float similarity = similarities[detection * count + k];
+            if( min_similarity <= similarity ){
+                pairs.push_back( { similarity, static_cast<int32_t>( detection ), static_cast<int32_t>( k ) } );
+            }
+        }
+    }
+
+    // Highest Similarity First
+    std::sort( pairs.begin(), pairs.end(), []( const pair& a, const pair& b ){ return a.similarity > b.similarity; } );
+    used.assign( count, 0 );
+    for( const pair& pair : pairs ){
+        if( matches[pair.detection] < 0 && !used[pair.track] ){
+            matches[pair.detection] = pair.track;
+            used[pair.track] = 1;
+        }
+    }
+}
+
+// Update Matched Tracks, Create New Tracks, and Remove Lost Tracks
+inline void skeleton_tracker::update_tracks( CM_SKEL_Buffer* buffer )
+{
+    // Update Matched Tracks
+    std::fill( matched.begin(), matched.end(), 0 );
+    for( int32_t detection = 0; detection < buffer->numSkeletons; detection++ ){
+        const int32_t k = matches[detection];
+        if( k < 0 ){
+            continue;
+        }
+
+        const size_t track = tracks[k];
+        assign( track, buffer->skeletons[detection], false );
+        matched[track] = 1;
+        buffer->skeletons[detection].id = ids[track];
+    }
+
+    // Coast Unmatched Tracks, and Remove Tracks that are Lost Too Long
+    for( const size_t track : tracks ){
+        if( matched[track] ){
+            continue;
+        }
+
+        if( max_missed < ++missed[track] ){
+            active[track] = 0;
+            ids[track] = -1;
+            continue;
+        }
+        for( size_t joint = track * joints; joint < ( track + 1 ) * joints; joint++ ){
+            vx[joint] *= velocity_decay;
+            vy[joint] *= velocity_decay;
+        }
+    }
+
+    // Create New Tracks of Unmatched Detections (No ID if Capacity is Exhausted)
+    size_t free = 0;
+    for( int32_t detection = 0; detection < buffer->numSkeletons; detection++ ){
+        CM_SKEL_KeypointsBuffer& skeleton = buffer->skeletons[detection];
+        if( 0 <= matches[detection] ){
+            continue;
+        }
+
+        skeleton.id = -1;
+        while( free < capacity && ( active[free] || matched[free] ) ){
+            free++;
+        }
+        if( free == capacity ){
+            continue;
+        }
+
+        bool detected = false;
+        for( int32_t joint = 0; joint < skeleton.numKeyPoints && !detected; joint++ ){
+            detected = is_valid( skeleton, joint );
+        }
+        if( !detected ){
+            continue;
+        }
+
+        assign( free, skeleton, true );
+        active[free] = 1;
+        ids[free] = next_id++;
+        skeleton.id = ids[free];
+        free++;
+    }
+
+    // Active Tracks
+    tracks.clear();
+    for( size_t track = 0; track < capacity; track++ ){
+        if( active[track] ){
+            tracks.push_back( track );
+        }
+    }
+}
+
+// Assign Skeleton to Track
+inline void skeleton_tracker::assign( const size_t track, const CM_SKEL_KeypointsBuffer& skeleton, const bool initialize )
+{
+    float left = std::numeric_limits<float>::max(), top = left, right = -left, bottom = -left;
+    for( int32_t joint = 0; joint < static_cast<int32_t>( joints ); joint++ ){
+        const size_t index = track * joints + static_cast<size_t>( joint );
+
+        // Missing Joint Keeps Predicted Position with Halved Confidence
+        if( skeleton.numKeyPoints <= joint || !is_valid( skeleton, joint ) ){
+            if( initialize ){
+                x[index] = y[index] = -1.0f;
+                vx[index] = vy[index] = 0.0f;
+                confidences[index] = 0.0f;
+            }
+            else{
+                confidences[index] *= 0.5f;
+            }
+            continue;
+        }
+
+        // Smoothed Velocity (Predicted Position minus Velocity is Previous Position)
+        const float position_x = skeleton.keypoints_coord_x[joint];
+        const float position_y = skeleton.keypoints_coord_y[joint];
+        if( initialize || confidences[index] <= 0.0f ){
+            vx[index] = vy[index] = 0.0f;
+        }
+        else{
+            vx[index] = velocity_smoothing * vx[index] + ( 1.0f - velocity_smoothing ) * ( position_x - ( x[index] - vx[index] ) );
+            vy[index] = velocity_smoothing * vy[index] + ( 1.0f - velocity_smoothing ) * ( position_y - ( y[index] - vy[index] ) );
+        }
+        x[index] = position_x;
+        y[index] = position_y;
+        confidences[index] = skeleton.confidences[joint];
+
+        left = std::min( left, position_x );
+        top = std::min( top, position_y );
+        right = std::max( right, position_x );
+        bottom = std::max( bottom, position_y );
+    }
+
+    // Scale is Area of Bounding Box of Detected Joints
+    if( left <= right ){
+        scales[track] = std::max( ( right - left ) * ( bottom - top ), min_scale );
+    }
+    ages[track] = initialize ? 1 : ages[track] + 1;
+    missed[track] = 0;
+}
@@ -0,0 +1,102 @@
+#ifndef __TRACKER__
+#define __TRACKER__
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <cubemos/skeleton_tracking.h>
+
+/*
+ This is native multi-person tracker that assigns tracking id to skeletons of inference result.
+
+ Each track keeps position, velocity and confidence of each joint, age and number of missed results.
+ Skeletons of result are associated with tracks predicted by constant velocity,
+ by Hungarian algorithm (optimal) or greedy matching (fastest) on similarity of keypoints.
+ Similarity is confidence-weighted OKS (object keypoint similarity) that is normalized by scale of track,
+ so distance tolerance grows with size of person.
+ Unmatched tracks coast with constant velocity through short occlusions, and are removed after max missed results.
+ Unmatched skeletons start new tracks. Track state lives in preallocated arrays (no allocation per result).
+
+ skeleton_tracker tracker( tracking_method::hungarian );
+ tracker.update( buffer ); // id of each skeleton is updated in place
+*/
+
+// Tracking Method
+enum class tracking_method
+{
+    hungarian, // native tracker with optimal assignment
+    greedy,    // native tracker with greedy assignment (highest similarity first)
+    backend    // cm_skel_update_tracking_id of backend (previous result only)
+};
+
+class skeleton_tracker
+{
+private:
+    tracking_method method;
+    size_t capacity;      // max number of tracks
+    float min_similarity; // min OKS of association
+    uint32_t max_missed;  // results that track coasts before removal
+    int32_t next_id;
+
+    // Tracks (Joints of Track i are [i * joints, (i + 1) * joints))
+    static constexpr size_t joints = 18;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> confidences;
+    std::vector<float> scales;   // area of bounding box
+    std::vector<float> centers_x; // center of joints (gate of association)
+    std::vector<float> centers_y;
+    std::vector<int32_t> ids;
+    std::vector<uint32_t> ages;  // matched results
+    std::vector<uint32_t> missed;
+    std::vector<uint8_t> active;
+    std::vector<size_t> tracks;  // indices of active tracks
+
+    // Association (Recycled Buffers)
+    std::vector<float> similarities; // detections x tracks
+    std::vector<int32_t> matches;    // track of each detection (-1 means new)
+    std::vector<uint8_t> matched;    // track is matched
+    std::vector<float> costs;        // square cost matrix of Hungarian algorithm
+    std::vector<float> u, v, minimums;
+    std::vector<int32_t> assignment, way;
+    std::vector<uint8_t> used;
+    struct pair{ float similarity; int32_t detection; int32_t track; };
+    std::vector<pair> pairs;
+
+public:
+    // Constructor
+    skeleton_tracker( const tracking_method method = tracking_method::hungarian, const size_t capacity = 64, const float min_similarity = 0.2f, const uint32_t max_missed = 10 );
+
+    // Update Tracking ID of Skeletons in Buffer
+    void update( CM_SKEL_Buffer* buffer );
+
+    // Reset All Tracks
+    void reset();
+
+    // Number of Active Tracks (Including Coasting Tracks)
+    size_t size() const;
+
+private:
+    // Predict Tracks with Constant Velocity
+    void predict();
+
+    // Compute Similarity of Each Detection and Each Track
+    void compute_similarities( const CM_SKEL_Buffer* buffer );
+
+    // Associate Detections with Tracks by Hungarian Algorithm
+    void associate_hungarian( const size_t detections );
+
+    // Associate Detections with Tracks by Greedy Matching
+    void associate_greedy( const size_t detections );
+
+    // Update Matched Tracks, Create New Tracks, and Remove Lost Tracks
+    void update_tracks( CM_SKEL_Buffer* buffer );
+
+    // Assign Skeleton to Track
+    void assign( const size_t track, const CM_SKEL_KeypointsBuffer& skeleton, const bool initialize );
+};
+
+#endif // __TRACKER__
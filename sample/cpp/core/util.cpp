@@ -0,0 +1,33 @@
+#include "util.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+namespace filesystem = std::filesystem;
+
+CUBEMOS_SKEL_Buffer_Ptr create_skel_buffer( backend& backend )
+{
+    return CUBEMOS_SKEL_Buffer_Ptr( new CM_SKEL_Buffer(), [&backend]( CM_SKEL_Buffer* pb ){ backend.release_buffer( pb ); delete pb; } );
+}
+
+namespace
+{
+    // Get Cubemos Directory ( %LOCALAPPDATA%/Cubemos/SkeletonTracking )
+    filesystem::path get_cubemos_directory()
+    {
+        const char* local_app_data = std::getenv( "LOCALAPPDATA" );
+        return filesystem::path( std::string( local_app_data != nullptr ? local_app_data : "" ) + "/Cubemos/SkeletonTracking" );
+    }
+}
+
+std::string get_license_directory()
+{
+    const filesystem::path license_directory( get_cubemos_directory().generic_string() + "/license" );
+    return license_directory.generic_string();
+}
+
+std::string get_model_file( const bool fp16 )
+{
+    const filesystem::path model_directory( get_cubemos_directory().generic_string() + "/models" );
+    const filesystem::path model( model_directory.generic_string() + ( fp16 ? "/fp16/skeleton-tracking.cubemos" : "/fp32/skeleton-tracking.cubemos" ) );
+    return model.generic_string();
+}
@@ -5,9 +5,12 @@
 #include <sstream>
 #include <string>
 #include <memory>
+#include <functional>
 
 #include <cubemos/skeleton_tracking.h>
 
+#include "backend.hpp"
+
 #define MULTIPLE 16
 
 #define CHECK_SUCCESS( ret )                                                \
@@ -17,7 +20,14 @@
         throw std::runtime_error( ss.str().c_str() );                       \
     }
 
-using CUBEMOS_SKEL_Buffer_Ptr = std::unique_ptr<CM_SKEL_Buffer, void ( * )( CM_SKEL_Buffer* )>;
-CUBEMOS_SKEL_Buffer_Ptr create_skel_buffer();
+// Buffer is released by backend that filled it
+using CUBEMOS_SKEL_Buffer_Ptr = std::unique_ptr<CM_SKEL_Buffer, std::function<void( CM_SKEL_Buffer* )>>;
+CUBEMOS_SKEL_Buffer_Ptr create_skel_buffer( backend& backend );
+
+// Get License Directory ( %LOCALAPPDATA%/Cubemos/SkeletonTracking/license )
+std::string get_license_directory();
+
+// Get Model File ( %LOCALAPPDATA%/Cubemos/SkeletonTracking/models/fp32/skeleton-tracking.cubemos )
+std::string get_model_file( const bool fp16 = false );
 
-#endif // __UTIL__
\ No newline at end of file
+#endif // __UTIL__
@@ -1,13 +1,44 @@
 #include <iostream>
 #include <sstream>
+#include <vector>
+#include <memory>
 
 #include "realsense.hpp"
+#include "engine.hpp"
+#include "orchestrator.hpp"
+#include "option.hpp"
+#include "interrupt.hpp"
 
 int main( int argc, char* argv[] )
 {
     try{
-        realsense realsense;
-        realsense.run();
+        const options options = parse_options( argc, argv );
+        install_interrupt_handler();
+
+        // Open Devices (or Recorded Files)
+        const std::vector<std::string> inputs = get_inputs( options );
+        const size_t count = inputs.empty() ? options.devices : inputs.size();
+        std::vector<std::unique_ptr<realsense>> realsenses;
+        std::vector<source*> sources;
+        for( size_t i = 0; i < count; i++ ){
+            if( inputs.empty() ){
+                realsenses.push_back( std::make_unique<realsense>( static_cast<uint32_t>( i ), options.depth_window ) );
+            }
+            else{
+                realsenses.push_back( std::make_unique<realsense>( inputs[i], options.depth_window, is_realtime( options ) ) );
+            }
+            sources.push_back( realsenses.back().get() );
+        }
+
+        // Run Skeleton Tracking (Several Devices Share One Model)
+        if( sources.size() == 1 ){
+            engine engine( create_backend( options ), options.depth, options.inference_size );
+            run( engine, *sources.front(), options );
+        }
+        else{
+            orchestrator orchestrator( create_backend( options ), options.depth, options.inference_size );
+            run( orchestrator, sources, options );
+        }
     }
     catch( const rs2::error& error ){
         std::cout << error.what() << std::endl;
@@ -19,4 +50,4 @@ int main( int argc, char* argv[] )
     }
 
     return 0;
-}
\ No newline at end of file
+}
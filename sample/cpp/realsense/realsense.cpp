@@ -1,18 +1,25 @@
 #include "realsense.hpp"
+#include "profiler.hpp"
 
 #include <array>
-#include <chrono>
-#include <vector>
-#include <string>
-#include <filesystem>
-namespace filesystem = std::filesystem;
+#include <stdexcept>
 
 // Constructor
-realsense::realsense()
-    : handle( nullptr ),
-      request_handle( nullptr),
-      buffer( create_skel_buffer() ),
-      previous_buffer( create_skel_buffer() )
+realsense::realsense( const uint32_t index, const int32_t depth_window )
+    : device_index( index ),
+      realtime( true ),
+      depth_window( depth_window )
+{
+    // Initialize
+    initialize();
+}
+
+// Constructor
+realsense::realsense( const std::string& file, const int32_t depth_window, const bool realtime )
+    : device_index( 0 ),
+      file( file ),
+      realtime( realtime ),
+      depth_window( depth_window )
 {
     // Initialize
     initialize();
@@ -25,26 +32,88 @@ realsense::~realsense()
     finalize();
 }
 
-// Processing
-void realsense::run()
+// Read Frame
+bool realsense::read( frame& frame )
 {
-    // Main Loop
-    while( true ){
-        // Update Data
-        update();
+    // Update Frame
+    {
+        scoped_timer timer( stage::acquire );
+        if( !update_frame() ){
+            return false;
+        }
+    }
 
-        // Draw Data
-        draw();
+    // Stamp Arrival (Sensor Timestamp is Mapped to Steady Clock by Engine or Orchestrator)
+    frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() );
 
-        // Show Data
-        show();
+    // Update Color
+    update_color();
 
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
-        if( key == 'q' ){
-            break;
-        }
+    // Update Depth
+    {
+        scoped_timer timer( stage::depth );
+        update_depth();
+    }
+
+    // Keep Color and Depth Frame with Color Image
+    std::shared_ptr<realsense_context> context = std::make_shared<realsense_context>();
+    context->color_frame = color_frame;
+    context->depth_frame = depth_frame;
+    {
+        scoped_timer timer( stage::conversion );
+        frame.color = retrieve_color( *context );
     }
+    frame.context = context;
+
+    // Timestamp of Color Frame [ms] (Hardware Clock, or Global Time that is Host-Synchronized Hardware Clock)
+    frame.device_timestamp = color_frame ? std::chrono::nanoseconds( static_cast<int64_t>( color_frame.get_timestamp() * 1000000.0 ) ) : std::chrono::nanoseconds( 0 );
+
+    return true;
+}
+
+// Deproject 2D Keypoints to 3D Positions in Batch
+bool realsense::deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const
+{
+    const std::shared_ptr<realsense_context> context = std::static_pointer_cast<realsense_context>( frame.context );
+    if( !context || !context->depth_frame ){
+        return false;
+    }
+
+    // Map Keypoints to Depth Frame (Color and Depth are Not Aligned)
+    const rs2::depth_frame depth_frame = context->depth_frame.as<rs2::depth_frame>();
+    map_keypoints( depth_frame, keypoints );
+
+    // Sample Depth from Z16 Buffer with Depth Scale
+    const cv::Mat depth( depth_frame.get_height(), depth_frame.get_width(), CV_16UC1, const_cast<void*>( depth_frame.get_data() ), depth_frame.get_stride_in_bytes() );
+    skeleton.reset( keypoints );
+    sample_depth( depth, depth_scale, depth_keypoints, depth_window, skeleton );
+
+    // Deproject All Keypoints with Depth Intrinsics (Depth Stream has No Distortion)
+    compute_rays( depth_intrinsics.fx, depth_intrinsics.fy, depth_intrinsics.ppx, depth_intrinsics.ppy, depth_keypoints, skeleton );
+    deproject_skeleton( skeleton );
+
+    // Transform into Color Camera (Extrinsics of RealSense is Column-Major)
+    const float* r = depth_to_color.rotation;
+    const float rotation[9] = { r[0], r[3], r[6], r[1], r[4], r[7], r[2], r[5], r[8] };
+    transform_skeleton( rotation, depth_to_color.translation, skeleton );
+
+    return true;
+}
+
+// Name
+std::string realsense::name() const
+{
+    if( !file.empty() ){
+        return "skeleton (" + file + ")";
+    }
+
+    return cv::format( "skeleton (realsense %d)", device_index );
+}
+
+// Number of Buffer Allocations
+uint64_t realsense::allocations() const
+{
+    return pool.allocations();
 }
 
 // Initialize
@@ -54,91 +123,66 @@ void realsense::initialize()
 
     // Initialize Sensor
     initialize_sensor();
-
-    // Initialize Skeleton
-    initialize_skeleton();
 }
 
 // Initialize Sensor
 inline void realsense::initialize_sensor()
 {
-    // Set Device Config
+    // Set Device Config (Recorded File has Fixed Streams)
     rs2::config config;
-    config.enable_stream( rs2_stream::RS2_STREAM_COLOR, color_width, color_height, rs2_format::RS2_FORMAT_BGR8, color_fps );
-    config.enable_stream( rs2_stream::RS2_STREAM_DEPTH, depth_width, depth_height, rs2_format::RS2_FORMAT_Z16, depth_fps );
+    if( file.empty() ){
+        // Select Device by Index (Serial Number is Unique among Connected Devices)
+        const rs2::device_list devices = rs2::context().query_devices();
+        if( devices.size() <= device_index ){
+            throw std::runtime_error( "failed to found device " + std::to_string( device_index ) + "!" );
+        }
+        config.enable_device( devices[device_index].get_info( rs2_camera_info::RS2_CAMERA_INFO_SERIAL_NUMBER ) );
+
+        config.enable_stream( rs2_stream::RS2_STREAM_COLOR, color_width, color_height, rs2_format::RS2_FORMAT_BGR8, color_fps );
+        config.enable_stream( rs2_stream::RS2_STREAM_DEPTH, depth_width, depth_height, rs2_format::RS2_FORMAT_Z16, depth_fps );
+    }
+    else{
+        config.enable_device_from_file( file, false );
+    }
 
     // Start Pipeline
     pipeline_profile = pipeline.start( config );
 
-    // Get Intrinsics
-    intrinsics = pipeline_profile.get_stream( rs2_stream::RS2_STREAM_DEPTH ).as<rs2::video_stream_profile>().get_intrinsics();
-}
+    // Set Playback Timing (Non-Realtime Playback Never Drops Frames and Runs as Fast as Engine Reads)
+    if( !file.empty() ){
+        pipeline_profile.get_device().as<rs2::playback>().set_real_time( realtime );
+    }
 
-// Initialize Skeleton
-void realsense::initialize_skeleton()
-{
-    // Create Handle
-    const filesystem::path license_directory( std::string( std::getenv( "LOCALAPPDATA" ) ) + "/Cubemos/SkeletonTracking/license" );
-    CHECK_SUCCESS( cm_skel_create_handle( &handle, license_directory.generic_string().c_str() ) );
-
-    // Load Model
-    const CM_TargetComputeDevice target_device = CM_TargetComputeDevice::CM_CPU;
-    const filesystem::path model_directory( std::string( std::getenv( "LOCALAPPDATA" ) ) + "/Cubemos/SkeletonTracking/models" );
-    const filesystem::path model( model_directory.generic_string() + "/fp32/skeleton-tracking.cubemos" ); // FP32 model
-    //const filesystem::path model( model_directory.generic_string() + "/fp16/skeleton-tracking.cubemos" ); // FP16 model
-    CHECK_SUCCESS( cm_skel_load_model( handle, target_device, model.generic_string().c_str() ) );
-
-    // Create Async Request Handle
-    CHECK_SUCCESS( cm_skel_create_async_request_handle( handle, &request_handle ) );
-
-    // Create Color Table
-    colors.push_back( cv::Scalar( 255,   0,   0 ) );
-    colors.push_back( cv::Scalar(   0, 255,   0 ) );
-    colors.push_back( cv::Scalar(   0,   0, 255 ) );
-    colors.push_back( cv::Scalar( 255, 255,   0 ) );
-    colors.push_back( cv::Scalar(   0, 255, 255 ) );
-    colors.push_back( cv::Scalar( 255,   0, 255 ) );
+    // Get Intrinsics and Extrinsics
+    const rs2::video_stream_profile color_profile = pipeline_profile.get_stream( rs2_stream::RS2_STREAM_COLOR ).as<rs2::video_stream_profile>();
+    const rs2::video_stream_profile depth_profile = pipeline_profile.get_stream( rs2_stream::RS2_STREAM_DEPTH ).as<rs2::video_stream_profile>();
+    color_intrinsics = color_profile.get_intrinsics();
+    depth_intrinsics = depth_profile.get_intrinsics();
+    color_to_depth = color_profile.get_extrinsics_to( depth_profile );
+    depth_to_color = depth_profile.get_extrinsics_to( color_profile );
+
+    // Get Depth Scale
+    depth_scale = pipeline_profile.get_device().first<rs2::depth_sensor>().get_depth_scale();
 }
 
 // Finalize
 void realsense::finalize()
 {
-    // Dstroy Handle and Window
-    if( handle != nullptr){
-        cm_skel_destroy_handle( &handle );
-    }
-    if( request_handle != nullptr){
-        cm_skel_destroy_async_request_handle( &request_handle );
-    }
-
     // Stop Pipline
     pipeline.stop();
-
-    // Close Windows
-    cv::destroyAllWindows();
-}
-
-// Update Data
-void realsense::update()
-{
-    // Update Frame
-    update_frame();
-
-    // Update Color
-    update_color();
-
-    // Update Depth
-    update_depth();
-
-    // Update Skeleton
-    update_skeleton();
 }
 
 // Update Frame
-inline void realsense::update_frame()
+inline bool realsense::update_frame()
 {
     // Update Frame
-    frameset = pipeline.wait_for_frames();
+    if( file.empty() ){
+        frameset = pipeline.wait_for_frames();
+        return true;
+    }
+
+    // Update Frame (Playback Stops at End of File)
+    return pipeline.try_wait_for_frames( &frameset );
 }
 
 // Update Color
@@ -154,7 +198,7 @@ inline void realsense::update_color()
 }
 
 // Update Depth
-void realsense::update_depth()
+inline void realsense::update_depth()
 {
     // Retrieve Depth Frame
     depth_frame = frameset.get_depth_frame();
@@ -164,132 +208,60 @@ void realsense::update_depth()
     depth_height = depth_frame.as<rs2::video_frame>().get_height();
 }
 
-// Update Skeleton
-void realsense::update_skeleton()
-{
-    // Get Image
-    cv::Mat frame;
-    switch( color_frame.get_profile().format() ){
-        case rs2_format::RS2_FORMAT_BGR8:
-            frame = cv::Mat( color_height, color_width, CV_8UC3, const_cast<void*>( color_frame.get_data() ) ).clone();
-            break;
-        case rs2_format::RS2_FORMAT_RGBA8:
-            frame = cv::Mat( color_height, color_width, CV_8UC4, const_cast<void*>( color_frame.get_data() ) ).clone();
-            cv::cvtColor( frame, frame, cv::COLOR_BGRA2BGR );
-            break;
-        default:
-            throw std::runtime_error( "this format not support!" );
-            break;
-    }
-
-    // Create Image
-    CM_Image image = CM_Image{
-        reinterpret_cast<void*>( frame.data ),
-        CM_Datatype::CM_UINT8,
-        frame.cols,
-        frame.rows,
-        frame.channels(),
-        static_cast<int32_t>( frame.step[0] ),
-        CM_MemoryOrder::CM_HWC
-    };
-
-    // Async Inference
-    constexpr int32_t size = MULTIPLE * 12; // 16 * n
-    CHECK_SUCCESS( cm_skel_estimate_keypoints_start_async( handle, request_handle, &image, size ) );
-}
-
-// Draw Data
-void realsense::draw()
+// Map Keypoints from Color Frame to Depth Frame
+inline void realsense::map_keypoints( const rs2::depth_frame& depth_frame, const skeleton2d& keypoints ) const
 {
-    // Draw Color
-    draw_color();
+    // Search Corresponding Depth Pixel on Epipolar Line within Depth Range
+    constexpr float depth_min = 0.1f; // [m]
+    constexpr float depth_max = 10.0f; // [m]
+    const uint16_t* data = reinterpret_cast<const uint16_t*>( depth_frame.get_data() );
+
+    // (Keypoints that are out of color frame or failed to map are skipped by bounds check)
+    const size_t size = keypoints.size();
+    depth_keypoints.x.resize( size );
+    depth_keypoints.y.resize( size );
+    for( size_t i = 0; i < size; i++ ){
+        depth_keypoints.x[i] = -1.0f;
+        depth_keypoints.y[i] = -1.0f;
+        if( keypoints.x[i] < 0.0f || color_intrinsics.width <= keypoints.x[i] || keypoints.y[i] < 0.0f || color_intrinsics.height <= keypoints.y[i] ){
+            continue;
+        }
 
-    // Draw Skeleton
-    draw_skeleton();
+        std::array<float, 2> depth_pixel = { -1.0f, -1.0f };
+        const std::array<float, 2> color_pixel = { keypoints.x[i], keypoints.y[i] };
+        rs2_project_color_pixel_to_depth_pixel( &depth_pixel[0], data, depth_scale, depth_min, depth_max, &depth_intrinsics, &color_intrinsics, &color_to_depth, &depth_to_color, &color_pixel[0] );
+        depth_keypoints.x[i] = depth_pixel[0];
+        depth_keypoints.y[i] = depth_pixel[1];
+    }
 }
 
-// Draw Color
-inline void realsense::draw_color()
+// Retrieve Color Image
+inline cv::Mat realsense::retrieve_color( realsense_context& context )
 {
-    // Create cv::Mat form Color Frame
+    // Get Image
+    cv::Mat frame;
     switch( color_frame.get_profile().format() ){
         case rs2_format::RS2_FORMAT_BGR8:
-            color = cv::Mat( color_height, color_width, CV_8UC3, const_cast<void*>( color_frame.get_data() ) );
+            // Wrap Color Frame without Copy (Color Frame is Kept Alive by Context)
+            frame = cv::Mat( color_height, color_width, CV_8UC3, const_cast<void*>( color_frame.get_data() ), color_stride );
+            break;
+        case rs2_format::RS2_FORMAT_RGB8:
+            // Convert Color Frame into Recycled Buffer (Recorded Files are often RGB8)
+            context.color_buffer = pool.acquire( cv::Size( color_width, color_height ), CV_8UC3 );
+            cv::cvtColor( cv::Mat( color_height, color_width, CV_8UC3, const_cast<void*>( color_frame.get_data() ), color_stride ), *context.color_buffer, cv::COLOR_RGB2BGR );
+            frame = *context.color_buffer;
             break;
         case rs2_format::RS2_FORMAT_RGBA8:
-            color = cv::Mat( color_height, color_width, CV_8UC4, const_cast<void*>( color_frame.get_data() ) );
+            // Convert Color Frame into Recycled Buffer in Single Pass
+            context.color_buffer = pool.acquire( cv::Size( color_width, color_height ), CV_8UC3 );
+            cv::cvtColor( cv::Mat( color_height, color_width, CV_8UC4, const_cast<void*>( color_frame.get_data() ), color_stride ), *context.color_buffer, cv::COLOR_RGBA2BGR );
+            frame = *context.color_buffer;
             break;
         default:
             throw std::runtime_error( "this format not support!" );
             break;
     }
-}
 
-// Draw Skeleton
-inline void realsense::draw_skeleton()
-{
-    if( color.empty() ){
-        return;
-    }
-
-    // Get Inference Result
-    const std::chrono::milliseconds timeout( 1000 );
-    const CM_ReturnCode result = cm_skel_wait_for_keypoints( handle, request_handle, buffer.get(), timeout.count() );
-
-    // Draw Skeleton
-    if( result == CM_ReturnCode::CM_SUCCESS ){
-        // Update Tracking ID
-        CHECK_SUCCESS( cm_skel_update_tracking_id( handle, previous_buffer.get(), buffer.get() ) );
-
-        // Draw Skeleton
-        for( int32_t i = 0; i < buffer->numSkeletons; i++ ){
-            const CM_SKEL_KeypointsBuffer& skeleton = buffer->skeletons[i];
-            for( int32_t j = 0; j < skeleton.numKeyPoints; j++ ){
-                constexpr float threshold = 0.5f;
-                if( skeleton.confidences[j] < threshold ){
-                    continue;
-                }
-
-                // Draw Joint
-                constexpr int32_t radius = 5;
-                const cv::Point point = cv::Point( skeleton.keypoints_coord_x[j], skeleton.keypoints_coord_y[j] );
-                const cv::Scalar color = colors[skeleton.id % colors.size()];
-                cv::circle( this->color, point, radius, colors[skeleton.id % colors.size()], -1, cv::LineTypes::LINE_AA );
-
-                // Get 3D Position
-                std::array<float, 3> point_3d;
-                const std::array<float, 2> point_2d = { point.x, point.y };
-                const float distance = depth_frame.as<rs2::depth_frame>().get_distance( point.x, point.y );
-                rs2_deproject_pixel_to_point( &point_3d[0], &intrinsics, &point_2d[0], distance );
-
-                // Draw 3D Position
-                constexpr int32_t offcet = 20;
-                constexpr double scale = 0.5;
-                const std::string label = cv::format( "( %8.2f, %8.2f, %8.2f )", point_3d[0], point_3d[1], point_3d[2] );
-                cv::putText( this->color, label, cv::Point( point.x - offcet, point.y - offcet ), cv::FONT_HERSHEY_COMPLEX, scale, color );
-            }
-        }
-
-        // Swap and Release Previous Buffer
-        previous_buffer.swap( buffer );
-        cm_skel_release_buffer( buffer.get() );
-    }
+    return frame;
 }
 
-// Show Data
-void realsense::show()
-{
-    // Show Skeleton
-    show_skeleton();
-}
-
-// Show Color
-inline void realsense::show_skeleton()
-{
-    if( color.empty() ){
-        return;
-    }
-
-    // Show Skeleton Image
-    cv::imshow( "skeleton", color );
-}
\ No newline at end of file
@@ -1,16 +1,25 @@
 #ifndef __REALSENSE__
 #define __REALSENSE__
 
-#include <vector>
+#include <string>
+#include <memory>
 
 #include <opencv2/opencv.hpp>
 #include <librealsense2/rs.hpp>
 #include <librealsense2/rsutil.h>
-#include <cubemos/skeleton_tracking.h>
 
-#include "util.hpp"
+#include "source.hpp"
+#include "pool.hpp"
 
-class realsense
+// Frame Context (Keep RealSense Frames Alive until Result is Retrieved)
+struct realsense_context
+{
+    rs2::frame color_frame;
+    rs2::frame depth_frame;
+    std::shared_ptr<cv::Mat> color_buffer; // converted color image (RGB8 and RGBA8 only)
+};
+
+class realsense : public source
 {
 private:
     // RealSense
@@ -18,48 +27,55 @@ private:
     rs2::pipeline_profile pipeline_profile;
     rs2::frameset frameset;
 
+    // Device Index (or Playback, Empty File means Live Device)
+    uint32_t device_index;
+    std::string file;
+    bool realtime;
+
     // Color
     rs2::frame color_frame;
-    cv::Mat color;
     int32_t color_width  = 1280;
     int32_t color_height = 720;
     int32_t color_fps = 30;
     int32_t color_stride;
+    frame_pool pool; // recycled buffers for converted color image
 
     // Depth
     rs2::frame depth_frame;
-    rs2_intrinsics intrinsics;
     int32_t depth_width = 1280;
     int32_t depth_height = 720;
     int32_t depth_fps = 30;
+    float depth_scale; // [unit] -> [m]
+    int32_t depth_window; // window size of median filter for depth at keypoints
 
-    // Cubemos
-    CM_SKEL_Handle* handle;
-    CM_SKEL_AsyncRequestHandle* request_handle;
-    CUBEMOS_SKEL_Buffer_Ptr buffer;
-    CUBEMOS_SKEL_Buffer_Ptr previous_buffer;
-
-    // Visualize
-    std::vector<cv::Scalar> colors;
+    // Calibration
+    rs2_intrinsics color_intrinsics;
+    rs2_intrinsics depth_intrinsics;
+    rs2_extrinsics color_to_depth;
+    rs2_extrinsics depth_to_color;
+    mutable skeleton2d depth_keypoints; // keypoints mapped to depth frame
 
 public:
-    // Constructor
-    realsense();
+    // Constructor (Live Device)
+    realsense( const uint32_t index = 0, const int32_t depth_window = 3 );
+
+    // Constructor (Recorded File *.bag, realtime = false means max throughput)
+    realsense( const std::string& file, const int32_t depth_window = 3, const bool realtime = true );
 
     // Destructor
     ~realsense();
 
-    // Processing
-    void run();
+    // Read Frame
+    bool read( frame& frame ) override;
 
-    // Update Data
-    void update();
+    // Deproject 2D Keypoints to 3D Positions in Batch
+    bool deproject( const frame& frame, const skeleton2d& keypoints, skeleton3d& skeleton ) const override;
 
-    // Draw Data
-    void draw();
+    // Name
+    std::string name() const override;
 
-    // Show Data
-    void show();
+    // Number of Buffer Allocations
+    uint64_t allocations() const;
 
 private:
     // Initialize
@@ -68,14 +84,11 @@ private:
     // Initialize Sensor
     void initialize_sensor();
 
-    // Initialize Skeleton
-    void initialize_skeleton();
-
     // Finalize
     void finalize();
 
-    // Update Frame
-    void update_frame();
+    // Update Frame (Return false at End of File)
+    bool update_frame();
 
     // Update Color
     void update_color();
@@ -83,17 +96,11 @@ private:
     // Update Depth
     void update_depth();
 
-    // Update Skeleton
-    void update_skeleton();
-
-    // Draw Color
-    void draw_color();
-
-    // Draw Skeleton
-    void draw_skeleton();
+    // Map Keypoints from Color Frame to Depth Frame
+    void map_keypoints( const rs2::depth_frame& depth_frame, const skeleton2d& keypoints ) const;
 
-    // Show Skelton
-    void show_skeleton();
+    // Retrieve Color Image
+    cv::Mat retrieve_color( realsense_context& context );
 };
 
-#endif // __REALSENSE__
\ No newline at end of file
+#endif // __REALSENSE__